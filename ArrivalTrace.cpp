@@ -0,0 +1,222 @@
+/**
+ * @description Job arrival traces, for replaying recorded arrivals
+ *   through a job scheduling simulation.
+ */
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ArrivalTrace.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** arrival trace constructor
+ * Open and memory map the trace file.  Files that start with the job
+ * trace magic number are read as binary traces, all others as csv.
+ *
+ * @param fileName The name of the trace file.
+ */
+ArrivalTrace::ArrivalTrace(string fileName)
+{
+  binaryTrace = NULL;
+  csvMapping = NULL;
+  csvEnd = NULL;
+  csvSize = 0;
+
+  int descriptor = open(fileName.c_str(), O_RDONLY);
+  if (descriptor < 0)
+  {
+    throw JobTraceException("could not open " + fileName);
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0)
+  {
+    ::close(descriptor);
+    throw JobTraceException("could not read " + fileName);
+  }
+
+  char magic[sizeof(jobTraceMagic)];
+  bool binary = status.st_size >= (off_t)sizeof(magic)
+    && pread(descriptor, magic, sizeof(magic), 0) == (ssize_t)sizeof(magic)
+    && memcmp(magic, jobTraceMagic, sizeof(magic)) == 0;
+
+  if (binary)
+  {
+    ::close(descriptor);
+    binaryTrace = new JobTraceReader(fileName);
+  }
+  else if (status.st_size > 0)
+  {
+    csvSize = status.st_size;
+    void* memory = mmap(NULL, csvSize, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (memory == MAP_FAILED)
+    {
+      throw JobTraceException("could not map " + fileName);
+    }
+    // the file is read once from start to end
+    madvise(memory, csvSize, MADV_SEQUENTIAL);
+    csvMapping = static_cast<const char*>(memory);
+    csvEnd = csvMapping + csvSize;
+  }
+  else
+  {
+    ::close(descriptor);
+  }
+
+  rewind();
+}
+
+
+/** arrival trace destructor
+ * Unmap the trace file.
+ */
+ArrivalTrace::~ArrivalTrace()
+{
+  delete binaryTrace;
+  if (csvMapping != NULL)
+  {
+    munmap(const_cast<char*>(csvMapping), csvSize);
+  }
+}
+
+
+/** rewind
+ * Go back to before the first arrival, so the next call to next() reads
+ * the first arrival.  A csv header line is skipped.
+ */
+void ArrivalTrace::rewind()
+{
+  block = 0;
+  blockIndex = 0;
+  numArrivals = 0;
+  arrivalTime = 0;
+  arrivalPriority = 0;
+  arrivalServiceTime = 0;
+  cursor = csvMapping;
+  lineNumber = 1;
+
+  if (cursor != NULL && cursor < csvEnd
+      && !(*cursor >= '0' && *cursor <= '9') && *cursor != '-')
+  {
+    const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', csvEnd - cursor));
+    cursor = (lineEnd == NULL) ? csvEnd : lineEnd + 1;
+    lineNumber++;
+  }
+}
+
+
+/** next binary
+ * Read the next arrival of a binary trace.
+ *
+ * @returns bool false at the end of the trace.
+ */
+bool ArrivalTrace::nextBinary()
+{
+  while (block < binaryTrace->numBlocks() && blockIndex >= binaryTrace->blockLength(block))
+  {
+    block++;
+    blockIndex = 0;
+  }
+  if (block >= binaryTrace->numBlocks())
+  {
+    return false;
+  }
+
+  arrivalTime = binaryTrace->startTimes(block)[blockIndex];
+  arrivalPriority = binaryTrace->priorities(block)[blockIndex];
+  arrivalServiceTime = binaryTrace->serviceTimes(block)[blockIndex];
+  blockIndex++;
+  return true;
+}
+
+
+/** parse csv field
+ * Parse one integer field at the cursor, and move the cursor past the
+ * comma that ends it (or past the end of the line for the last field).
+ *
+ * @param lastField True for the last field of a line.
+ *
+ * @returns long long The value of the field.
+ */
+long long ArrivalTrace::parseCsvField(bool lastField)
+{
+  while (cursor < csvEnd && (*cursor == ' ' || *cursor == '\t'))
+  {
+    cursor++;
+  }
+  bool negative = (cursor < csvEnd && *cursor == '-');
+  if (negative)
+  {
+    cursor++;
+  }
+
+  const char* digits = cursor;
+  long long value = 0;
+  while (cursor < csvEnd && *cursor >= '0' && *cursor <= '9')
+  {
+    value = value * 10 + (*cursor - '0');
+    cursor++;
+  }
+  while (cursor < csvEnd && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r'))
+  {
+    cursor++;
+  }
+
+  bool ended = lastField
+    ? (cursor == csvEnd || *cursor == '\n')
+    : (cursor < csvEnd && *cursor == ',');
+  if (cursor == digits || !ended)
+  {
+    ostringstream message;
+    message << "line " << lineNumber << " is not time,priority,serviceTime";
+    throw JobTraceException(message.str());
+  }
+  if (cursor < csvEnd)
+  {
+    cursor++;
+  }
+  return negative ? -value : value;
+}
+
+
+/** next csv
+ * Read the next arrival of a csv trace, skipping blank lines.
+ *
+ * @returns bool false at the end of the trace.
+ */
+bool ArrivalTrace::nextCsv()
+{
+  while (cursor < csvEnd && (*cursor == '\n' || *cursor == '\r'))
+  {
+    if (*cursor == '\n')
+    {
+      lineNumber++;
+    }
+    cursor++;
+  }
+  if (cursor >= csvEnd)
+  {
+    return false;
+  }
+
+  arrivalTime = parseCsvField(false);
+  arrivalPriority = parseCsvField(false);
+  arrivalServiceTime = parseCsvField(true);
+  lineNumber++;
+  return true;
+}
+
+
+/** arrival trace length
+ * @returns long long The number of arrivals read since the last rewind().
+ */
+long long ArrivalTrace::length() const
+{
+  return numArrivals;
+}
@@ -0,0 +1,120 @@
+/**
+ * @description Job arrival traces, for replaying recorded arrivals
+ *   through a job scheduling simulation.
+ */
+#include <cstddef>
+#include <string>
+#include "JobTrace.hpp"
+using namespace std;
+#ifndef ARRIVALTRACE_HPP
+#define ARRIVALTRACE_HPP
+
+
+//-------------------------------------------------------------------------
+/** ArrivalTrace
+ * A recorded sequence of job arrivals, each with an arrival time, a
+ * priority and a service time, read one arrival at a time.  The trace
+ * file is memory mapped, so arrivals are read straight from the file as
+ * the simulation reaches them, and traces much larger than memory can be
+ * replayed.  Two formats are read:
+ *
+ *   csv: one arrival per line, "time,priority,serviceTime".  A first line
+ *     that is not a number (a header) and blank lines are skipped.
+ *   binary: a job trace file (see JobTraceWriter), using the startTime,
+ *     priority and serviceTime columns.  A trace recorded by a single
+ *     server first come first served simulation is in arrival order.
+ *
+ * Arrivals must be in order of arrival time.
+ *
+ * @var binaryTrace The binary trace, NULL for a csv trace.
+ * @var block The current block of the binary trace.
+ * @var blockIndex The index of the next arrival in the block.
+ * @var csvMapping The start of the mapped csv file, NULL for a binary
+ *   trace.
+ * @var csvEnd The end of the mapped csv file.
+ * @var cursor The start of the next line of the csv file.
+ * @var lineNumber The line number of the cursor, for error messages.
+ * @var arrivalTime The time of the current arrival.
+ * @var arrivalPriority The priority of the current arrival.
+ * @var arrivalServiceTime The service time of the current arrival.
+ * @var numArrivals The number of arrivals read since the last rewind().
+ */
+class ArrivalTrace
+{
+private:
+  JobTraceReader* binaryTrace;
+  int block;
+  int blockIndex;
+  const char* csvMapping;
+  const char* csvEnd;
+  size_t csvSize;
+  const char* cursor;
+  long long lineNumber;
+  long long arrivalTime;
+  int arrivalPriority;
+  int arrivalServiceTime;
+  long long numArrivals;
+
+  bool nextBinary();
+  bool nextCsv();
+  long long parseCsvField(bool lastField);
+
+  // traces own their mapping, they can not be copied
+  ArrivalTrace(const ArrivalTrace&);
+  ArrivalTrace& operator=(const ArrivalTrace&);
+
+public:
+  ArrivalTrace(string fileName); // constructor
+  ~ArrivalTrace(); // destructor
+  void rewind();
+
+  /** next
+   * Move on to the next arrival of the trace.
+   *
+   * @returns bool true if there is a next arrival, false at the end of
+   *   the trace.
+   */
+  bool next()
+  {
+    bool found = (binaryTrace != NULL) ? nextBinary() : nextCsv();
+    if (found)
+    {
+      numArrivals++;
+    }
+    return found;
+  }
+
+  /** time
+   * @returns long long The arrival time of the current arrival.
+   */
+  long long time() const
+  {
+    return arrivalTime;
+  }
+
+  /** priority
+   * @returns int The priority of the current arrival.
+   */
+  int priority() const
+  {
+    return arrivalPriority;
+  }
+
+  /** service time
+   * @returns int The service time of the current arrival.
+   */
+  int serviceTime() const
+  {
+    return arrivalServiceTime;
+  }
+
+  long long length() const;
+};
+
+
+
+
+// include the implementation of the arrival traces
+#include "ArrivalTrace.cpp"
+
+#endif
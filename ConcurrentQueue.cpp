@@ -0,0 +1,461 @@
+/**
+ * @description Bounded queues that can be shared by threads: a lock free
+ *   multi-producer/multi-consumer ring buffer, the concurrent counterpart
+ *   of AQueue, and a mutex protected AQueue to compare it against.
+ */
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include "ConcurrentQueue.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** concurrent queue constructor
+ * Allocate the ring buffer.  Each cell starts with the sequence number
+ * of its position, which marks it as ready for the producer of that
+ * position.
+ *
+ * @param minCapacity The least number of items the queue must hold, it
+ *   is rounded up to a power of two.
+ */
+template <class T>
+ConcurrentAQueue<T>::ConcurrentAQueue(int minCapacity)
+{
+  size_t capacity = 2;
+  while (capacity < (size_t)minCapacity)
+  {
+    capacity *= 2;
+  }
+  mask = capacity - 1;
+  cells = new Cell[capacity];
+  for (size_t position = 0; position < capacity; position++)
+  {
+    cells[position].sequence.store(position, memory_order_relaxed);
+  }
+  enqueueIndex.store(0, memory_order_relaxed);
+  dequeueIndex.store(0, memory_order_relaxed);
+}
+
+
+/** concurrent queue destructor
+ * Free the ring buffer.  No other thread may be using the queue.
+ */
+template <class T>
+ConcurrentAQueue<T>::~ConcurrentAQueue()
+{
+  delete [] cells;
+}
+
+
+/** concurrent queue enqueue
+ * Add a copy of the item onto the back of the queue, unless it is full.
+ *
+ * @param newItem The item to add on the back of the queue.
+ *
+ * @returns bool true if the item was added, false if the queue was full.
+ */
+template <class T>
+bool ConcurrentAQueue<T>::tryEnqueue(const T& newItem)
+{
+  T item(newItem);
+  return tryEnqueue(std::move(item));
+}
+
+
+/** concurrent queue enqueue (move)
+ * Move the item onto the back of the queue, unless it is full.  A cell
+ * is ready for the producer of position p when its sequence is p, the
+ * producer claims the position by advancing the enqueue index, and
+ * hands the cell to the consumer by setting its sequence to p + 1.
+ *
+ * @param newItem The item to move on the back of the queue.
+ *
+ * @returns bool true if the item was added, false if the queue was full.
+ */
+template <class T>
+bool ConcurrentAQueue<T>::tryEnqueue(T&& newItem)
+{
+  size_t position = enqueueIndex.load(memory_order_relaxed);
+  Cell* cell;
+
+  while (true)
+  {
+    cell = &cells[position & mask];
+    size_t sequence = cell->sequence.load(memory_order_acquire);
+    ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+
+    if (difference == 0)
+    {
+      if (enqueueIndex.compare_exchange_weak(position, position + 1,
+					     memory_order_relaxed))
+      {
+	break;
+      }
+    }
+    else if (difference < 0)
+    {
+      // the cell still holds the item from one lap ago, queue is full
+      return false;
+    }
+    else
+    {
+      // another producer took this position, try the next one
+      position = enqueueIndex.load(memory_order_relaxed);
+    }
+  }
+
+  cell->item = std::move(newItem);
+  cell->sequence.store(position + 1, memory_order_release);
+  return true;
+}
+
+
+/** concurrent queue dequeue
+ * Remove the item from the front of the queue, unless it is empty.  A
+ * cell is ready for the consumer of position p when its sequence is
+ * p + 1, the consumer hands the cell back to the producer of the next
+ * lap by setting its sequence to p + capacity.
+ *
+ * @param item Returns the item removed from the queue.
+ *
+ * @returns bool true if an item was removed, false if the queue was empty.
+ */
+template <class T>
+bool ConcurrentAQueue<T>::tryDequeue(T& item)
+{
+  size_t position = dequeueIndex.load(memory_order_relaxed);
+  Cell* cell;
+
+  while (true)
+  {
+    cell = &cells[position & mask];
+    size_t sequence = cell->sequence.load(memory_order_acquire);
+    ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)(position + 1);
+
+    if (difference == 0)
+    {
+      if (dequeueIndex.compare_exchange_weak(position, position + 1,
+					     memory_order_relaxed))
+      {
+	break;
+      }
+    }
+    else if (difference < 0)
+    {
+      // the cell has not been filled yet, queue is empty
+      return false;
+    }
+    else
+    {
+      position = dequeueIndex.load(memory_order_relaxed);
+    }
+  }
+
+  item = std::move(cell->item);
+  cell->sequence.store(position + mask + 1, memory_order_release);
+  return true;
+}
+
+
+/** concurrent queue enqueue batch
+ * Add copies of up to count items onto the back of the queue.  The run
+ * of cells that are ready for the producer is claimed with a single
+ * compare and swap, cells seen to be ready stay ready until claimed.
+ *
+ * @param newItems The items to add, in order.
+ * @param count The number of items.
+ *
+ * @returns int The number of items added (from the start of newItems),
+ *   less than count if the queue filled up, 0 if count is 0 or less.
+ */
+template <class T>
+int ConcurrentAQueue<T>::tryEnqueueBatch(const T* newItems, int count)
+{
+  // nothing to claim, the loop below would wait for a cell forever
+  if (count <= 0)
+  {
+    return 0;
+  }
+
+  size_t position = enqueueIndex.load(memory_order_relaxed);
+  int numClaimed;
+
+  while (true)
+  {
+    numClaimed = 0;
+    while (numClaimed < count)
+    {
+      size_t sequence = cells[(position + numClaimed) & mask].sequence.load(memory_order_acquire);
+      if (sequence != position + numClaimed)
+      {
+	break;
+      }
+      numClaimed++;
+    }
+
+    if (numClaimed == 0)
+    {
+      size_t sequence = cells[position & mask].sequence.load(memory_order_acquire);
+      if ((ptrdiff_t)sequence - (ptrdiff_t)position < 0)
+      {
+	return 0;
+      }
+      position = enqueueIndex.load(memory_order_relaxed);
+    }
+    else if (enqueueIndex.compare_exchange_weak(position, position + numClaimed,
+						memory_order_relaxed))
+    {
+      break;
+    }
+  }
+
+  for (int index = 0; index < numClaimed; index++)
+  {
+    Cell& cell = cells[(position + index) & mask];
+    cell.item = newItems[index];
+    cell.sequence.store(position + index + 1, memory_order_release);
+  }
+  return numClaimed;
+}
+
+
+/** concurrent queue dequeue batch
+ * Remove up to count items from the front of the queue, claiming the
+ * run of filled cells with a single compare and swap.
+ *
+ * @param items Returns the items removed, in order.
+ * @param count The most items to remove.
+ *
+ * @returns int The number of items removed, less than count if the
+ *   queue emptied, 0 if count is 0 or less.
+ */
+template <class T>
+int ConcurrentAQueue<T>::tryDequeueBatch(T* items, int count)
+{
+  // nothing to claim, the loop below would wait for a cell forever
+  if (count <= 0)
+  {
+    return 0;
+  }
+
+  size_t position = dequeueIndex.load(memory_order_relaxed);
+  int numClaimed;
+
+  while (true)
+  {
+    numClaimed = 0;
+    while (numClaimed < count)
+    {
+      size_t sequence = cells[(position + numClaimed) & mask].sequence.load(memory_order_acquire);
+      if (sequence != position + numClaimed + 1)
+      {
+	break;
+      }
+      numClaimed++;
+    }
+
+    if (numClaimed == 0)
+    {
+      size_t sequence = cells[position & mask].sequence.load(memory_order_acquire);
+      if ((ptrdiff_t)sequence - (ptrdiff_t)(position + 1) < 0)
+      {
+	return 0;
+      }
+      position = dequeueIndex.load(memory_order_relaxed);
+    }
+    else if (dequeueIndex.compare_exchange_weak(position, position + numClaimed,
+						memory_order_relaxed))
+    {
+      break;
+    }
+  }
+
+  for (int index = 0; index < numClaimed; index++)
+  {
+    Cell& cell = cells[(position + index) & mask];
+    items[index] = std::move(cell.item);
+    cell.sequence.store(position + index + mask + 1, memory_order_release);
+  }
+  return numClaimed;
+}
+
+
+/** concurrent queue is empty
+ * @returns bool true if the queue was empty when checked.
+ */
+template <class T>
+bool ConcurrentAQueue<T>::isEmpty() const
+{
+  return length() == 0;
+}
+
+
+/** concurrent queue length
+ * The number of items on the queue, only approximate while other
+ * threads are using the queue.
+ *
+ * @returns int The (approximate) length of the queue.
+ */
+template <class T>
+int ConcurrentAQueue<T>::length() const
+{
+  size_t dequeuePosition = dequeueIndex.load(memory_order_acquire);
+  size_t enqueuePosition = enqueueIndex.load(memory_order_acquire);
+  ptrdiff_t length = (ptrdiff_t)enqueuePosition - (ptrdiff_t)dequeuePosition;
+  return (length > 0) ? length : 0;
+}
+
+
+/** concurrent queue capacity
+ * @returns int The most items the queue can hold.
+ */
+template <class T>
+int ConcurrentAQueue<T>::capacity() const
+{
+  return mask + 1;
+}
+
+
+
+//-------------------------------------------------------------------------
+/** locked queue constructor
+ *
+ * @param capacity The most items the queue can hold.
+ */
+template <class T>
+LockedAQueue<T>::LockedAQueue(int capacity)
+  : items(capacity)
+{
+  maxLength = capacity;
+}
+
+
+/** locked queue enqueue
+ * @param newItem The item to add on the back of the queue.
+ *
+ * @returns bool true if the item was added, false if the queue was full.
+ */
+template <class T>
+bool LockedAQueue<T>::tryEnqueue(const T& newItem)
+{
+  lock_guard<mutex> guard(lock);
+  if (items.length() >= maxLength)
+  {
+    return false;
+  }
+  items.enqueue(newItem);
+  return true;
+}
+
+
+/** locked queue enqueue (move)
+ * @param newItem The item to move on the back of the queue.
+ *
+ * @returns bool true if the item was added, false if the queue was full.
+ */
+template <class T>
+bool LockedAQueue<T>::tryEnqueue(T&& newItem)
+{
+  lock_guard<mutex> guard(lock);
+  if (items.length() >= maxLength)
+  {
+    return false;
+  }
+  items.enqueue(std::move(newItem));
+  return true;
+}
+
+
+/** locked queue dequeue
+ * @param item Returns the item removed from the queue.
+ *
+ * @returns bool true if an item was removed, false if the queue was empty.
+ */
+template <class T>
+bool LockedAQueue<T>::tryDequeue(T& item)
+{
+  lock_guard<mutex> guard(lock);
+  if (items.isEmpty())
+  {
+    return false;
+  }
+  item = items.front();
+  items.dequeue();
+  return true;
+}
+
+
+/** locked queue enqueue batch
+ * @param newItems The items to add, in order.
+ * @param count The number of items.
+ *
+ * @returns int The number of items added.
+ */
+template <class T>
+int LockedAQueue<T>::tryEnqueueBatch(const T* newItems, int count)
+{
+  lock_guard<mutex> guard(lock);
+  int numAdded = 0;
+  while (numAdded < count && items.length() < maxLength)
+  {
+    items.enqueue(newItems[numAdded]);
+    numAdded++;
+  }
+  return numAdded;
+}
+
+
+/** locked queue dequeue batch
+ * @param items Returns the items removed, in order.
+ * @param count The most items to remove.
+ *
+ * @returns int The number of items removed.
+ */
+template <class T>
+int LockedAQueue<T>::tryDequeueBatch(T* items, int count)
+{
+  lock_guard<mutex> guard(lock);
+  int numRemoved = 0;
+  while (numRemoved < count && !this->items.isEmpty())
+  {
+    items[numRemoved] = this->items.front();
+    this->items.dequeue();
+    numRemoved++;
+  }
+  return numRemoved;
+}
+
+
+/** locked queue is empty
+ * @returns bool true if the queue was empty when checked.
+ */
+template <class T>
+bool LockedAQueue<T>::isEmpty() const
+{
+  lock_guard<mutex> guard(lock);
+  return items.isEmpty();
+}
+
+
+/** locked queue length
+ * @returns int The length of the queue when checked.
+ */
+template <class T>
+int LockedAQueue<T>::length() const
+{
+  lock_guard<mutex> guard(lock);
+  return items.length();
+}
+
+
+/** locked queue capacity
+ * @returns int The most items the queue can hold.
+ */
+template <class T>
+int LockedAQueue<T>::capacity() const
+{
+  return maxLength;
+}
@@ -0,0 +1,126 @@
+/**
+ * @description Bounded queues that can be shared by threads: a lock free
+ *   multi-producer/multi-consumer ring buffer, the concurrent counterpart
+ *   of AQueue, and a mutex protected AQueue to compare it against.
+ */
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include "Queue.hpp"
+using namespace std;
+#ifndef CONCURRENTQUEUE_HPP
+#define CONCURRENTQUEUE_HPP
+
+
+// size of a cache line, the indexes of concurrent queues are padded to
+// this size so that producers and consumers do not falsely share a line
+const int cacheLineSize = 64;
+
+
+
+//-------------------------------------------------------------------------
+/** concurrent queue (lock free array implementation)
+ * A bounded multi-producer/multi-consumer queue, using the ring buffer
+ * algorithm of Dmitry Vyukov.  Like AQueue, items are kept in a circular
+ * buffer, but the capacity is fixed (rounded up to a power of two, so
+ * that indexes wrap with a mask rather than a division) and the queue is
+ * never grown.  Each cell of the buffer has a sequence number that tells
+ * producers and consumers whether the cell is ready for them, so claiming
+ * a cell is a single compare and swap of the enqueue or dequeue index,
+ * and producers and consumers only contend with each other when the
+ * queue is nearly empty or full.
+ *
+ * Operations never block, they return false (or a short count) when the
+ * queue is full or empty.  The batch operations claim a run of cells with
+ * one compare and swap, amortizing the contention on the index.  There is
+ * no front() or operator[], since other threads may change the queue at
+ * any time, and length() is only approximate while threads are using
+ * the queue.
+ *
+ * Items must be default constructible and move assignable, every cell
+ * holds an item.
+ *
+ * @var cells The ring buffer, capacity cells.
+ * @var mask The capacity - 1, for wrapping indexes.
+ * @var enqueueIndex The position of the next item to enqueue, on a cache
+ *   line of its own.
+ * @var dequeueIndex The position of the next item to dequeue, on a cache
+ *   line of its own.
+ */
+template <class T>
+class ConcurrentAQueue
+{
+private:
+  struct Cell
+  {
+    atomic<size_t> sequence;
+    T item;
+  };
+
+  char padStart[cacheLineSize];
+  Cell* cells;
+  size_t mask;
+  char padCells[cacheLineSize - sizeof(Cell*) - sizeof(size_t)];
+  atomic<size_t> enqueueIndex;
+  char padEnqueue[cacheLineSize - sizeof(atomic<size_t>)];
+  atomic<size_t> dequeueIndex;
+  char padDequeue[cacheLineSize - sizeof(atomic<size_t>)];
+
+  // queues own their cells, they can not be copied
+  ConcurrentAQueue(const ConcurrentAQueue<T>&);
+  ConcurrentAQueue<T>& operator=(const ConcurrentAQueue<T>&);
+
+public:
+  ConcurrentAQueue(int minCapacity = 1024); // constructor
+  ~ConcurrentAQueue(); // destructor
+  bool tryEnqueue(const T& newItem);
+  bool tryEnqueue(T&& newItem);
+  bool tryDequeue(T& item);
+  int tryEnqueueBatch(const T* newItems, int count);
+  int tryDequeueBatch(T* items, int count);
+  bool isEmpty() const;
+  int length() const;
+  int capacity() const;
+};
+
+
+
+//-------------------------------------------------------------------------
+/** locked queue (mutex protected array implementation)
+ * A bounded queue shared by threads by protecting an AQueue with a
+ * mutex.  It has the same operations as ConcurrentAQueue, so the two can
+ * be compared in benchmarks.  Every operation, including batches, holds
+ * the lock for its whole duration.
+ *
+ * @var items The queue of items.
+ * @var maxLength The capacity of the queue.
+ * @var lock Protects the items.
+ */
+template <class T>
+class LockedAQueue
+{
+private:
+  AQueue<T> items;
+  int maxLength;
+  mutable mutex lock;
+
+public:
+  LockedAQueue(int capacity = 1024); // constructor
+  bool tryEnqueue(const T& newItem);
+  bool tryEnqueue(T&& newItem);
+  bool tryDequeue(T& item);
+  int tryEnqueueBatch(const T* newItems, int count);
+  int tryDequeueBatch(T* items, int count);
+  bool isEmpty() const;
+  int length() const;
+  int capacity() const;
+};
+
+
+
+
+// include the implementation of the concurrent queues
+#include "ConcurrentQueue.cpp"
+
+#endif
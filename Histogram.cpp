@@ -0,0 +1,206 @@
+/**
+ * @description Constant memory histograms of simulation results, for
+ *   reporting percentiles (tail latencies) rather than only averages.
+ */
+#include <climits>
+#include <cstdint>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Histogram.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** log histogram constructor
+ * Create an empty histogram.
+ */
+LogHistogram::LogHistogram()
+  : counts(numBuckets, 0)
+{
+  totalCount = 0;
+  maxValue = 0;
+}
+
+
+/** bucket highest value
+ * The largest value that is counted in the given bucket, which is the
+ * value reported for the bucket (so a reported percentile is never below
+ * the true one).
+ *
+ * @param bucket The bucket index.
+ *
+ * @returns long long The largest value of the bucket.
+ */
+long long LogHistogram::bucketHighestValue(int bucket)
+{
+  if (bucket < (1 << mantissaBits))
+  {
+    return bucket;
+  }
+  int shift = bucket / subBuckets - 1;
+  unsigned long long mantissa = bucket - shift * subBuckets;
+  unsigned long long highest = ((mantissa + 1) << shift) - 1;
+  return (highest > (unsigned long long)LLONG_MAX) ? LLONG_MAX : (long long)highest;
+}
+
+
+/** log histogram clear
+ * Remove all of the recorded values.
+ */
+void LogHistogram::clear()
+{
+  counts.assign(numBuckets, 0);
+  totalCount = 0;
+  maxValue = 0;
+}
+
+
+/** log histogram merge
+ * Add all of the values recorded in another histogram to this one.
+ *
+ * @param other The histogram to add.
+ */
+void LogHistogram::merge(const LogHistogram& other)
+{
+  for (int bucket = 0; bucket < numBuckets; bucket++)
+  {
+    counts[bucket] += other.counts[bucket];
+  }
+  totalCount += other.totalCount;
+  if (other.maxValue > maxValue)
+  {
+    maxValue = other.maxValue;
+  }
+}
+
+
+/** log histogram count
+ * @returns long long The number of values recorded.
+ */
+long long LogHistogram::count() const
+{
+  return totalCount;
+}
+
+
+/** log histogram max
+ * @returns long long The largest value recorded (exactly), 0 if none.
+ */
+long long LogHistogram::max() const
+{
+  return maxValue;
+}
+
+
+/** log histogram percentile
+ * The value at the given percentile, that is the smallest bucket value
+ * that at least percent percent of the recorded values are at or below.
+ *
+ * @param percent The percentile, in range [0.0, 100.0].
+ *
+ * @returns long long The value at the percentile, never more than the
+ *   largest value recorded.  0 if no values have been recorded.
+ */
+long long LogHistogram::percentile(double percent) const
+{
+  if (totalCount == 0)
+  {
+    return 0;
+  }
+
+  long long rank = (long long)ceil(percent / 100.0 * totalCount);
+  if (rank < 1)
+  {
+    rank = 1;
+  }
+
+  long long seen = 0;
+  for (int bucket = 0; bucket < numBuckets; bucket++)
+  {
+    seen += counts[bucket];
+    if (seen >= rank)
+    {
+      long long value = bucketHighestValue(bucket);
+      return (value < maxValue) ? value : maxValue;
+    }
+  }
+  return maxValue;
+}
+
+
+/** log histogram percentile string
+ * The standard tail percentiles, for display.
+ *
+ * @returns string The p50, p90, p99, p99.9 and max values.
+ */
+string LogHistogram::percentileString() const
+{
+  ostringstream out;
+  out << "p50 " << percentile(50.0)
+      << ", p90 " << percentile(90.0)
+      << ", p99 " << percentile(99.0)
+      << ", p99.9 " << percentile(99.9)
+      << ", max " << max();
+  return out.str();
+}
+
+
+/** log histogram save
+ * Write the histogram to a snapshot.  Only the buckets in use are
+ * written, as (bucket, count) pairs, since most of the buckets of a
+ * histogram of a simulation's wait times are never used.
+ *
+ * @param snapshot The snapshot being written.
+ */
+void LogHistogram::save(SnapshotWriter& snapshot) const
+{
+  vector<int32_t> usedBuckets;
+  vector<long long> usedCounts;
+  for (int bucket = 0; bucket < numBuckets; bucket++)
+  {
+    if (counts[bucket] != 0)
+    {
+      usedBuckets.push_back(bucket);
+      usedCounts.push_back(counts[bucket]);
+    }
+  }
+  snapshot.write(totalCount);
+  snapshot.write(maxValue);
+  snapshot.writeVector(usedBuckets);
+  snapshot.writeVector(usedCounts);
+}
+
+
+/** log histogram restore
+ * Read the histogram back from a snapshot, see save().
+ *
+ * @param snapshot The snapshot being read.
+ *
+ * @throws SnapshotException If the buckets read are not buckets of the
+ *   histogram.
+ */
+void LogHistogram::restore(SnapshotReader& snapshot)
+{
+  clear();
+  vector<int32_t> usedBuckets;
+  vector<long long> usedCounts;
+  snapshot.read(totalCount);
+  snapshot.read(maxValue);
+  snapshot.readVector(usedBuckets);
+  snapshot.readVector(usedCounts);
+  if (usedBuckets.size() != usedCounts.size())
+  {
+    throw SnapshotException("histogram is corrupt");
+  }
+  for (size_t index = 0; index < usedBuckets.size(); index++)
+  {
+    if (usedBuckets[index] < 0 || usedBuckets[index] >= numBuckets)
+    {
+      throw SnapshotException("histogram is corrupt");
+    }
+    counts[usedBuckets[index]] = usedCounts[index];
+  }
+}
@@ -0,0 +1,100 @@
+/**
+ * @description Constant memory histograms of simulation results, for
+ *   reporting percentiles (tail latencies) rather than only averages.
+ */
+#include <climits>
+#include <string>
+#include <vector>
+#include "Snapshot.hpp"
+using namespace std;
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+
+//-------------------------------------------------------------------------
+/** LogHistogram
+ * A histogram of non negative integer values with logarithmically sized
+ * buckets, in the style of HdrHistogram.  Values below 2^mantissaBits
+ * each have a bucket of their own, so they are counted exactly.  Larger
+ * values share buckets that keep the top mantissaBits bits of the value,
+ * so each power of two range is split into 2^(mantissaBits - 1) buckets,
+ * and the value reported for a bucket is within 1 part in 128 of any
+ * value recorded in it.  The whole 64 bit range needs fewer than 8000
+ * buckets, so memory use is constant no matter how many values are
+ * recorded or how large they get, and record() is a count leading zeros
+ * instruction, a shift and an increment.
+ *
+ * @var counts The number of values recorded in each bucket.
+ * @var totalCount The number of values recorded.
+ * @var maxValue The largest value recorded.
+ */
+class LogHistogram
+{
+private:
+  static const int mantissaBits = 8;
+  static const int subBuckets = 1 << (mantissaBits - 1);
+  static const int numBuckets = (64 - mantissaBits + 2) * subBuckets;
+
+  vector<long long> counts;
+  long long totalCount;
+  long long maxValue;
+
+  static long long bucketHighestValue(int bucket);
+
+public:
+  LogHistogram(); // constructor
+
+  /** bucket index
+   * The bucket a value is counted in.
+   *
+   * @param value A non negative value.
+   *
+   * @returns int The index of the bucket of the value.
+   */
+  static int bucketIndex(long long value)
+  {
+    unsigned long long bits = value;
+    if (bits < (1ULL << mantissaBits))
+    {
+      return (int)bits;
+    }
+    int shift = (63 - __builtin_clzll(bits)) - mantissaBits + 1;
+    return shift * subBuckets + (int)(bits >> shift);
+  }
+
+  /** record
+   * Count one value in the histogram.
+   *
+   * @param value The value to record, negative values are counted as 0.
+   */
+  void record(long long value)
+  {
+    if (value < 0)
+    {
+      value = 0;
+    }
+    counts[bucketIndex(value)]++;
+    totalCount++;
+    if (value > maxValue)
+    {
+      maxValue = value;
+    }
+  }
+
+  void clear();
+  void merge(const LogHistogram& other);
+  long long count() const;
+  long long max() const;
+  long long percentile(double percent) const;
+  string percentileString() const;
+  void save(SnapshotWriter& snapshot) const;
+  void restore(SnapshotReader& snapshot);
+};
+
+
+
+
+// include the implementation of the histograms
+#include "Histogram.cpp"
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * @description Allocation of unique job ids, shared safely by threads,
+ *   one id at a time or in reserved blocks of ids per thread.
+ */
+#include <climits>
+#include <string>
+#include "JobIdAllocator.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** job id allocator constructor
+ * Create an allocator whose first id is the given id.
+ *
+ * @param firstId The first id to hand out.
+ */
+JobIdAllocator::JobIdAllocator(int firstId)
+  : firstId(firstId), nextId(firstId)
+{
+}
+
+
+/** job id allocator copy constructor
+ * Create an allocator that hands out the same ids as another one from
+ * now on, such as for a copy of a simulation.
+ *
+ * @param allocator The allocator to copy.
+ */
+JobIdAllocator::JobIdAllocator(const JobIdAllocator& allocator)
+  : firstId(allocator.firstId), nextId(allocator.peek())
+{
+}
+
+
+/** job id allocator assignment
+ * Make this allocator hand out the same ids as another one from now on.
+ *
+ * @param allocator The allocator to copy.
+ *
+ * @returns JobIdAllocator& This allocator.
+ */
+JobIdAllocator& JobIdAllocator::operator=(const JobIdAllocator& allocator)
+{
+  firstId = allocator.firstId;
+  nextId.store(allocator.peek(), memory_order_relaxed);
+  return *this;
+}
+
+
+/** job id allocator reset
+ * Start handing out ids from the first id again, for the next run of a
+ * simulation.  No thread may be allocating ids while the allocator is
+ * reset, and blocks reserved before the reset should be released.
+ */
+void JobIdAllocator::reset()
+{
+  nextId.store(firstId, memory_order_relaxed);
+}
+
+
+/** job id allocator reset (first id)
+ * Start handing out ids from a new first id.
+ *
+ * @param firstId The first id to hand out.
+ */
+void JobIdAllocator::reset(int firstId)
+{
+  this->firstId = firstId;
+  reset();
+}
+
+
+/** job id allocator peek
+ * @returns int The id the next allocate() would hand out, which is one
+ *   more than the last id handed out, while no other thread is
+ *   allocating.
+ */
+int JobIdAllocator::peek() const
+{
+  return nextId.load(memory_order_relaxed);
+}
+
+
+/** job id allocator allocate
+ * Hand out one id.
+ *
+ * @returns int The id.
+ *
+ * @throws JobIdAllocatorException If the ids have run out.
+ */
+int JobIdAllocator::allocate()
+{
+  return reserve(1);
+}
+
+
+/** job id allocator reserve
+ * Hand out a block of consecutive ids with one atomic update of the
+ * counter.
+ *
+ * @param count The number of ids to reserve, at least 1.
+ *
+ * @returns int The first id of the block, the ids are first to
+ *   first + count - 1.
+ *
+ * @throws JobIdAllocatorException If count is less than 1, or the ids
+ *   have run out, the block would go past INT_MAX.
+ */
+int JobIdAllocator::reserve(int count)
+{
+  if (count < 1)
+  {
+    throw JobIdAllocatorException("can not reserve " + to_string(count) + " ids");
+  }
+
+  // a compare and swap loop rather than a fetch and add, so the counter
+  // never wraps around past INT_MAX to ids that were already handed out.
+  // The ids only have to be unique, they do not order any other memory,
+  // so the operations are relaxed
+  int first = nextId.load(memory_order_relaxed);
+  do
+  {
+    if (first > INT_MAX - count)
+    {
+      throw JobIdAllocatorException("ran out of ids");
+    }
+  }
+  while (!nextId.compare_exchange_weak(first, first + count, memory_order_relaxed));
+  return first;
+}
+
+
+
+//-------------------------------------------------------------------------
+/** job id block constructor
+ * Create an empty block, the first call to next() reserves the first
+ * batch of ids.
+ *
+ * @param allocator The allocator to reserve the ids from.
+ * @param batchSize The number of ids to reserve at a time, at least 1.
+ *
+ * @throws JobIdAllocatorException If the batch size is less than 1.
+ */
+JobIdBlock::JobIdBlock(JobIdAllocator& allocator, int batchSize)
+  : allocator(&allocator), batchSize(batchSize), nextId(0), endId(0)
+{
+  if (batchSize < 1)
+  {
+    throw JobIdAllocatorException("can not reserve " + to_string(batchSize) + " ids");
+  }
+}
+
+
+/** job id block release
+ * Give up the rest of the block, such as after the allocator is reset,
+ * so the next call to next() reserves a new block.  The ids given up
+ * are not handed out again.
+ */
+void JobIdBlock::release()
+{
+  nextId = endId = 0;
+}
+
+
+/** job id block remaining
+ * @returns int The number of ids of the block not yet handed out.
+ */
+int JobIdBlock::remaining() const
+{
+  return endId - nextId;
+}
+
+
+/** job id block peek
+ * @returns int The id the next call to next() hands out, while no other
+ *   thread is reserving ids from the allocator.
+ */
+int JobIdBlock::peek() const
+{
+  return (nextId == endId) ? allocator->peek() : nextId;
+}
@@ -0,0 +1,117 @@
+/**
+ * @description Allocation of unique job ids, shared safely by threads,
+ *   one id at a time or in reserved blocks of ids per thread.
+ */
+#include <atomic>
+#include <string>
+using namespace std;
+#ifndef JOBIDALLOCATOR_HPP
+#define JOBIDALLOCATOR_HPP
+
+
+//-------------------------------------------------------------------------
+/** JobIdAllocator
+ * A counter of job ids that threads can allocate from at the same time.
+ * Each id is handed out once, by an atomic update of the counter, and a
+ * thread that creates many jobs can reserve a whole block of ids with
+ * one update (see JobIdBlock), so threads only touch the shared counter
+ * once per block.
+ *
+ * Ids are ints counting up from the first id.  A simulation has an
+ * allocator of its own, reset for each run, so its job ids depend only
+ * on the run and not on any other simulation running at the same time.
+ * Copying an allocator copies where its counter has got to, so copies
+ * hand out the same ids as each other, and no thread may be allocating
+ * from an allocator while it is copied.
+ *
+ * @var firstId The first id handed out, after a reset().
+ * @var nextId The next id to hand out.
+ */
+class JobIdAllocator
+{
+private:
+  int firstId;
+  atomic<int> nextId;
+
+public:
+  JobIdAllocator(int firstId = 1); // constructor
+  JobIdAllocator(const JobIdAllocator& allocator); // copy constructor
+  JobIdAllocator& operator=(const JobIdAllocator& allocator);
+  void reset();
+  void reset(int firstId);
+  int peek() const;
+  int allocate();
+  int reserve(int count);
+};
+
+
+/** JobIdBlock
+ * A block of ids reserved from a JobIdAllocator, for one thread to hand
+ * out without any atomic operations.  When the block is used up the next
+ * block of batchSize ids is reserved.  A thread with a block of its own
+ * takes unique ids that no other thread or block gets, and a single
+ * thread taking all of its ids from one block gets them in order.
+ *
+ * @var allocator The allocator the blocks are reserved from.
+ * @var batchSize The number of ids reserved at a time.
+ * @var nextId The next id of the block to hand out.
+ * @var endId One past the last id of the block.
+ */
+class JobIdBlock
+{
+private:
+  JobIdAllocator* allocator;
+  int batchSize;
+  int nextId;
+  int endId;
+
+public:
+  JobIdBlock(JobIdAllocator& allocator, int batchSize = 256); // constructor
+  void release();
+  int remaining() const;
+  int peek() const;
+
+  /** next id
+   * @returns int The next unique id, reserving another block of ids
+   *   from the allocator when this one is used up.
+   */
+  int next()
+  {
+    if (nextId == endId)
+    {
+      nextId = allocator->reserve(batchSize);
+      endId = nextId + batchSize;
+    }
+    return nextId++;
+  }
+};
+
+
+/** job id allocator exception
+ * Class to be thrown when a job id allocator is asked for a block of no
+ * ids, or runs out of ids.
+ */
+class JobIdAllocatorException
+{
+private:
+  string message;
+
+public:
+  JobIdAllocatorException(string message)
+  {
+    this->message = message;
+  }
+
+  string what()
+  {
+    return "Error: job id allocator " + message;
+  }
+};
+
+
+
+
+// include the implementation of the job id allocator
+#include "JobIdAllocator.cpp"
+
+#endif
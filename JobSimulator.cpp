@@ -3,256 +3,272 @@
  * @description Assignment 11 Priority queues and scheduling
  *   simulation of jobs with priorities.
  */
+#include <algorithm>
 #include <climits>
 #include <cmath>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <type_traits>
 #include "JobSimulator.hpp"
-#include "Queue.hpp"
-#include "JobSimulator.cpp"
-#include "Queue.cpp"
-#include "assg-11.cpp"
 using namespace std;
 
 
 
 //-------------------------------------------------------------------------
-/**
- * A constant for the Job class, used to keep track of
- * and assign unique id's for each job created.
- */
-int Job::nextListId = 1;
-
-
-/** Job default constructor
- * Default constructor for Job, needed because some Queue types
- * create an empty array of Job objects, so they need to get filled
- * with empty jobs.  We simply initialize everything to 0, as 
- * Job objects created this way, without a priority or service time,
- * can't be used as real jobs in a simulation.
+/** server pool constructor
+ * Create a pool of idle servers.
+ *
+ * @param numServers The number of servers, at least 1.
+ * @param maxServiceTime The longest service time of the jobs the servers
+ *   will run, which sizes the completion wheel.
  */
-Job::Job()
+ServerPool::ServerPool(int numServers, int maxServiceTime)
 {
-  this->id = 0;
-  this->priority = 0;
-  this->serviceTime = 0;
-  this->startTime = 0;
-  this->endTime = 0;
+  reset(numServers, maxServiceTime);
 }
 
 
-/** Job constructor
- * The actual constructor that needs to be used for Jobs in a simulation.
- * The job is assigned a priority, serviceTime and we record the startTime
- * when the job arrived and began waiting on the system queue for processing.
- * 
- * @param priority Each job in our simulations has a priority level.  In this
- *   Job object and simulation, the higher the number, the higher the priority
- *   of the Job.
- * @param serviceTime This is the time that the job needs to run, once it is
- *   selected/scheduled by the system dispatcher to be executed.  This represents
- *   the time the system is busy processing this Job once it starts running.
- * @param startTime The system time at which this jobs was created.  Also will be
- *   the system time this job was added to a job queue in the system and began
- *   waiting to be executed.
+/** server pool reset
+ * Make all of the servers idle, with no busy time, ready for a new
+ * simulation run.  Server 0 is on top of the idle stack, so it is the
+ * first to be given a job.
+ *
+ * @param numServers The number of servers, at least 1.
+ * @param maxServiceTime The longest service time of the jobs the servers
+ *   will run.  Longer jobs still work, their completions just go on the
+ *   wheel's overflow heap.
  */
-Job::Job(int priority, int serviceTime, int startTime)
+void ServerPool::reset(int numServers, int maxServiceTime)
 {
-  this->id = nextListId++;
-  this->priority = priority;
-  this->serviceTime = serviceTime;
-  this->startTime = startTime;
-  this->endTime = startTime;
+  idleServers.clear();
+  for (int server = numServers - 1; server >= 0; server--)
+  {
+    idleServers.push_back(server);
+  }
+  completions.reset(maxServiceTime);
+  freeAt.assign(numServers, -1);
+  busyTime.assign(numServers, 0);
 }
 
 
-/** endTime setter
- * Setter method to set the endTime of this Job.  This is actually the endTime
- * of when the job stoped waiting and began executing (not the time when the job
- * was finished).  The endTime - startTime gives the total waitTime this job
- * spent waiting.
+/** server pool release
+ * Move every server whose job has finished by the given time back
+ * to the idle stack.
  *
- * @param endTime The time when job stoped waiting on a queue and began executing.
+ * @param time The current simulation time.
  */
-void Job::setEndTime(int endTime)
+void ServerPool::release(long long time)
 {
-  this->endTime = endTime;
+  while (completions.nextTime() <= time)
+  {
+    int server = completions.popNext();
+    idleServers.push_back(server);
+    freeAt[server] = -1;
+  }
 }
 
 
-/** id getter
- * Getter method to return this Job's id.  Used for display purposes.
+/** server pool release next
+ * Move the first server to become free back to the idle stack, if its
+ * job has finished by the given time.  Used instead of release() when
+ * the caller needs to know which servers were freed.
+ *
+ * @param time The current simulation time.
  *
- * @returns int The unique id of this Job is returned.
+ * @returns int The server that was freed, or -1 if no busy server is
+ *   free by the given time.
  */
-int Job::getId() const
+int ServerPool::releaseNext(long long time)
 {
-  return id;
+  if (completions.nextTime() > time)
+  {
+    return -1;
+  }
+  int server = completions.popNext();
+  idleServers.push_back(server);
+  freeAt[server] = -1;
+  return server;
 }
 
 
-/** service time getter
- * Getter method to return this Job's service time.  Service time
- * is the amount of time this job needs from the system to complete
- * its task.
- *
- * @returns int The serviceTime for this Job is returned.
+/** server pool has idle server
+ * @returns bool true if a server is free to run a job, as of the
+ *   last call to release().
  */
-int Job::getServiceTime() const
+bool ServerPool::hasIdleServer() const
 {
-  return serviceTime;
+  return !idleServers.empty();
 }
 
 
-/** priority getter
- * Getter method to return this Job's priority level.  Priority
- * is a measure of the job importance.  In this simulation, higher
- * priority means higher importance.
- *
- * @returns int The priority level for this Job is returned.
+/** server pool next free time
+ * @returns long long The earliest time a busy server becomes free, or
+ *   LLONG_MAX if no server is busy.
  */
-int Job::getPriority() const
+long long ServerPool::nextFreeTime() const
 {
-  return priority;
+  return completions.nextTime();
 }
 
 
-/** waitTime getter
- * Getter method to return this Job's waitTime.  Wait time is
- * the difference from the endTime when the job stoped waiting
- * (and began executing) and startTime when the job was created
- * and began waiting to get access to the system for execution.
+/** server pool start
+ * Start a job on the idle server at the top of the idle stack, there
+ * must be one.  The server is busy for serviceTime steps, of which those
+ * up to the end of the simulation count towards its busy time.
+ *
+ * @param time The current simulation time, when the job starts.
+ * @param serviceTime The number of steps the job runs for.
+ * @param endOfTime The last time step of the simulation.
  *
- * @returns int The wait time for this Job is returned.  Wait time
- *   is not valid until after the job as exited the wait queue, and
- *   its endTime has been set.
+ * @returns int The server the job was started on.
  */
-int Job::getWaitTime() const
+int ServerPool::start(long long time, int serviceTime, long long endOfTime)
 {
-  return endTime - startTime;
+  int server = idleServers.back();
+  idleServers.pop_back();
+  freeAt[server] = time + serviceTime;
+  completions.schedule(freeAt[server], server);
+
+  long long stepsBusy = endOfTime - time + 1;
+  if (serviceTime < stepsBusy)
+  {
+    stepsBusy = serviceTime;
+  }
+  busyTime[server] += stepsBusy;
+  return server;
 }
 
 
-/** cost getter
- * Getter method to return this Job's cost.  Cost is a measure of
- * used to evaluate how well a particular system performs in
- * processing jobs.  In this simulation, we want to minimize time
- * high priority jobs spend waiting, and maximize high priority
- * job throughput.  Thus cost is a combination of priority and how
- * long the job spent waiting to be processed.  Since higher numbers
- * are used to mean higher priorities, multiplying the wait time 
- * times the priority scales the cost so that high priority jobs
- * that have to wait for long periods have high costs.  In the
- * system, we want to minimize cost as a measure of performance.
+/** server pool preempt
+ * Stop the job running on a busy server before it is done, and put the
+ * server on top of the idle stack, so it is the next to be given a job.
+ * The steps the job will no longer run are taken back off of the
+ * server's busy time.
+ *
+ * @param server The busy server to preempt.
+ * @param time The current simulation time, the job does not run at
+ *   this step or after.
+ * @param endOfTime The last time step of the simulation.
  *
- * @returns int The cost for this Job is returned.  Cost is a measure
- *   of performance with regards to this parcitular jobs.  Cost is
- *   measured in this system as the job priority times the time the
- *   job was forced to wait before it could start executing.
+ * @returns int The number of steps of service the job still needed.
  */
-int Job::getCost() const
+int ServerPool::preempt(int server, long long time, long long endOfTime)
 {
-  return priority * getWaitTime();
+  long long jobFreeAt = freeAt[server];
+  completions.remove(jobFreeAt, server);
+  freeAt[server] = -1;
+  idleServers.push_back(server);
+
+  long long stepsLost = ((jobFreeAt < endOfTime + 1) ? jobFreeAt : endOfTime + 1) - time;
+  if (stepsLost > 0)
+  {
+    busyTime[server] -= stepsLost;
+  }
+  return jobFreeAt - time;
 }
 
 
-/** overload boolean equal comparison
- * Overload boolean comparison between jobs.  The main purpose of
- * providing boolean comparisons between jobs in this simulation is
- * so that priority based schedulers can order the jobs based on
- * priority level, from lowest priority to highest priority.  Thus
- * for a Job, jobs are equal when they have equal priorities.
- *
- * @param rhs The Job object on the right hand side of the boolean
- *   comparison.
- *
- * @returns bool True if the two jobs have equal priority, false
- *   otherwise.
+/** server pool number of servers
+ * @returns int The number of servers in the pool.
  */
-bool Job::operator==(const Job& rhs) const
+int ServerPool::numServers() const
 {
-  return this->priority == rhs.priority;
+  return busyTime.size();
 }
 
 
-/** overload boolean less than
- * Overload boolean less than comparison between jobs.  The main
- * purpose of providing boolean comparisons between jobs in this
- * simulation is so that priority based schedulers can order the jobs
- * based on priority level, from lowest priority to highest priority.
- * Thus for a Job, a job is less than another job if its priority
- * is smaller.
+/** server pool server busy time
+ * @param server The server, in range [0, numServers()).
  *
- * @param rhs The Job object on the right hand side of the boolean
- *   comparison.
- *
- * @returns bool True if this job has lower priority than the rhs
- *   job, false otherwise.
+ * @returns long long The number of steps the server has been busy.
  */
-bool Job::operator<(const Job& rhs) const
+long long ServerPool::serverBusyTime(int server) const
 {
-  return this->priority < rhs.priority;
+  return busyTime[server];
 }
 
 
-/** overload boolean greater than
- * Overload boolean greater than comparison between jobs.  The main
- * purpose of providing boolean comparisons between jobs in this
- * simulation is so that priority based schedulers can order the jobs
- * based on priority level, from lowest priority to highest priority.
- * Thus for a Job, a job is greater than another job if its priority
- * is bigger.
- *
- * @param rhs The Job object on the right hand side of the boolean
- *   comparison.
+/** server pool save
+ * Write the servers to a snapshot: the idle stack, in order, and when
+ * each busy server becomes free.  The completions are not written, they
+ * are the busy servers by the time they become free.
  *
- * @returns bool True if this job has higher priority than the rhs
- *   job, false otherwise.
+ * @param snapshot The snapshot being written.
  */
-bool Job::operator>(const Job& rhs) const
+void ServerPool::save(SnapshotWriter& snapshot) const
 {
-  return this->priority > rhs.priority;
+  snapshot.writeVector(idleServers);
+  snapshot.writeVector(freeAt);
+  snapshot.writeVector(busyTime);
 }
 
 
-/** overload boolean <=
- * Overload boolean less than or equal comparison between jobs.  The
- * main purpose of providing boolean comparisons between jobs in this
- * simulation is so that priority based schedulers can order the jobs
- * based on priority level, from lowest priority to highest priority.
- * Thus for a Job, a job is less than or equal another job if its
- * priority is smaller or the same.
+/** server pool restore
+ * Read the servers back from a snapshot, see save(), and put the busy
+ * servers back on the completion wheel, earliest first.  Servers that
+ * become free at the same time come off the wheel in server order, so
+ * the order they were scheduled in makes no difference.
  *
- * @param rhs The Job object on the right hand side of the boolean
- *   comparison.
+ * @param snapshot The snapshot being read.
+ * @param maxServiceTime The longest service time of the jobs the servers
+ *   will run, see reset().
  *
- * @returns bool True if this job has lower or equal priority than the
- *   rhs job, false otherwise.
+ * @throws SnapshotException If the servers read are inconsistent.
  */
-bool Job::operator<=(const Job& rhs) const
+void ServerPool::restore(SnapshotReader& snapshot, int maxServiceTime)
 {
-  return this->priority <= rhs.priority;
+  snapshot.readVector(idleServers);
+  snapshot.readVector(freeAt);
+  snapshot.readVector(busyTime);
+
+  // every server is either idle, on the stack once, or busy
+  int numServers = freeAt.size();
+  bool consistent = busyTime.size() == freeAt.size();
+  vector<pair<long long, int> > busyServers;
+  for (int server = 0; server < numServers; server++)
+  {
+    if (freeAt[server] >= 0)
+    {
+      busyServers.push_back(make_pair(freeAt[server], server));
+    }
+  }
+  for (size_t index = 0; index < idleServers.size(); index++)
+  {
+    int server = idleServers[index];
+    consistent = consistent && server >= 0 && server < numServers && freeAt[server] < 0;
+  }
+  if (!consistent || busyServers.size() + idleServers.size() != freeAt.size())
+  {
+    throw SnapshotException("servers are corrupt");
+  }
+
+  sort(busyServers.begin(), busyServers.end());
+  completions.reset(maxServiceTime);
+  for (size_t index = 0; index < busyServers.size(); index++)
+  {
+    completions.schedule(busyServers[index].first, busyServers[index].second);
+  }
 }
 
 
-/** overload output stream operator 
- * Overload the output stream operator to provide a representation
- * of this Job suitable for display.  Mainly useful for displaying
- * queue contents and for debugging purposes.
+
+//-------------------------------------------------------------------------
+/** running job output
+ * Display a running job, for debugging.
+ *
+ * @param out The output stream to display on.
+ * @param runningJob The running job to display.
+ *
+ * @returns ostream The output stream, for chaining.
  */
-ostream& operator<<(ostream& out, const Job& aJob)
+ostream& operator<<(ostream& out, const RunningJob& runningJob)
 {
-  // out << "[id: " << aJob.id
-  //     << " priority: " << aJob.priority
-  //     << " serviceTime: " << aJob.serviceTime
-  //     << " startTime: " << aJob.startTime
-  //     << " endTime: " << aJob.endTime
-  //     << " waitTime: " << aJob.getWaitTime()
-  //     << "]";
-  out << "[id: " << aJob.id
-      << " priority: " << aJob.priority
+  out << "[server: " << runningJob.server
+      << " id: " << runningJob.job.id
+      << " priority: " << runningJob.job.priority
       << "]";
   return out;
 }
@@ -261,50 +277,147 @@ ostream& operator<<(ostream& out, const Job& aJob)
 
 //-------------------------------------------------------------------------
 /** random uniform
- * Return a random floating point value in the range of [0.0, 1.0] with
+ * Return a random floating point value in the range of (0.0, 1.0] with
  * uniform probability of any value in the range being returned.
- * The algorithm is that rand() returns an int in range [0, RAND_MAX]
- * and doing floating point division on the random integer by 
- * RAND_MAX recasts the result into a floating point number in range
- * [0.0, 1.0].
+ * Each simulator has its own random number engine (see setSeed()),
+ * rather than sharing the global rand(), so that independent simulations
+ * can be run side by side and each one can be reproduced from its seed.
+ * The values are drawn a block at a time, see RandomBlockGenerator.
  *
  * @returns double Returns a randomly generated double valued number
- *   with uniform probability in the range [0.0, 1.0]
+ *   with uniform probability in the range (0.0, 1.0]
  */
 double JobSchedulerSimulator::randomUniform()
 {
-  double randValue = double(rand()) / double(RAND_MAX);
-  return randValue;
+  return randomBlocks.nextUniform();
 }
 
 
-/** random range
- * Generate a random ingeger number in the given range from [minValue to
- * maxValue].  We are given minValue and maxValue, a random integer is
- * generated (with uniform probability) that is between minValue and
- * maxValue (inclusive, so minValue or maxValue are valid results
- * that can be returned, or any integer in between).
+/** seed
+ * Seed this simulator's random number engine.  Two simulators with
+ * the same parameters and seed produce exactly the same results.  Each
+ * run seeds its block generator from the next value of the engine, so
+ * runs one after the other from one seed draw different values.
  *
- * @param minValue The minimum value of the range of integers to generate.
- * @param maxValue The maximum of the range of integers to generate.
+ * @param seed The seed for the random number engine.
+ */
+void JobSchedulerSimulator::setSeed(unsigned long long seed)
+{
+  generator.seed(seed);
+}
+
+
+/** random engine
+ * Access this simulator's random number engine, for example to jump()
+ * it ahead to a separate stream after seeding.
  *
- * @returns int Returns a random integer value in range [minValue,
- *   maxValue] inclusive of the end points.
+ * @returns SimulatorRandomEngine A reference to the random engine.
  */
-int JobSchedulerSimulator::randomRange(int minValue, int maxValue)
+SimulatorRandomEngine& JobSchedulerSimulator::randomEngine()
 {
-  // the range is difference between desired max and min.  We need
-  // this magnitude in order to correctly generate a random value in
-  // the given range
-  int range = maxValue - minValue + 1;
+  return generator;
+}
 
-  // generate a random value in range 0 to range (inclusive)
-  int randValue = rand() % range;
 
-  // shift the value so it is in range [minValue, maxValue]
-  randValue += minValue;
+/** set trace writer
+ * Record every job completed by the following simulation runs to the
+ * given trace.  The trace is not closed by the simulator.  A trace
+ * writer must only be used by one simulator at a time, copies of a
+ * simulator share its trace writer.
+ *
+ * @param traceWriter The trace to record jobs to, or NULL to stop
+ *   recording jobs.
+ */
+void JobSchedulerSimulator::setTraceWriter(JobTraceWriter* traceWriter)
+{
+  this->traceWriter = traceWriter;
+}
+
 
-  return randValue;
+/** set preemptive
+ * Choose between non-preemptive dispatching (the default), where a job
+ * runs to completion once it starts, and preemptive-resume dispatching,
+ * where a waiting job at the front of the job queue that has a higher
+ * priority than a running job interrupts the lowest priority running
+ * job, which goes back on the job queue and later resumes with the
+ * service time it has left.  Preemption lets high priority jobs skip
+ * the wait for a long low priority job to finish, at the cost of the
+ * low priority jobs waiting longer.  A job counts as completed once it
+ * starts for the last time, its wait time is all of the time it spent
+ * on the job queue.
+ *
+ * @param preemptive True for preemptive-resume dispatching.
+ */
+void JobSchedulerSimulator::setPreemptive(bool preemptive)
+{
+  this->preemptive = preemptive;
+}
+
+
+/** is preemptive
+ * @returns bool True if the simulator uses preemptive-resume
+ *   dispatching, see setPreemptive().
+ */
+bool JobSchedulerSimulator::isPreemptive() const
+{
+  return preemptive;
+}
+
+
+/** set checkpoint
+ * Checkpoint the runs of the simulator, by writing a snapshot of the
+ * whole state of a run to a file every interval time steps, from which
+ * the run can be resumed later (see resumeSimulation()), or forked into
+ * several different continuations (see forkSimulation()).  The
+ * checkpoint at time t holds the state of the run once everything up to
+ * time t has happened.  Each checkpoint replaces the one before it, so
+ * the file always holds the latest checkpoint.  A run can also stop at
+ * its first checkpoint, e.g. to warm up a system once and fork it many
+ * times.  The results of a stopped run are the results so far.
+ *
+ * Preemptive simulations and trace replays can not be checkpointed.
+ *
+ * @param fileName The snapshot file to write the checkpoints to.
+ * @param interval The number of time steps between checkpoints, 0 or
+ *   less for no checkpoints.
+ * @param stopAtCheckpoint If true, a run stops once it has written its
+ *   first checkpoint.
+ */
+void JobSchedulerSimulator::setCheckpoint(string fileName, int interval,
+					  bool stopAtCheckpoint)
+{
+  this->checkpointFileName = fileName;
+  this->checkpointInterval = (interval > 0) ? interval : 0;
+  this->stopAtCheckpoint = stopAtCheckpoint;
+}
+
+
+/** checkpoint time getter
+ * @returns int The time of the last checkpoint the most recent run
+ *   wrote or was resumed from, 0 if there was none.
+ */
+int JobSchedulerSimulator::getCheckpointTime() const
+{
+  return checkpointTime;
+}
+
+
+/** job table getter
+ * The table of the waiting jobs of a simulation run on a queue of job
+ * indexes (JobIndex), which the queue's ordering policy compares jobs
+ * by, e.g.
+ *
+ *   HeapPriorityQueue<JobIndex, JobTableOrder<> > jobQueue(4, JobTableOrder<>(&sim.getJobTable()));
+ *
+ * Runs with the queues of Job that are mapped to queues of job indexes
+ * (see JobIndexQueue) use the table too.
+ *
+ * @returns JobTable The jobs still waiting at the end of the most
+ *   recent run, empty for runs on a queue of Job.
+ */
+const JobTable& JobSchedulerSimulator::getJobTable() const
+{
+  return jobTable;
 }
 
 
@@ -316,6 +429,11 @@ int JobSchedulerSimulator::randomRange(int minValue, int maxValue)
  * See Malik Ch. 18, pg. 1233 for description of the poisson arrival
  * calculation here.
  *
+ * A job arrives when a uniform value is greater than e^(-lambda), which
+ * happens with probability 1 - e^(-lambda).  The tests of thousands of
+ * time steps at a time are drawn as a bitmask by the block generator,
+ * so each test is a single bit test.
+ *
  * @param none, but we use the class simulation parameter
  *   jobArrivalProbability to determine if a new job arrived
  *   using a Poisson distribution.  The jobArrivalProbability
@@ -326,10 +444,7 @@ int JobSchedulerSimulator::randomRange(int minValue, int maxValue)
  */
 bool JobSchedulerSimulator::jobArrived()
 {
-  // if a random uniform value in range [0.0, 1.0] is greater than
-  // e^(-arrivalProbability), then a job has arrived according to
-  // the poisson distribution
-  return randomUniform() > exp(-jobArrivalProbability);
+  return randomBlocks.nextArrival();
 }
 
 
@@ -346,7 +461,7 @@ bool JobSchedulerSimulator::jobArrived()
  */
 int JobSchedulerSimulator::generateRandomPriority()
 {
-  return randomRange(minPriority, maxPriority);
+  return randomBlocks.nextPriority();
 }
 
 
@@ -364,12 +479,43 @@ int JobSchedulerSimulator::generateRandomPriority()
  */
 int JobSchedulerSimulator::generateRandomServiceTime()
 {
-  return randomRange(minServiceTime, maxServiceTime);
+  return randomBlocks.nextServiceTime();
 }
 
-JobSchedulerSimulator::JobSchedulerSimulator(){
+
+/** next arrival gap
+ * Generate the number of time steps until the next job arrival, for the
+ * event driven simulation.  In the stepped simulation each step has an
+ * independent chance of 1 - e^(-lambda) of an arrival (see jobArrived()),
+ * so the gap between arrivals is geometrically distributed.  Since
+ * ln(e^(-lambda)) = -lambda, the geometric variate can be drawn with a
+ * single uniform as ceil(-ln(U) / lambda).
+ *
+ * @returns long long The number of steps (at least 1) from the current
+ *   arrival to the next one.  If the next arrival would fall past the end
+ *   of the simulation, simulationTime + 1 is returned.
+ */
+long long JobSchedulerSimulator::nextArrivalGap()
+{
+  double u = randomUniform();
+  if (jobArrivalProbability <= 0.0)
+  {
+    return (long long)simulationTime + 1;
+  }
+
+  double gap = ceil(-log(u) * meanArrivalGap);
+  if (gap < 1.0)
+  {
+    return 1;
+  }
+  if (gap > simulationTime)
+  {
+    return (long long)simulationTime + 1;
+  }
+  return (long long)gap;
 }
 
+
 /** simulator constructor
  * Mostly just a constructor to allow all of the simulation parameters
  * to be set to initial values when a simulation is created.  All of these
@@ -377,33 +523,1303 @@ JobSchedulerSimulator::JobSchedulerSimulator(){
  * job simulation.  All simulation result member values are initialized
  * to 0 or null values in preparation for a simulation run.
  */
-//JobSchedulerSimulator::JobSchedulerSimulator(int simulationTime,
-//					     double jobArrivalProbability,
-//					     int minPriority,
-//					     int maxPriority,
-//					     int minServiceTime,
-//					     int maxServiceTime)
-//{
-//  // initialize/remember the simulation parameters
-//  this->simulationTime = simulationTime;
-//  this->jobArrivalProbability = jobArrivalProbability;
-//  this->minPriority = minPriority;
-//  this->maxPriority = maxPriority;
-//  this->minServiceTime = minServiceTime;
-//  this->maxServiceTime= maxServiceTime;
-//
-//  // initialize simulation results to 0, ready to be calculated
-//  this->description = "";
-//  this->numJobsStarted = 0;
-//  this->numJobsCompleted = 0;
-//  this->numJobsUnfinished = 0;
-//  this->totalWaitTime = 0;
-//  this->totalCost = 0;
-//  this->averageWaitTime = 0.0;
-//  this->averageCost = 0.0;
-//}
+JobSchedulerSimulator::JobSchedulerSimulator(int simulationTime,
+					     double jobArrivalProbability,
+					     int minPriority,
+					     int maxPriority,
+					     int minServiceTime,
+					     int maxServiceTime,
+					     int numServers)
+  : jobIdBlock(jobIds)
+{
+  // initialize/remember the simulation parameters
+  this->simulationTime = simulationTime;
+  this->jobArrivalProbability = jobArrivalProbability;
+  this->minPriority = minPriority;
+  this->maxPriority = maxPriority;
+  this->minServiceTime = minServiceTime;
+  this->maxServiceTime= maxServiceTime;
+  this->numServers = (numServers > 0) ? numServers : 1;
+  this->preemptive = false;
+
+  // no per job trace or checkpoints unless they are asked for
+  traceWriter = NULL;
+  checkpointInterval = 0;
+  stopAtCheckpoint = false;
+
+  // set up the block generator, 1 - e^(-lambda) is the chance of an
+  // arrival in any one time step
+  randomBlocks.setArrivalProbability(-expm1(-jobArrivalProbability));
+  randomBlocks.setPriorityRange(minPriority, maxPriority);
+  randomBlocks.setServiceTimeRange(minServiceTime, maxServiceTime);
+  meanArrivalGap = (jobArrivalProbability > 0.0) ? 1.0 / jobArrivalProbability : 0.0;
+
+  // initialize simulation results to 0, ready to be calculated
+  resetResults("");
+}
+
+
+/** reset results
+ * Put all of the simulation results back to 0 in preparation for
+ * a new simulation run.
+ *
+ * @param description The description of the dispatching/queueing
+ *   method of the run that is about to start.
+ */
+void JobSchedulerSimulator::resetResults(string description)
+{
+  this->description = description;
+  this->numJobsStarted = 0;
+  this->numJobsCompleted = 0;
+  this->numJobsUnfinished = 0;
+  this->totalWaitTime = 0;
+  this->totalCost = 0;
+  this->averageWaitTime = 0.0;
+  this->averageCost = 0.0;
+  waitTimeHistogram.clear();
+  costHistogram.clear();
+  priorityClasses.assign(maxPriority - minPriority + 1, PriorityClassStatistics());
+  this->averageUtilization = 0.0;
+  this->numPreemptions = 0;
+  servers.reset(numServers, maxServiceTime);
+  jobTable.clear();
+  checkpointTime = 0;
+
+  randomBlocks.seedFrom(generator);
+  // a copy of a simulation has a block of the original's allocator
+  jobIds.reset();
+  jobIdBlock = JobIdBlock(jobIds);
+}
+
+
+/** job arrives
+ * Simulate the arrival of a new job at the given time.  A Job is
+ * created with a random priority and service time, directly on the
+ * job queue, where it waits.
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param time The current simulation time, when the job arrived.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::jobArrives(JobQueue& jobQueue, int time)
+{
+  int priority = generateRandomPriority();
+  int serviceTime = generateRandomServiceTime();
+  addJob(jobQueue, time, priority, serviceTime);
+}
+
+
+/** add job
+ * Put a new job that arrived at the given time on the job queue, where
+ * it waits.
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param time The current simulation time, when the job arrived.
+ * @param priority The priority of the job, in [minPriority, maxPriority].
+ * @param serviceTime The service time of the job.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::addJob(JobQueue& jobQueue, int time,
+				   int priority, int serviceTime)
+{
+  typedef typename JobQueue::value_type QueuedJob;
+  enqueueJob(jobQueue, time, priority, serviceTime, (QueuedJob*)NULL);
+  numJobsStarted++;
+  priorityClasses[priority - minPriority].numWaiting++;
+}
 
 
+/** enqueue job
+ * Put a new job on a queue of Jobs, built in place on the queue.
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param time The current simulation time, when the job arrived.
+ * @param priority The priority of the job.
+ * @param serviceTime The service time of the job.
+ * @param jobs Not used, selects this overload for queues of Job.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::enqueueJob(JobQueue& jobQueue, int time,
+				       int priority, int serviceTime, Job* /* jobs */)
+{
+  QueueDispatch<JobQueue>::emplace(jobQueue, jobIdBlock.next(), priority, serviceTime, time);
+}
+
+
+/** enqueue job (job table)
+ * Add a new job to the job table, and put its index on a queue of job
+ * indexes.  The job's id comes from the same ids as in the Job queue
+ * simulation.
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param time The current simulation time, when the job arrived.
+ * @param priority The priority of the job.
+ * @param serviceTime The service time of the job.
+ * @param jobs Not used, selects this overload for queues of JobIndex.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::enqueueJob(JobQueue& jobQueue, int time,
+				       int priority, int serviceTime, JobIndex* /* jobs */)
+{
+  JobIndex index = jobTable.add(jobIdBlock.next(), priority, serviceTime, time);
+  QueueDispatch<JobQueue>::emplace(jobQueue, index);
+}
+
+
+/** next replayed arrival
+ * Move the trace on to its next arrival, and check that the arrival can
+ * be simulated.
+ *
+ * @param trace The trace being replayed.
+ * @param lastArrival The time of the previous arrival.
+ *
+ * @returns long long The time of the next arrival, or simulationTime + 1
+ *   if the trace has ended or the next arrival is past the end of the
+ *   simulation.
+ */
+long long JobSchedulerSimulator::nextReplayedArrival(ArrivalTrace& trace,
+						     long long lastArrival)
+{
+  if (!trace.next() || trace.time() > simulationTime)
+  {
+    return (long long)simulationTime + 1;
+  }
+
+  // the message is only built for an arrival that is rejected, so a
+  // good arrival costs just the checks
+  if (trace.time() < lastArrival || trace.time() < 1)
+  {
+    ostringstream message;
+    message << "arrival " << trace.length() << " at time " << trace.time()
+	    << " is out of time order";
+    throw JobTraceException(message.str());
+  }
+  if (trace.priority() < minPriority || trace.priority() > maxPriority)
+  {
+    ostringstream message;
+    message << "arrival " << trace.length() << " priority " << trace.priority()
+	    << " is outside of the simulation priority range";
+    throw JobTraceException(message.str());
+  }
+  if (trace.serviceTime() < 0)
+  {
+    ostringstream message;
+    message << "arrival " << trace.length() << " has a negative service time";
+    throw JobTraceException(message.str());
+  }
+  return trace.time();
+}
+
+
+/** record job
+ * Add the wait time and cost of a job that has stopped waiting for good
+ * to the results.  The wait time of a job is all of the time between
+ * its arrival and its last start that it was not running, which is the
+ * time it spent on the job queue.
+ *
+ * @param job The job.  Its remainingTime is the service it still needed
+ *   when it last started.
+ * @param time The time the job last started running.
+ */
+void JobSchedulerSimulator::recordJob(const Job& job, int time)
+{
+  int waitTime = time - job.startTime - (job.serviceTime - job.remainingTime);
+  long long cost = (long long)job.getPriority() * waitTime;
+
+  totalWaitTime += waitTime;
+  totalCost += cost;
+  numJobsCompleted++;
+  recordJobDetails(job, time, waitTime, cost);
+}
+
+
+/** record job details
+ * Add a job that has stopped waiting for good to the distributions of
+ * the results, the histograms and its priority class, and to the trace,
+ * see recordJob().
+ *
+ * @param job The job.
+ * @param time The time the job last started running.
+ * @param waitTime The wait time of the job.
+ * @param cost The cost of the job.
+ */
+void JobSchedulerSimulator::recordJobDetails(const Job& job, int time,
+					     int waitTime, long long cost)
+{
+  waitTimeHistogram.record(waitTime);
+  costHistogram.record(cost);
+
+  PriorityClassStatistics& priorityClass = priorityClasses[job.priority - minPriority];
+  priorityClass.waitTime.add(waitTime);
+  priorityClass.cost.add(cost);
+  priorityClass.numWaiting--;
+
+  if (traceWriter != NULL)
+  {
+    traceWriter->record(job.id, job.priority, job.serviceTime, job.startTime,
+			time, cost);
+  }
+}
+
+
+/** record table jobs
+ * Add the results of the jobs that have stopped waiting in the job
+ * table's finished columns, and clear them.  The totals come from one
+ * streaming pass down the columns (see JobTable::finishedTotals()), and
+ * then each job is added to the distributions of the results, in the
+ * order the jobs stopped waiting, as recordJob() would have added it.
+ * The simulator calls this whenever a block of finished jobs is full,
+ * and before the results are used, at a checkpoint or at the end of a
+ * run.
+ */
+void JobSchedulerSimulator::recordTableJobs()
+{
+  JobTableTotals totals = jobTable.finishedTotals();
+  totalWaitTime += totals.totalWaitTime;
+  totalCost += totals.totalCost;
+  numJobsCompleted += totals.numFinished;
+
+  for (int order = 0; order < totals.numFinished; order++)
+  {
+    Job job = jobTable.finishedJob(order);
+    int waitTime = job.endTime - job.startTime - (job.serviceTime - job.remainingTime);
+    recordJobDetails(job, job.endTime, waitTime, (long long)job.getPriority() * waitTime);
+  }
+  jobTable.clearFinished();
+}
+
+
+/** dispatch job
+ * Simulate the dispatcher taking the front job off of the job queue
+ * and starting to execute it at the given time.  The job stops
+ * waiting, so its wait time and cost are added to the results.
+ *
+ * @param jobQueue The job queue of the system being simulated.  It
+ *   must not be empty.
+ * @param time The current simulation time, when the job starts running.
+ *
+ * @returns int The service time of the dispatched job, the processor
+ *   will be busy for this many steps.
+ */
+template <class JobQueue>
+int JobSchedulerSimulator::dispatchJob(JobQueue& jobQueue, int time)
+{
+  typedef typename JobQueue::value_type QueuedJob;
+  return dequeueJob(jobQueue, time, (QueuedJob*)NULL);
+}
+
+
+/** dequeue job
+ * Take the front job off of a queue of Jobs, see dispatchJob().
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param time The current simulation time, when the job starts running.
+ * @param jobs Not used, selects this overload for queues of Job.
+ *
+ * @returns int The service time of the dispatched job.
+ */
+template <class JobQueue>
+int JobSchedulerSimulator::dequeueJob(JobQueue& jobQueue, int time, Job* /* jobs */)
+{
+  // the job stops waiting now, its end time would be set to time, we
+  // work the wait time out directly rather than copying the job
+  const Job& job = QueueDispatch<JobQueue>::front(jobQueue);
+  int serviceTime = job.getServiceTime();
+  recordJob(job, time);
+
+  QueueDispatch<JobQueue>::dequeue(jobQueue);
+  return serviceTime;
+}
+
+
+/** dequeue job (job table)
+ * Take the front job index off of a queue of job indexes, see
+ * dispatchJob().  The job is moved to the job table's finished columns
+ * with the time as its end time, freeing its row for the next arrival,
+ * and its results are recorded with the rest of its block of finished
+ * jobs, see recordTableJobs().
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param time The current simulation time, when the job starts running.
+ * @param jobs Not used, selects this overload for queues of JobIndex.
+ *
+ * @returns int The service time of the dispatched job.
+ */
+template <class JobQueue>
+int JobSchedulerSimulator::dequeueJob(JobQueue& jobQueue, int time, JobIndex* /* jobs */)
+{
+  JobIndex index = QueueDispatch<JobQueue>::front(jobQueue);
+  QueueDispatch<JobQueue>::dequeue(jobQueue);
+
+  int serviceTime = jobTable.serviceTime(index);
+  jobTable.finish(index, time);
+  if (jobTable.numFinished() == JobTable::finishedCapacity)
+  {
+    recordTableJobs();
+  }
+  return serviceTime;
+}
+
+
+/** take job
+ * Take the front job off of a queue of Jobs.
+ *
+ * @param jobQueue The job queue of the system being simulated.  It
+ *   must not be empty.
+ * @param jobs Not used, selects this overload for queues of Job.
+ *
+ * @returns Job The front job.
+ */
+template <class JobQueue>
+Job JobSchedulerSimulator::takeJob(JobQueue& jobQueue, Job* /* jobs */)
+{
+  Job job = QueueDispatch<JobQueue>::front(jobQueue);
+  QueueDispatch<JobQueue>::dequeue(jobQueue);
+  return job;
+}
+
+
+/** take job (job table)
+ * Take the front job index off of a queue of job indexes, and the job
+ * out of the job table, freeing its row.
+ *
+ * @param jobQueue The job queue of the system being simulated.  It
+ *   must not be empty.
+ * @param jobs Not used, selects this overload for queues of JobIndex.
+ *
+ * @returns Job The front job, made from its row of the table.
+ */
+template <class JobQueue>
+Job JobSchedulerSimulator::takeJob(JobQueue& jobQueue, JobIndex* /* jobs */)
+{
+  JobIndex index = QueueDispatch<JobQueue>::front(jobQueue);
+  QueueDispatch<JobQueue>::dequeue(jobQueue);
+
+  Job job = jobTable.job(index);
+  jobTable.remove(index);
+  return job;
+}
+
+
+/** requeue job
+ * Put a preempted job back on a queue of Jobs.
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param job The preempted job, with the service it still needs.
+ * @param jobs Not used, selects this overload for queues of Job.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::requeueJob(JobQueue& jobQueue, Job& job, Job* /* jobs */)
+{
+  QueueDispatch<JobQueue>::emplace(jobQueue, std::move(job));
+}
+
+
+/** requeue job (job table)
+ * Put a preempted job back in the job table, keeping its id and the
+ * service it still needs, and its index on a queue of job indexes.
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param job The preempted job, with the service it still needs.
+ * @param jobs Not used, selects this overload for queues of JobIndex.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::requeueJob(JobQueue& jobQueue, Job& job, JobIndex* /* jobs */)
+{
+  QueueDispatch<JobQueue>::emplace(jobQueue, jobTable.add(job));
+}
+
+
+/** waiting job
+ * @param job A job on a queue of Jobs.
+ *
+ * @returns Job The job itself.
+ */
+const Job& JobSchedulerSimulator::waitingJob(const Job& job) const
+{
+  return job;
+}
+
+
+/** waiting job (job table)
+ * @param index A job index on a queue of job indexes.
+ *
+ * @returns Job The job, made from its row of the job table.
+ */
+Job JobSchedulerSimulator::waitingJob(JobIndex index) const
+{
+  return jobTable.job(index);
+}
+
+
+/** start job
+ * Simulate the preemptive dispatcher taking the front job off of the job
+ * queue and running it on an idle server.  The job may yet be preempted,
+ * so its results are not recorded until it finishes, see finishJobs().
+ *
+ * @param jobQueue The job queue of the system being simulated.  It
+ *   must not be empty, and a server must be idle.
+ * @param runningJobs The running jobs, in preemption order.
+ * @param time The current simulation time, when the job starts running.
+ */
+template <class JobQueue, class RunningJobs>
+void JobSchedulerSimulator::startJob(JobQueue& jobQueue, RunningJobs& runningJobs, int time)
+{
+  typedef typename JobQueue::value_type QueuedJob;
+  Job job = takeJob(jobQueue, (QueuedJob*)NULL);
+
+  job.setEndTime(time);
+  int server = servers.start(time, job.remainingTime, simulationTime);
+  runningJobs.emplace(server, job);
+}
+
+
+/** preempt job
+ * Stop the running job at the front of the preemption order, start the
+ * front job of the job queue on its server in its place, and put the
+ * stopped job back on the job queue with the service it still needs.
+ * The stopped job keeps its id, so it resumes ahead of jobs that the
+ * queue's order can not tell apart from it that arrived after it.
+ *
+ * @param jobQueue The job queue of the system being simulated.  It
+ *   must not be empty.
+ * @param runningJobs The running jobs, in preemption order.
+ * @param time The current simulation time, when the job is preempted.
+ */
+template <class JobQueue, class RunningJobs>
+void JobSchedulerSimulator::preemptJob(JobQueue& jobQueue, RunningJobs& runningJobs, int time)
+{
+  typedef typename JobQueue::value_type QueuedJob;
+  int server = runningJobs.front().server;
+  Job job = runningJobs.front().job;
+  runningJobs.dequeue();
+
+  job.remainingTime = servers.preempt(server, time, simulationTime);
+  numPreemptions++;
+  priorityClasses[job.priority - minPriority].numPreempted++;
+
+  // the preempted server is on top of the idle stack, so it runs the
+  // waiting job, which is taken off the queue before the stopped job
+  // goes back on
+  startJob(jobQueue, runningJobs, time);
+  requeueJob(jobQueue, job, (QueuedJob*)NULL);
+}
+
+
+/** complete job
+ * A running job of a simulation on a queue of Jobs is done waiting, so
+ * its results are recorded.
+ *
+ * @param job The job, with the service it still needed when it last
+ *   started.
+ * @param time The time the job last started running.
+ * @param jobs Not used, selects this overload for queues of Job.
+ */
+void JobSchedulerSimulator::completeJob(const Job& job, int time, Job* /* jobs */)
+{
+  recordJob(job, time);
+}
+
+
+/** complete job (job table)
+ * A running job of a simulation on a queue of job indexes is done
+ * waiting, so it is added to the job table's finished columns, whose
+ * results are recorded a block at a time, see recordTableJobs().
+ *
+ * @param job The job, with the service it still needed when it last
+ *   started.
+ * @param time The time the job last started running.
+ * @param jobs Not used, selects this overload for queues of JobIndex.
+ */
+void JobSchedulerSimulator::completeJob(const Job& job, int time, JobIndex* /* jobs */)
+{
+  jobTable.finish(job, time);
+  if (jobTable.numFinished() == JobTable::finishedCapacity)
+  {
+    recordTableJobs();
+  }
+}
+
+
+/** finish jobs
+ * Free the servers whose jobs have finished by the given time, the jobs
+ * are done waiting, so their results are recorded.
+ *
+ * @param runningJobs The running jobs, in preemption order.
+ * @param time The current simulation time.
+ * @param jobs Not used, the type of the items of the job queue, selects
+ *   how the jobs are recorded, see completeJob().
+ */
+template <class RunningJobs, class QueuedJob>
+void JobSchedulerSimulator::finishJobs(RunningJobs& runningJobs, long long time,
+				       QueuedJob* jobs)
+{
+  int server;
+  while ((server = servers.releaseNext(time)) >= 0)
+  {
+    const Job& job = runningJobs.find(server).job;
+    completeJob(job, job.endTime, jobs);
+    runningJobs.remove(server);
+  }
+}
+
+
+/** finish results
+ * Calculate the final statistics once a simulation run has ended.
+ *
+ * @param numJobsUnfinished The number of jobs still waiting on the
+ *   job queue when the simulation ended.
+ */
+void JobSchedulerSimulator::finishResults(int numJobsUnfinished)
+{
+  recordTableJobs();
+  this->numJobsUnfinished = numJobsUnfinished;
+  if (numJobsCompleted > 0)
+  {
+    averageWaitTime = double(totalWaitTime) / double(numJobsCompleted);
+    averageCost = double(totalCost) / double(numJobsCompleted);
+  }
+
+  long long totalBusyTime = 0;
+  for (int server = 0; server < numServers; server++)
+  {
+    totalBusyTime += servers.serverBusyTime(server);
+  }
+  if (simulationTime > 0)
+  {
+    averageUtilization = double(totalBusyTime) / (double(simulationTime) * numServers);
+  }
+}
+
+
+/** run simulation
+ * Run a simulation of the system using the given job queue, which
+ * determines the queueing discipline of the simulated system (e.g. a
+ * LQueue gives first come first served, a HeapPriorityQueue gives
+ * priority based dispatching).  The results of the run are available
+ * afterwards from summaryResultString() and csvResultString().
+ *
+ * The simulation loop is instantiated for the type of the given queue,
+ * so when a concrete queue (e.g. HeapPriorityQueue<Job>) is passed the
+ * queue operations of the inner loop are called directly, without
+ * virtual calls, see QueueDispatch.  A concrete queue of Job whose order
+ * is known at compile time is run on the same kind of queue of job
+ * indexes (JobIndex), with the waiting jobs in the simulator's job table
+ * (see JobIndexQueue and getJobTable()), and the jobs still waiting at
+ * the end are put back on the given queue.  A queue of job indexes can
+ * also be passed directly.  Passing a Queue<Job> reference works for any
+ * queue, through virtual calls, on the Job objects.
+ *
+ * The stepped mode visits every discrete time step from 1 to
+ * simulationTime, checking for an arrival, and dispatching the front
+ * job whenever a server is idle.  The event driven mode simulates
+ * exactly the same system, but jumps directly from one arrival or
+ * dispatch to the next, drawing the geometric gap between arrivals
+ * rather than testing each step.  Both modes produce the same
+ * distribution of results, though not the same random sequence, and the
+ * event driven mode takes time proportional to the number of jobs
+ * instead of the number of steps.  A preemptive simulation (see
+ * setPreemptive()) is always event driven.  The run is checkpointed if
+ * the simulator has been asked to, see setCheckpoint().
+ *
+ * @param jobQueue The (empty) job queue to use for the simulation.
+ * @param description A description of the dispatching/queueing method.
+ * @param eventDriven Use the event driven mode if true, otherwise
+ *   step through every time step.
+ *
+ * @throws SnapshotException If a preemptive simulation is to be
+ *   checkpointed, or a checkpoint can not be written.
+ * @throws PreemptionException If a preemptive simulation is given a
+ *   job queue whose order is not known, see QueueJobOrder.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::runSimulation(JobQueue& jobQueue, string description,
+					  bool eventDriven)
+{
+  JobIndexQueue<JobQueue> indexQueue(jobQueue, &jobTable);
+  simulate(indexQueue.queue(), description, eventDriven);
+  indexQueue.returnWaitingJobs(jobTable);
+}
+
+
+/** simulate
+ * Run a simulation on the queue it is to run on, see runSimulation().
+ *
+ * @param jobQueue The (empty) job queue to run the simulation on.
+ * @param description A description of the dispatching/queueing method.
+ * @param eventDriven Use the event driven mode if true, otherwise
+ *   step through every time step.
+ *
+ * @throws SnapshotException See runSimulation().
+ * @throws PreemptionException See runSimulation().
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::simulate(JobQueue& jobQueue, string description,
+				     bool eventDriven)
+{
+  if (preemptive && checkpointInterval > 0)
+  {
+    throw SnapshotException("can not be taken of a preemptive simulation");
+  }
+  resetResults(description);
+  QueueDispatch<JobQueue>::clear(jobQueue);
+
+  if (preemptive)
+  {
+    runPreemptive(jobQueue, NULL);
+  }
+  else if (eventDriven)
+  {
+    runEventDriven(jobQueue, NULL, 1, nextArrivalGap());
+  }
+  else
+  {
+    runStepped(jobQueue, 1, randomBlocks.arrivalSteps(simulationTime));
+  }
+
+  finishResults(QueueDispatch<JobQueue>::length(jobQueue));
+}
+
+
+/** run trace replay
+ * Run a simulation of the system using the given job queue, like
+ * runSimulation(), but with the arrivals, priorities and service times
+ * of the jobs replayed from a recorded trace rather than generated at
+ * random.  The replay is event driven, so it takes time proportional to
+ * the number of arrivals, and the trace is read as the simulation goes,
+ * never all loaded into memory.  Arrivals after simulationTime are not
+ * replayed, and the simulation parameters for generating jobs
+ * (jobArrivalProbability, serviceTime range) are not used, but every
+ * replayed priority must be in [minPriority, maxPriority].  Trace
+ * replays are not checkpointed, the trace itself can be replayed again.
+ *
+ * @param jobQueue The (empty) job queue to use for the simulation.
+ * @param trace The trace to replay, from its first arrival.
+ * @param description A description of the dispatching/queueing method.
+ *
+ * @throws SnapshotException If the simulator is set to checkpoint runs.
+ * @throws PreemptionException If a preemptive simulation is given a
+ *   job queue whose order is not known, see QueueJobOrder.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::runTraceReplay(JobQueue& jobQueue, ArrivalTrace& trace,
+					   string description)
+{
+  JobIndexQueue<JobQueue> indexQueue(jobQueue, &jobTable);
+  replayTrace(indexQueue.queue(), trace, description);
+  indexQueue.returnWaitingJobs(jobTable);
+}
+
+
+/** replay trace
+ * Run a trace replay on the queue it is to run on, see runTraceReplay().
+ *
+ * @param jobQueue The (empty) job queue to run the simulation on.
+ * @param trace The trace to replay, from its first arrival.
+ * @param description A description of the dispatching/queueing method.
+ *
+ * @throws SnapshotException See runTraceReplay().
+ * @throws PreemptionException See runTraceReplay().
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::replayTrace(JobQueue& jobQueue, ArrivalTrace& trace,
+					string description)
+{
+  if (checkpointInterval > 0)
+  {
+    throw SnapshotException("can not be taken of a trace replay");
+  }
+  resetResults(description);
+  QueueDispatch<JobQueue>::clear(jobQueue);
+
+  trace.rewind();
+  if (preemptive)
+  {
+    runPreemptive(jobQueue, &trace);
+  }
+  else
+  {
+    runEventDriven(jobQueue, &trace, 1, nextReplayedArrival(trace, 1));
+  }
+
+  finishResults(QueueDispatch<JobQueue>::length(jobQueue));
+}
+
+
+/** run stepped
+ * The stepped simulation loop, see runSimulation().  A job dispatched
+ * at time t keeps its server busy until time t + serviceTime, when
+ * the server can be given the next job.  Each step, after checking for
+ * an arrival, the servers that have become free are released and every
+ * idle server is given a waiting job.  The arrival tests are taken from
+ * the block generator up to the next arrival at a time (see
+ * RandomBlockGenerator::arrivalSteps()), which gives the same arrivals
+ * as testing each step with jobArrived().
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param startTime The first time step to simulate, 1 for a new run.
+ * @param nextArrival The time step of the next arrival.
+ *
+ * @throws SnapshotException If a checkpoint can not be written.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::runStepped(JobQueue& jobQueue, int startTime,
+				       long long nextArrival)
+{
+  long long nextCheckpoint = nextCheckpointTime(startTime);
+  for (int time = startTime; time <= simulationTime; time++)
+  {
+    if (time > nextCheckpoint)
+    {
+      if (writeCheckpoint(jobQueue, false, time, nextArrival, nextCheckpoint))
+      {
+	return;
+      }
+      nextCheckpoint = nextCheckpointTime(time);
+    }
+
+    if (time == nextArrival)
+    {
+      jobArrives(jobQueue, time);
+      nextArrival = time + randomBlocks.arrivalSteps(simulationTime - time);
+    }
+
+    if (servers.nextFreeTime() <= time)
+    {
+      servers.release(time);
+    }
+    while (servers.hasIdleServer() && !QueueDispatch<JobQueue>::isEmpty(jobQueue))
+    {
+      servers.start(time, dispatchJob(jobQueue, time), simulationTime);
+    }
+  }
+}
+
+
+/** run event driven
+ * The event driven simulation loop, see runSimulation().  There are
+ * only two kinds of events, the next arrival and the next dispatch
+ * (which happens as soon as a server is free and a job is waiting).
+ * An arrival at the same time as a dispatch is handled first, just like
+ * the stepped loop checks for arrivals before dispatching, so the new
+ * job can be chosen by the dispatcher.
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param trace The trace to replay arrivals from, see runTraceReplay(),
+ *   or NULL to generate random arrivals.
+ * @param now The time the simulation starts from, 1 for a new run.
+ * @param nextArrival The time of the next arrival.
+ *
+ * @throws SnapshotException If a checkpoint can not be written.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::runEventDriven(JobQueue& jobQueue, ArrivalTrace* trace,
+					   long long now, long long nextArrival)
+{
+  long long nextCheckpoint = nextCheckpointTime(now);
+
+  while (true)
+  {
+    if (now > nextCheckpoint)
+    {
+      if (writeCheckpoint(jobQueue, true, now, nextArrival, nextCheckpoint))
+      {
+	return;
+      }
+      nextCheckpoint = nextCheckpointTime(now);
+    }
+
+    servers.release(now);
+    long long dispatchTime = servers.hasIdleServer() ? now : servers.nextFreeTime();
+    bool jobWaiting = !QueueDispatch<JobQueue>::isEmpty(jobQueue);
+
+    if (nextArrival <= simulationTime && (!jobWaiting || nextArrival <= dispatchTime))
+    {
+      now = nextArrival;
+      if (trace == NULL)
+      {
+	jobArrives(jobQueue, now);
+	nextArrival = now + nextArrivalGap();
+      }
+      else
+      {
+	addJob(jobQueue, now, trace->priority(), trace->serviceTime());
+	nextArrival = nextReplayedArrival(*trace, now);
+      }
+    }
+    else if (jobWaiting && dispatchTime <= simulationTime)
+    {
+      now = dispatchTime;
+      servers.release(now);
+      servers.start(now, dispatchJob(jobQueue, now), simulationTime);
+    }
+    else
+    {
+      break;
+    }
+  }
+}
+
+
+/** run preemptive
+ * The event driven simulation loop of a preemptive-resume system, see
+ * setPreemptive().  The events are arrivals and jobs finishing.  At each
+ * event time, after all of the arrivals at that time, finished jobs free
+ * their servers, waiting jobs are started on idle servers, and then as
+ * long as the front waiting job comes before a running job in the
+ * order of the job queue, the running job the queue would have
+ * dispatched last is preempted and put back on the queue to make way
+ * for the waiting one (see PreemptionOrder).  So a priority queue
+ * preempts for higher priority jobs, a shortest remaining time queue for
+ * jobs shorter than what a running job has left, and a FIFO queue never
+ * preempts.  Jobs still running when the simulation ends have stopped
+ * waiting, so their results are recorded then, while preempted jobs left
+ * on the queue count as unfinished.
+ *
+ * @param jobQueue The job queue of the system being simulated, a queue
+ *   of Job or of job indexes.
+ * @param trace The trace to replay arrivals from, see runTraceReplay(),
+ *   or NULL to generate random arrivals.
+ *
+ * @throws PreemptionException If the order of the job queue is not
+ *   known at compile time, see QueueJobOrder.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::runPreemptive(JobQueue& jobQueue, ArrivalTrace* trace)
+{
+  if (!QueueJobOrder<JobQueue>::known)
+  {
+    throw PreemptionException("needs a job queue whose order is known, such as a HeapPriorityQueue");
+  }
+
+  typedef typename JobQueue::value_type QueuedJob;
+  typedef PreemptionOrder<typename QueueJobOrder<JobQueue>::type> Preemption;
+  IndexedHeapPriorityQueue<RunningJob, Preemption, ServerKey> runningJobs;
+  long long now = 1;
+  long long nextArrival = (trace == NULL) ? nextArrivalGap() : nextReplayedArrival(*trace, 1);
+
+  while (true)
+  {
+    if (nextArrival <= now)
+    {
+      if (trace == NULL)
+      {
+	jobArrives(jobQueue, now);
+	nextArrival = now + nextArrivalGap();
+      }
+      else
+      {
+	addJob(jobQueue, now, trace->priority(), trace->serviceTime());
+	nextArrival = nextReplayedArrival(*trace, now);
+      }
+      continue;
+    }
+
+    finishJobs(runningJobs, now, (QueuedJob*)NULL);
+    while (!QueueDispatch<JobQueue>::isEmpty(jobQueue))
+    {
+      if (!servers.hasIdleServer())
+      {
+	const Job& waiting = waitingJob(QueueDispatch<JobQueue>::front(jobQueue));
+	if (!Preemption::preempts(waiting, runningJobs.front(), now))
+	{
+	  break;
+	}
+	preemptJob(jobQueue, runningJobs, now);
+      }
+      else
+      {
+	startJob(jobQueue, runningJobs, now);
+      }
+    }
+
+    long long nextEvent = servers.nextFreeTime();
+    if (nextArrival < nextEvent)
+    {
+      nextEvent = nextArrival;
+    }
+    if (nextEvent > simulationTime)
+    {
+      break;
+    }
+    now = nextEvent;
+  }
+
+  while (!runningJobs.isEmpty())
+  {
+    const Job& job = runningJobs.front().job;
+    completeJob(job, job.endTime, (QueuedJob*)NULL);
+    runningJobs.dequeue();
+  }
+}
+
+
+/** next checkpoint time
+ * @param time The time a run has got to.
+ *
+ * @returns long long The time of the first checkpoint at or after the
+ *   given time, see setCheckpoint(), or LLONG_MAX if runs are not
+ *   checkpointed.  A run writes the checkpoint for time t as soon as it
+ *   passes t.
+ */
+long long JobSchedulerSimulator::nextCheckpointTime(long long time) const
+{
+  if (checkpointInterval <= 0)
+  {
+    return LLONG_MAX;
+  }
+  return (time + checkpointInterval - 1) / checkpointInterval * checkpointInterval;
+}
+
+
+/** write checkpoint
+ * Write a snapshot of the state of the run, in the format described
+ * with simulationSnapshotMagic, to the checkpoint file.
+ *
+ * @param jobQueue The job queue of the system being simulated.
+ * @param eventDriven True if the run is event driven, false if stepped.
+ * @param now The time the run will carry on from, the next time step
+ *   or the time of the last event.
+ * @param nextArrival The time of the next arrival.
+ * @param time The time of the checkpoint.
+ *
+ * @returns bool True if the run should stop at this checkpoint, see
+ *   setCheckpoint().
+ *
+ * @throws SnapshotException If the checkpoint can not be written.
+ */
+template <class JobQueue>
+bool JobSchedulerSimulator::writeCheckpoint(const JobQueue& jobQueue, bool eventDriven,
+					    long long now, long long nextArrival,
+					    long long time)
+{
+  SnapshotWriter snapshot(checkpointFileName);
+  checkpointTime = time;
+  recordTableJobs();
+
+  // header and parameters
+  snapshot.write(simulationSnapshotMagic);
+  snapshot.write(simulationSnapshotVersion);
+  snapshot.write((int32_t)eventDriven);
+  snapshot.write((int32_t)simulationTime);
+  snapshot.write(jobArrivalProbability);
+  snapshot.write((int32_t)minPriority);
+  snapshot.write((int32_t)maxPriority);
+  snapshot.write((int32_t)minServiceTime);
+  snapshot.write((int32_t)maxServiceTime);
+  snapshot.write((int32_t)numServers);
+
+  // where the loop has got to
+  snapshot.write((int64_t)checkpointTime);
+  snapshot.write((int64_t)now);
+  snapshot.write((int64_t)nextArrival);
+
+  // the results so far
+  snapshot.write((int64_t)numJobsStarted);
+  snapshot.write((int64_t)numJobsCompleted);
+  snapshot.write((int64_t)totalWaitTime);
+  snapshot.write((int64_t)totalCost);
+  snapshot.write((int64_t)numPreemptions);
+  waitTimeHistogram.save(snapshot);
+  costHistogram.save(snapshot);
+  for (size_t priority = 0; priority < priorityClasses.size(); priority++)
+  {
+    priorityClasses[priority].save(snapshot);
+  }
+  servers.save(snapshot);
+
+  // the random numbers, the engine as text so that any engine that can
+  // be streamed can be used
+  ostringstream engine;
+  engine << generator;
+  snapshot.writeString(engine.str());
+  randomBlocks.save(snapshot);
+
+  // the jobs, only the waiting ones, the others are in the results
+  snapshot.write((int32_t)jobIdBlock.peek());
+  saveQueuedJobs(snapshot, jobQueue);
+
+  snapshot.commit();
+  return stopAtCheckpoint;
+}
+
+
+/** save queued jobs (queue of Job)
+ * Write the jobs waiting on a job queue to a snapshot, front first.
+ *
+ * @param snapshot The snapshot being written.
+ * @param jobQueue The job queue of the system being simulated.
+ */
+void JobSchedulerSimulator::saveQueuedJobs(SnapshotWriter& snapshot,
+					   const Queue<Job>& jobQueue)
+{
+  snapshot.writeVector(vector<Job>(jobQueue.begin(), jobQueue.end()));
+}
+
+
+/** save queued jobs (queue of JobIndex)
+ * Write the jobs of the indexes waiting on a job queue to a snapshot,
+ * front first, as Jobs, so the snapshot is the same as that of a queue
+ * of Job and does not depend on the rows of the job table.
+ *
+ * @param snapshot The snapshot being written.
+ * @param jobQueue The job queue of the system being simulated.
+ */
+void JobSchedulerSimulator::saveQueuedJobs(SnapshotWriter& snapshot,
+					   const Queue<JobIndex>& jobQueue)
+{
+  vector<Job> queuedJobs;
+  queuedJobs.reserve(jobQueue.length());
+  for (Queue<JobIndex>::const_iterator index = jobQueue.begin(); index != jobQueue.end(); ++index)
+  {
+    queuedJobs.push_back(jobTable.job(*index));
+  }
+  snapshot.writeVector(queuedJobs);
+}
+
+
+/** restore queued jobs (queue of Job)
+ * Put the jobs read from a snapshot back on a job queue.  They are
+ * enqueued front first, so any queue whose order depends only on the
+ * jobs, and not on when they were enqueued relative to each other other
+ * than by their id, dequeues them in the same order as the queue they
+ * were saved from.
+ *
+ * @param snapshot The snapshot being read.
+ * @param jobQueue The (empty) job queue of the system being simulated.
+ * @param jobs Not used, selects this overload for queues of Job.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::restoreQueuedJobs(SnapshotReader& snapshot,
+					      JobQueue& jobQueue, Job* /* jobs */)
+{
+  vector<Job> queuedJobs;
+  snapshot.readVector(queuedJobs);
+  for (size_t index = 0; index < queuedJobs.size(); index++)
+  {
+    QueueDispatch<JobQueue>::emplace(jobQueue, queuedJobs[index]);
+  }
+}
+
+
+/** restore queued jobs (queue of JobIndex)
+ * Add the jobs read from a snapshot to the job table, and put their
+ * indexes on a job queue, see restoreQueuedJobs() for a queue of Job.
+ *
+ * @param snapshot The snapshot being read.
+ * @param jobQueue The (empty) job queue of the system being simulated.
+ * @param jobs Not used, selects this overload for queues of JobIndex.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::restoreQueuedJobs(SnapshotReader& snapshot,
+					      JobQueue& jobQueue, JobIndex* /* jobs */)
+{
+  vector<Job> queuedJobs;
+  snapshot.readVector(queuedJobs);
+  jobTable.reserve(queuedJobs.size());
+  for (size_t index = 0; index < queuedJobs.size(); index++)
+  {
+    QueueDispatch<JobQueue>::emplace(jobQueue, jobTable.add(queuedJobs[index]));
+  }
+}
+
+
+/** continue simulation
+ * Restore the state of a run from a snapshot, see writeCheckpoint(), and
+ * run it on to the end of the simulation, see resumeSimulation() and
+ * forkSimulation().
+ *
+ * @param jobQueue The (empty) job queue to use for the rest of the run.
+ * @param fileName The snapshot file to resume from.
+ * @param description A description of the dispatching/queueing method.
+ * @param forkSeed If not NULL, the random numbers of the rest of the run
+ *   are drawn from this seed instead of carrying on from the snapshot.
+ *
+ * @throws SnapshotException If the snapshot can not be read, is not a
+ *   snapshot of a run of this kind of simulator, or a checkpoint of the
+ *   rest of the run can not be written.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::continueSimulation(JobQueue& jobQueue, string fileName,
+					       string description,
+					       const unsigned long long* forkSeed)
+{
+  typedef typename JobQueue::value_type QueuedJob;
+  bool eventDriven;
+  long long now;
+  long long nextArrival;
+
+  {
+    SnapshotReader snapshot(fileName);
+
+    // header and parameters, which fix the shape of the state
+    char magic[sizeof(simulationSnapshotMagic)];
+    snapshot.read(magic);
+    if (!equal(magic, magic + sizeof(magic), simulationSnapshotMagic))
+    {
+      throw SnapshotException(fileName + " is not a simulation snapshot");
+    }
+    if (snapshot.read<uint32_t>() != simulationSnapshotVersion)
+    {
+      throw SnapshotException(fileName + " is of an unknown version");
+    }
+    eventDriven = snapshot.read<int32_t>() != 0;
+
+    int savedSimulationTime = snapshot.read<int32_t>();
+    double savedArrivalProbability = snapshot.read<double>();
+    int savedMinPriority = snapshot.read<int32_t>();
+    int savedMaxPriority = snapshot.read<int32_t>();
+    int savedMinServiceTime = snapshot.read<int32_t>();
+    int savedMaxServiceTime = snapshot.read<int32_t>();
+    int savedNumServers = snapshot.read<int32_t>();
+    if (preemptive || savedSimulationTime != simulationTime ||
+	savedMinPriority != minPriority || savedMaxPriority != maxPriority ||
+	savedNumServers != numServers || savedMaxServiceTime > maxServiceTime)
+    {
+      throw SnapshotException(fileName + " is of a run of a different system");
+    }
+
+    resetResults(description);
+    QueueDispatch<JobQueue>::clear(jobQueue);
+
+    // where the loop had got to
+    int savedCheckpointTime = snapshot.read<int64_t>();
+    now = snapshot.read<int64_t>();
+    nextArrival = snapshot.read<int64_t>();
+
+    // the results so far
+    numJobsStarted = snapshot.read<int64_t>();
+    numJobsCompleted = snapshot.read<int64_t>();
+    totalWaitTime = snapshot.read<int64_t>();
+    totalCost = snapshot.read<int64_t>();
+    numPreemptions = snapshot.read<int64_t>();
+    waitTimeHistogram.restore(snapshot);
+    costHistogram.restore(snapshot);
+    for (size_t priority = 0; priority < priorityClasses.size(); priority++)
+    {
+      priorityClasses[priority].restore(snapshot);
+    }
+    servers.restore(snapshot, maxServiceTime);
+    if (servers.numServers() != numServers)
+    {
+      throw SnapshotException("servers are corrupt");
+    }
+
+    // the random numbers, from where they had got to or a new seed
+    istringstream engine(snapshot.readString());
+    if (!(engine >> generator))
+    {
+      throw SnapshotException("random engine is corrupt");
+    }
+    randomBlocks.restore(snapshot);
+    if (forkSeed != NULL)
+    {
+      generator.seed(*forkSeed);
+      randomBlocks.seedFrom(generator);
+    }
+    if (savedArrivalProbability != jobArrivalProbability)
+    {
+      randomBlocks.setArrivalProbability(-expm1(-jobArrivalProbability));
+    }
+    if (savedMinServiceTime != minServiceTime || savedMaxServiceTime != maxServiceTime)
+    {
+      randomBlocks.setServiceTimeRange(minServiceTime, maxServiceTime);
+    }
+
+    // the jobs, whose ids carry on from where they had got to
+    int nextId = snapshot.read<int32_t>();
+    if (nextId < 1)
+    {
+      throw SnapshotException("job ids are corrupt");
+    }
+    jobIds.reset();
+    if (nextId > 1)
+    {
+      jobIds.reserve(nextId - 1);
+    }
+    jobIdBlock = JobIdBlock(jobIds);
+    restoreQueuedJobs(snapshot, jobQueue, (QueuedJob*)NULL);
+    checkpointTime = savedCheckpointTime;
+  }
+
+  if (eventDriven)
+  {
+    runEventDriven(jobQueue, NULL, now, nextArrival);
+  }
+  else
+  {
+    runStepped(jobQueue, now, nextArrival);
+  }
+
+  finishResults(QueueDispatch<JobQueue>::length(jobQueue));
+}
+
+
+/** resume simulation
+ * Resume a run from a checkpoint written by runSimulation(), see
+ * setCheckpoint(), and run it on to the end.  The state of the run is
+ * restored exactly, down to the random numbers, so when the simulator
+ * has the same parameters and the job queue has the same discipline as
+ * the run that was checkpointed, the resumed run has the same results
+ * as the run would have had if it had never stopped.  The run is
+ * checkpointed again if the simulator is set to.  A checkpoint keeps
+ * only the jobs still waiting, so a trace writer records the jobs that
+ * stop waiting in the resumed part of the run, with either kind of job
+ * queue, and the jobs before the checkpoint are only in the trace of
+ * the checkpointed run, if it had one.
+ *
+ * The simulator must have the same simulation time, priority range and
+ * number of servers as the one that wrote the checkpoint, and a service
+ * time range that is no longer, but the arrival probability and the
+ * service time range may otherwise differ, to see how a system that has
+ * already warmed up copes with a change.
+ *
+ * @param jobQueue The job queue to use for the rest of the run, a
+ *   queue of Job or of job indexes (JobIndex), either of which can
+ *   carry on from a run with the other.
+ * @param fileName The checkpoint file to resume from.
+ * @param description A description of the dispatching/queueing method.
+ *
+ * @throws SnapshotException If the checkpoint can not be resumed by
+ *   this simulator, or the simulator is preemptive.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::resumeSimulation(JobQueue& jobQueue, string fileName,
+					     string description)
+{
+  JobIndexQueue<JobQueue> indexQueue(jobQueue, &jobTable);
+  continueSimulation(indexQueue.queue(), fileName, description, NULL);
+  indexQueue.returnWaitingJobs(jobTable);
+}
+
+
+/** fork simulation
+ * Resume a run from a checkpoint, like resumeSimulation(), but draw the
+ * random numbers of the rest of the run from a new seed, so several
+ * different continuations can be forked from one warmed up checkpoint.
+ * A fork can also use a job queue of a different discipline than the
+ * checkpointed run, to compare disciplines from the same starting state.
+ * Forks with the same seed, queue and parameters have the same results.
+ *
+ * @param jobQueue The job queue to use for the rest of the run, a
+ *   queue of Job or of job indexes (JobIndex), either of which can
+ *   carry on from a run with the other.
+ * @param fileName The checkpoint file to fork from.
+ * @param description A description of the dispatching/queueing method.
+ * @param seed The seed of the random numbers of the rest of the run.
+ *
+ * @throws SnapshotException If the checkpoint can not be resumed by
+ *   this simulator, or the simulator is preemptive.
+ */
+template <class JobQueue>
+void JobSchedulerSimulator::forkSimulation(JobQueue& jobQueue, string fileName,
+					   string description, unsigned long long seed)
+{
+  JobIndexQueue<JobQueue> indexQueue(jobQueue, &jobTable);
+  continueSimulation(indexQueue.queue(), fileName, description, &seed);
+  indexQueue.returnWaitingJobs(jobTable);
+}
+
 
 /** summary results
  * Convenience methods for creating a string for display listing
@@ -428,7 +1844,9 @@ string JobSchedulerSimulator::summaryResultString()
       << "Simulation Time          : " << simulationTime << endl
       << "Job Arrival Probability  : " << jobArrivalProbability << endl
       << "Priority (min,max)       : (" << minPriority << ", " << maxPriority << ")" << endl
-      << "Service Time (min,max)   : (" << minServiceTime << ", " << maxServiceTime << ")" << endl << endl
+      << "Service Time (min,max)   : (" << minServiceTime << ", " << maxServiceTime << ")" << endl
+      << "Number of servers        : " << numServers << endl
+      << "Preemptive               : " << (preemptive ? "yes" : "no") << endl << endl
       << "Simulation Results" << endl
       << "--------------------------" << endl
       << "Number of jobs started   : " << numJobsStarted << endl
@@ -438,7 +1856,29 @@ string JobSchedulerSimulator::summaryResultString()
       << "Total Cost               : " << totalCost << endl
       << "Average Wait Time        : " << setprecision(4) << fixed << averageWaitTime << endl
       << "Average Cost             : " << setprecision(4) << fixed << averageCost << endl
-      << endl << endl;
+      << "Wait Time percentiles    : " << waitTimeHistogram.percentileString() << endl
+      << "Cost percentiles         : " << costHistogram.percentileString() << endl
+      << "Average Utilization      : " << setprecision(4) << fixed << averageUtilization << endl
+      << "Number of preemptions    : " << numPreemptions << endl
+      << endl
+      << "Results by Priority" << endl
+      << "--------------------------" << endl
+      << "Priority  Completed  Wait (mean, sd)       Cost (mean, sd)       Unfinished  Preempted" << endl;
+
+  for (int priority = maxPriority; priority >= minPriority; priority--)
+  {
+    const PriorityClassStatistics& priorityClass = priorityClasses[priority - minPriority];
+    out << setw(8) << priority
+	<< setw(11) << priorityClass.waitTime.length()
+	<< setprecision(2) << fixed
+	<< "  (" << setw(8) << priorityClass.waitTime.getMean()
+	<< ", " << setw(8) << priorityClass.waitTime.standardDeviation() << ")"
+	<< "  (" << setw(8) << priorityClass.cost.getMean()
+	<< ", " << setw(8) << priorityClass.cost.standardDeviation() << ")"
+	<< setw(12) << priorityClass.numWaiting
+	<< setw(11) << priorityClass.numPreempted << endl;
+  }
+  out << endl << endl;
 
     return out.str();
 }
@@ -462,11 +1902,213 @@ string JobSchedulerSimulator::csvResultString()
       << totalWaitTime << ","
       << totalCost << ","
       << setprecision(4) << fixed << averageWaitTime << ","
-      << setprecision(4) << fixed << averageCost << endl;
+      << setprecision(4) << fixed << averageCost << ","
+      << setprecision(4) << fixed << averageUtilization << ","
+      << numPreemptions;
+
+  const double percents[] = {50.0, 90.0, 99.0, 99.9};
+  const LogHistogram* histograms[] = {&waitTimeHistogram, &costHistogram};
+  for (int histogram = 0; histogram < 2; histogram++)
+  {
+    for (int percent = 0; percent < 4; percent++)
+    {
+      out << "," << histograms[histogram]->percentile(percents[percent]);
+    }
+    out << "," << histograms[histogram]->max();
+  }
+
+  for (int priority = minPriority; priority <= maxPriority; priority++)
+  {
+    const PriorityClassStatistics& priorityClass = priorityClasses[priority - minPriority];
+    out << "," << priorityClass.waitTime.length()
+	<< "," << setprecision(4) << fixed << priorityClass.waitTime.getMean()
+	<< "," << setprecision(4) << fixed << priorityClass.waitTime.variance()
+	<< "," << setprecision(4) << fixed << priorityClass.cost.getMean()
+	<< "," << setprecision(4) << fixed << priorityClass.cost.variance()
+	<< "," << priorityClass.numWaiting
+	<< "," << priorityClass.numPreempted;
+  }
+  out << endl;
   return out.str();
 }
 
 
+/** csv header
+ * The names of the columns of csvResultString(), as a csv header line.
+ * The results of each priority level are a group of seven columns, from
+ * minPriority up to maxPriority.  Groups are named by class number, the
+ * priority less minPriority, so simulations with different priority
+ * ranges of the same size have the same columns.
+ *
+ * @returns string The csv header line.
+ */
+string JobSchedulerSimulator::csvHeaderString() const
+{
+  ostringstream out;
+  out << "numJobsStarted,numJobsCompleted,numJobsUnfinished,totalWaitTime,"
+      << "totalCost,averageWaitTime,averageCost,averageUtilization,numPreemptions,"
+      << "waitP50,waitP90,waitP99,waitP999,waitMax,"
+      << "costP50,costP90,costP99,costP999,costMax";
+  for (int priorityClass = 0; priorityClass <= maxPriority - minPriority; priorityClass++)
+  {
+    out << ",class" << priorityClass << "Completed"
+	<< ",class" << priorityClass << "MeanWait"
+	<< ",class" << priorityClass << "VarianceWait"
+	<< ",class" << priorityClass << "MeanCost"
+	<< ",class" << priorityClass << "VarianceCost"
+	<< ",class" << priorityClass << "Unfinished"
+	<< ",class" << priorityClass << "Preempted";
+  }
+  out << endl;
+  return out.str();
+}
+
+
+/** number of jobs started getter
+ * @returns int The number of jobs that arrived in the most recent run.
+ */
+int JobSchedulerSimulator::getNumJobsStarted() const
+{
+  return numJobsStarted;
+}
+
+
+/** number of jobs completed getter
+ * @returns int The number of jobs dispatched in the most recent run.
+ */
+int JobSchedulerSimulator::getNumJobsCompleted() const
+{
+  return numJobsCompleted;
+}
+
+
+/** average wait time getter
+ * @returns double The average wait time of completed jobs in the most
+ *   recent run.
+ */
+double JobSchedulerSimulator::getAverageWaitTime() const
+{
+  return averageWaitTime;
+}
+
+
+/** average cost getter
+ * @returns double The average cost of completed jobs in the most
+ *   recent run.
+ */
+double JobSchedulerSimulator::getAverageCost() const
+{
+  return averageCost;
+}
+
+
+/** wait time histogram getter
+ * @returns LogHistogram The distribution of the wait times of the jobs
+ *   completed in the most recent run.
+ */
+const LogHistogram& JobSchedulerSimulator::getWaitTimeHistogram() const
+{
+  return waitTimeHistogram;
+}
+
+
+/** cost histogram getter
+ * @returns LogHistogram The distribution of the costs of the jobs
+ *   completed in the most recent run.
+ */
+const LogHistogram& JobSchedulerSimulator::getCostHistogram() const
+{
+  return costHistogram;
+}
+
+
+/** priority class statistics getter
+ * @param priority A priority level in range [minPriority, maxPriority].
+ *
+ * @returns PriorityClassStatistics The wait time, cost and unfinished
+ *   statistics of the jobs of the priority in the most recent run.
+ */
+const PriorityClassStatistics& JobSchedulerSimulator::getPriorityClassStatistics(int priority) const
+{
+  return priorityClasses[priority - minPriority];
+}
+
+
+/** number of servers getter
+ * @returns int The number of servers of the simulated system.
+ */
+int JobSchedulerSimulator::getNumServers() const
+{
+  return numServers;
+}
+
+
+/** minimum priority getter
+ * @returns int The lowest priority of the simulated jobs.
+ */
+int JobSchedulerSimulator::getMinPriority() const
+{
+  return minPriority;
+}
+
+
+/** maximum priority getter
+ * @returns int The highest priority of the simulated jobs.
+ */
+int JobSchedulerSimulator::getMaxPriority() const
+{
+  return maxPriority;
+}
+
+
+/** server busy time getter
+ * @param server The server, in range [0, getNumServers()).
+ *
+ * @returns long long The number of time steps the server spent running
+ *   jobs in the most recent run.
+ */
+long long JobSchedulerSimulator::getServerBusyTime(int server) const
+{
+  return servers.serverBusyTime(server);
+}
+
+
+/** server utilization getter
+ * @param server The server, in range [0, getNumServers()).
+ *
+ * @returns double The fraction of the simulation time the server spent
+ *   running jobs in the most recent run.
+ */
+double JobSchedulerSimulator::getServerUtilization(int server) const
+{
+  if (simulationTime <= 0)
+  {
+    return 0.0;
+  }
+  return double(servers.serverBusyTime(server)) / double(simulationTime);
+}
+
+
+/** average utilization getter
+ * @returns double The utilization of the servers in the most recent run,
+ *   averaged over the servers.
+ */
+double JobSchedulerSimulator::getAverageUtilization() const
+{
+  return averageUtilization;
+}
+
+
+/** number of preemptions getter
+ * @returns long long The number of times a running job was preempted
+ *   in the most recent run, always 0 unless the simulator is preemptive.
+ */
+long long JobSchedulerSimulator::getNumPreemptions() const
+{
+  return numPreemptions;
+}
+
+
 /** overload output stream operator
  * Overload the output stream operator for convenience so we can
  * output a simulation object directly to an output stream.
@@ -485,8 +2127,3 @@ ostream& operator<<(ostream& out, JobSchedulerSimulator& sim)
   out << sim.summaryResultString();
   return out;
 }
-
-// Assignment 11
-// You need to add the implementation of your runSimulation()
-// method, as described in the assignment, here.
-
@@ -6,6 +6,20 @@
  */
 
 #include<iostream>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Queue.hpp"
+#include "ArrivalTrace.hpp"
+#include "Histogram.hpp"
+#include "Statistics.hpp"
+#include "TimingWheel.hpp"
+#include "JobTable.hpp"
+#include "JobTrace.hpp"
+#include "RandomGenerator.hpp"
+#include "Snapshot.hpp"
 using namespace std;
 #ifndef JOBSIMULATOR_HPP
 #define JOBSIMULATOR_HPP
@@ -27,13 +41,18 @@ using namespace std;
  * simple calculation of cost = priority * waitTime to calculate
  * the cost for a job once it completes.
  *
- * @var nextListId A static int variable, used to assign unique ids
- *   when processes are created, for identification purposes.
+ * @var nextListId A static id allocator, used to assign unique ids
+ *   when processes are created, for identification purposes.  It is
+ *   shared by all threads, see JobIdAllocator.
  * @var id The actual unique id assigned to a job object.
  * @var priority This jobs priority level.  Higher numbers mean higher
  *   priority jobs in this simulation.
  * @var serviceTime The amount of system time this job needs in order to
  *   complete its task.
+ * @var remainingTime The amount of service time the job still needs.
+ *   This is the whole serviceTime until the job is preempted (see
+ *   JobSchedulerSimulator::setPreemptive()), after which it is what
+ *   was left when the job last stopped running.
  * @var startTime The time when the job was created.  Also the time
  *   when the job began waiting in a queue to be selected to run.
  * @var endTime The time when the job finished waiting (when it was
@@ -44,6 +63,422 @@ using namespace std;
 
 
 
+/** simulator random engine
+ * The random number engine used by each simulator.  Any engine that
+ * returns uniform 64 bit values and can be seeded with seed(uint64_t)
+ * (e.g. mt19937_64) can be plugged in here instead.
+ */
+typedef Xoshiro256 SimulatorRandomEngine;
+
+
+/** simulation snapshot file format
+ * A checkpoint of a simulation run (see setCheckpoint()) is a snapshot
+ * file of the live state of the run, written with a SnapshotWriter.
+ * The jobs that have stopped waiting are only in the results, so the
+ * snapshot grows with the backlog of waiting jobs, not with the number
+ * of jobs of the run:
+ *
+ *   header: char magic[8] = "SIMSNAPS", uint32 version, int32
+ *     eventDriven
+ *   parameters: int32 simulationTime, double jobArrivalProbability,
+ *     int32 minPriority, maxPriority, minServiceTime, maxServiceTime,
+ *     numServers
+ *   loop: int64 checkpoint time, int64 time of the next step or event,
+ *     int64 time of the next arrival
+ *   results: int64 numJobsStarted, numJobsCompleted, totalWaitTime,
+ *     totalCost, numPreemptions, the histograms and the priority class
+ *     statistics so far
+ *   servers: see ServerPool::save()
+ *   random numbers: the engine, written with <<, and the block
+ *     generator, see RandomBlockGenerator::save()
+ *   jobs: int32 next job id, and the jobs waiting on the job queue as
+ *     Jobs, front first, for a queue of Job or of JobIndex alike
+ */
+const char simulationSnapshotMagic[8] = {'S', 'I', 'M', 'S', 'N', 'A', 'P', 'S'};
+const uint32_t simulationSnapshotVersion = 2;
+
+
+
+/** ServerPool
+ * The k servers (processors/executors) of a simulated system, all pulling
+ * jobs from the one shared job queue.  Idle servers are kept on a stack,
+ * and the completions of busy servers on a TimingWheel by the time they
+ * become free.  Service times are bounded, so with the wheel sized for
+ * the largest service time, finding an idle server or the next server to
+ * become free, and starting or finishing a job, are all O(1).  Nothing is
+ * done per idle server per time step, so a simulation with thousands of
+ * servers costs about the same per job as one with a single server.  A
+ * busy server that is preempted has its completion taken off the wheel.
+ *
+ * @var idleServers The servers that are free, most recently freed on top.
+ * @var completions The busy servers, due at the time they become free.
+ *   Servers that become free at the same time come off in server order.
+ * @var freeAt The time each busy server becomes free, -1 for idle
+ *   servers.
+ * @var busyTime The number of time steps (within the simulation) each
+ *   server has spent running jobs.
+ */
+class ServerPool
+{
+private:
+  vector<int> idleServers;
+  TimingWheel<int> completions;
+  vector<long long> freeAt;
+  vector<long long> busyTime;
+
+public:
+  ServerPool(int numServers = 1, int maxServiceTime = 1024); // constructor
+  void reset(int numServers, int maxServiceTime);
+  void release(long long time);
+  int releaseNext(long long time);
+  bool hasIdleServer() const;
+  long long nextFreeTime() const;
+  int start(long long time, int serviceTime, long long endOfTime);
+  int preempt(int server, long long time, long long endOfTime);
+  int numServers() const;
+  long long serverBusyTime(int server) const;
+  void save(SnapshotWriter& snapshot) const;
+  void restore(SnapshotReader& snapshot, int maxServiceTime);
+};
+
+
+
+/** RunningJob
+ * A job running on a server, as seen by the preemptive dispatcher.  The
+ * running jobs are kept in an IndexedHeapPriorityQueue addressed by
+ * server number (see ServerKey), as a server runs one job at a time, so
+ * the job of a server that finishes can be taken out of the queue
+ * wherever it is.
+ *
+ * @var server The server the job is running on.
+ * @var job The job.  Its endTime is the time it last started, and its
+ *   remainingTime the service it still needed then.
+ */
+struct RunningJob
+{
+  int server;
+  Job job;
+
+  RunningJob(int server = 0, const Job& job = Job())
+    : server(server), job(job)
+  {
+  }
+
+  /** remaining at
+   * @param time A time while the job is running.
+   *
+   * @returns Job The job as it is at that time, with the service it
+   *   still needs then as its remainingTime.
+   */
+  Job remainingAt(long long time) const
+  {
+    Job remaining = job;
+    remaining.remainingTime = (int)(job.endTime + job.remainingTime - time);
+    return remaining;
+  }
+};
+
+ostream& operator<<(ostream& out, const RunningJob& runningJob);
+
+
+/** server key
+ * The key policy that addresses running jobs by their server, see
+ * IndexedHeapPriorityQueue.
+ */
+struct ServerKey
+{
+  static int key(const RunningJob& runningJob)
+  {
+    return runningJob.server;
+  }
+};
+
+
+/** first come first served order
+ * The order a FIFO queue dispatches jobs in, by arrival, which is by
+ * job id.
+ */
+struct FirstComeFirstServedOrder
+{
+  static bool before(const Job& lhs, const Job& rhs)
+  {
+    return lhs.id < rhs.id;
+  }
+};
+
+
+/** priority level order
+ * The order of queues that dispatch by priority, and jobs of the same
+ * priority in the order they were enqueued (PriorityQueue and
+ * BucketPriorityQueue).  A preempted job goes back behind the jobs of
+ * its priority, so jobs of the same priority are not ordered by id, and
+ * only a job of higher priority comes before another one.
+ */
+struct PriorityLevelOrder
+{
+  static bool before(const Job& lhs, const Job& rhs)
+  {
+    return lhs.priority > rhs.priority;
+  }
+};
+
+
+/** queue job order
+ * The order a type of job queue dispatches jobs in, as an ordering
+ * policy (see ComesBeforeOrder), for the preemptive dispatcher.  known
+ * is false for queues whose order is not known at compile time, such
+ * as a Queue<Job> reference, or a queue whose order has run time state
+ * (AgingPriorityQueue), which can not be run preemptively.
+ */
+template <class JobQueue>
+struct QueueJobOrder
+{
+  static const bool known = false;
+  typedef ComesBeforeOrder<Job> type;
+};
+
+template <class Order>
+struct QueueJobOrder<HeapPriorityQueue<Job, Order> >
+{
+  static const bool known = true;
+  typedef Order type;
+};
+
+template <>
+struct QueueJobOrder<LQueue<Job> >
+{
+  static const bool known = true;
+  typedef FirstComeFirstServedOrder type;
+};
+
+template <>
+struct QueueJobOrder<PriorityQueue<Job> >
+{
+  static const bool known = true;
+  typedef PriorityLevelOrder type;
+};
+
+template <>
+struct QueueJobOrder<BucketPriorityQueue<Job> >
+{
+  static const bool known = true;
+  typedef PriorityLevelOrder type;
+};
+
+template <class Order>
+struct QueueJobOrder<HeapPriorityQueue<JobIndex, JobTableOrder<Order> > >
+{
+  static const bool known = true;
+  typedef Order type;
+};
+
+template <>
+struct QueueJobOrder<AQueue<JobIndex> >
+{
+  static const bool known = true;
+  typedef FirstComeFirstServedOrder type;
+};
+
+template <>
+struct QueueJobOrder<LQueue<JobIndex> >
+{
+  static const bool known = true;
+  typedef FirstComeFirstServedOrder type;
+};
+
+template <>
+struct QueueJobOrder<BucketPriorityQueue<JobIndex, JobTablePriority> >
+{
+  static const bool known = true;
+  typedef PriorityLevelOrder type;
+};
+
+
+/** preemption order
+ * The order running jobs are preempted in, by a job queue that
+ * dispatches jobs in the given Order: the reverse of that order, so the
+ * running job the queue would have dispatched last is preempted first.
+ * For the default comesBefore() order that is the lowest priority job,
+ * and of equal priority jobs the one that arrived last.  Running jobs
+ * are compared by the service they still need at the same time, so an
+ * order by remaining time (ShortestRemainingTimeOrder) sees how far
+ * each of them has got.
+ */
+template <class Order>
+struct PreemptionOrder
+{
+  static bool before(const RunningJob& lhs, const RunningJob& rhs)
+  {
+    return Order::before(rhs.remainingAt(0), lhs.remainingAt(0));
+  }
+
+  /** preempts
+   * @param waiting The front job of the job queue.
+   * @param running The running job at the front of the preemption
+   *   order.
+   * @param time The current simulation time.
+   *
+   * @returns bool true if the waiting job comes before the running job
+   *   in the queue's order, so it should take the running job's server.
+   */
+  static bool preempts(const Job& waiting, const RunningJob& running, long long time)
+  {
+    return Order::before(waiting, running.remainingAt(time));
+  }
+};
+
+
+/** preemption exception
+ * Class to be thrown when a simulation is to be run preemptively with a
+ * job queue whose order the preemptive dispatcher does not know, see
+ * QueueJobOrder.
+ */
+class PreemptionException
+{
+private:
+  string message;
+
+public:
+  PreemptionException(string message)
+  {
+    this->message = message;
+  }
+
+  string what()
+  {
+    return "Error: preemption " + message;
+  }
+};
+
+
+
+/** index queue adapter
+ * The queue of job indexes a simulation runs on in place of a caller's
+ * queue of Job, see JobIndexQueue.  The index queue is built with the
+ * same parameters as the caller's queue, and when the run is over the
+ * jobs still waiting are put back on the caller's queue, front first,
+ * so the caller sees the same queue as a run on Job objects leaves.
+ *
+ * @var jobQueue The caller's queue of Job.
+ * @var indexQueue The queue of job indexes the simulation runs on.
+ */
+template <class JobQueue, class IndexQueue>
+class IndexQueueAdapter
+{
+private:
+  JobQueue& jobQueue;
+  IndexQueue indexQueue;
+
+public:
+  template <class... Args>
+  IndexQueueAdapter(JobQueue& jobQueue, Args&&... args)
+    : jobQueue(jobQueue), indexQueue(std::forward<Args>(args)...)
+  {
+  }
+
+  IndexQueue& queue()
+  {
+    return indexQueue;
+  }
+
+  void returnWaitingJobs(const JobTable& table)
+  {
+    QueueDispatch<JobQueue>::clear(jobQueue);
+    for (typename IndexQueue::const_iterator index = indexQueue.begin();
+	 index != indexQueue.end(); ++index)
+    {
+      QueueDispatch<JobQueue>::emplace(jobQueue, table.job(*index));
+    }
+  }
+};
+
+
+/** job index queue
+ * Maps the job queue a simulation is run with to the queue it actually
+ * runs on.  The queues of Job whose order the simulator knows at
+ * compile time run on the same kind of queue of job indexes, with the
+ * jobs kept in the simulator's JobTable, so the queue moves 4 byte
+ * indexes rather than 28 byte Jobs, see IndexQueueAdapter.  Any other
+ * queue, a queue of JobIndex, a Queue<Job> reference, or the
+ * assignment's sorted PriorityQueue, which orders its items with their
+ * own comparison operators, is run on as it is.
+ *
+ * @var jobQueue The queue the simulation runs on.
+ */
+template <class JobQueue>
+class JobIndexQueue
+{
+private:
+  JobQueue& jobQueue;
+
+public:
+  JobIndexQueue(JobQueue& jobQueue, const JobTable* /* table */)
+    : jobQueue(jobQueue)
+  {
+  }
+
+  JobQueue& queue()
+  {
+    return jobQueue;
+  }
+
+  void returnWaitingJobs(const JobTable& /* table */)
+  {
+  }
+};
+
+template <class Order>
+class JobIndexQueue<HeapPriorityQueue<Job, Order> >
+  : public IndexQueueAdapter<HeapPriorityQueue<Job, Order>,
+			     HeapPriorityQueue<JobIndex, JobTableOrder<Order> > >
+{
+public:
+  JobIndexQueue(HeapPriorityQueue<Job, Order>& jobQueue, const JobTable* table)
+    : IndexQueueAdapter<HeapPriorityQueue<Job, Order>,
+			HeapPriorityQueue<JobIndex, JobTableOrder<Order> > >
+      (jobQueue, jobQueue.getArity(), JobTableOrder<Order>(table))
+  {
+  }
+};
+
+template <>
+class JobIndexQueue<AQueue<Job> >
+  : public IndexQueueAdapter<AQueue<Job>, AQueue<JobIndex> >
+{
+public:
+  JobIndexQueue(AQueue<Job>& jobQueue, const JobTable* /* table */)
+    : IndexQueueAdapter<AQueue<Job>, AQueue<JobIndex> >(jobQueue)
+  {
+  }
+};
+
+template <>
+class JobIndexQueue<LQueue<Job> >
+  : public IndexQueueAdapter<LQueue<Job>, LQueue<JobIndex> >
+{
+public:
+  JobIndexQueue(LQueue<Job>& jobQueue, const JobTable* /* table */)
+    : IndexQueueAdapter<LQueue<Job>, LQueue<JobIndex> >(jobQueue)
+  {
+  }
+};
+
+template <>
+class JobIndexQueue<BucketPriorityQueue<Job> >
+  : public IndexQueueAdapter<BucketPriorityQueue<Job>,
+			     BucketPriorityQueue<JobIndex, JobTablePriority> >
+{
+public:
+  JobIndexQueue(BucketPriorityQueue<Job>& jobQueue, const JobTable* table)
+    : IndexQueueAdapter<BucketPriorityQueue<Job>,
+			BucketPriorityQueue<JobIndex, JobTablePriority> >
+      (jobQueue, jobQueue.getMinPriority(), jobQueue.getMaxPriority(),
+       JobTablePriority(table))
+  {
+  }
+};
+
+
 /** JobSchedulerSimulator
  * This class organizes and executes simulations of job scheduling, using
  * different scheduling methods.  The simulations are goverend by a number
@@ -57,7 +492,9 @@ using namespace std;
  * is busy or not, and if not and if the job queue has some jobs on it, we
  * simulate dispatching a job.  Differences in how jobs are organized on
  * a queue, and their effects on system performance (as a function of
- * total or average cost) can be explored with this simulator.
+ * total or average cost) can be explored with this simulator.  A system
+ * can also have several servers, each of which dispatches a job from the
+ * shared job queue whenever it is idle.
  *
  * These are parameters of the simulation, they govern properties of
  * job arrivals and characteristics when a simulation is run:
@@ -77,6 +514,10 @@ using namespace std;
  *   long a job needs to execute, once it is selected to be processed.
  *   Service times are generated with uniform probability in this
  *   given range when new jobs arrive.
+ * @var numServers The number of servers (processors) that dispatch jobs
+ *   from the job queue in parallel, see ServerPool.
+ * @var preemptive If true, a waiting job of higher priority than a
+ *   running job interrupts it, see setPreemptive().
  *
  * These are resulting statistics of a simultion.  While a simulation is
  * being run, data is gathered about various performance characteristics, like
@@ -99,6 +540,29 @@ using namespace std;
  *   most recent simulation.
  * @var averageCost The average system cost for completed jobs of the most
  *   recent simulation.
+ * @var waitTimeHistogram The distribution of the wait times of completed
+ *   jobs, for the tail percentiles of the wait time.
+ * @var costHistogram The distribution of the costs of completed jobs.
+ * @var priorityClasses The wait time, cost and unfinished statistics of
+ *   each priority level, from minPriority to maxPriority, so the effect
+ *   of a queueing discipline on each class of jobs can be compared.
+ * @var servers The servers of the most recent simulation, and the time
+ *   each spent busy.
+ * @var averageUtilization The fraction of the simulation time the servers
+ *   were busy, on average over the servers.
+ * @var numPreemptions The number of times a running job was preempted.
+ * @var traceWriter If not NULL, every completed job is recorded to this
+ *   trace, see setTraceWriter().
+ * @var jobTable The waiting jobs of a simulation run on a queue of
+ *   JobIndex, and the jobs that have stopped waiting whose results are
+ *   still to be recorded, see runSimulation() and recordTableJobs().
+ * @var checkpointFileName The snapshot file runs are checkpointed to,
+ *   see setCheckpoint().
+ * @var checkpointInterval The number of time steps between checkpoints,
+ *   0 if runs are not checkpointed.
+ * @var stopAtCheckpoint True if a run stops after its first checkpoint.
+ * @var checkpointTime The time of the last checkpoint written or resumed
+ *   from, 0 if there was none.
  */
 struct JobSchedulerSimulator
 {
@@ -110,45 +574,161 @@ private:
   int maxPriority;
   int minServiceTime;
   int maxServiceTime;
+  int numServers;
+  bool preemptive;
 
   // simulation results
   string description;
   int numJobsStarted;
   int numJobsCompleted;
   int numJobsUnfinished;
-  int totalWaitTime;
-  int totalCost;
+  long long totalWaitTime;
+  long long totalCost;
   double averageWaitTime;
   double averageCost;
+  LogHistogram waitTimeHistogram;
+  LogHistogram costHistogram;
+  vector<PriorityClassStatistics> priorityClasses;
+  ServerPool servers;
+  double averageUtilization;
+  long long numPreemptions;
+  JobTraceWriter* traceWriter;
+
+  // the jobs of a simulation whose queue holds job indexes
+  JobTable jobTable;
+
+  // per simulation random number generator and job ids, so that
+  // simulations are independent of each other.  The arrivals and job
+  // attributes of a run are drawn in blocks, from a block generator
+  // seeded from the engine when the run starts.  The job ids of a run
+  // count up from 1, taken a block at a time from the allocator so that
+  // making a job is not an atomic operation
+  SimulatorRandomEngine generator;
+  RandomBlockGenerator randomBlocks;
+  JobIdAllocator jobIds;
+  JobIdBlock jobIdBlock;
+
+  // mean gap between arrivals, see nextArrivalGap()
+  double meanArrivalGap;
+
+  // checkpoints of runs, see setCheckpoint()
+  string checkpointFileName;
+  int checkpointInterval;
+  bool stopAtCheckpoint;
+  int checkpointTime;
 
   // private functions to support runSimulation(), mostly
   // for generating random times, priorities and poisson arrivals
   double randomUniform();
-  int randomRange(int minValue, int maxValue);
   bool jobArrived();
+  long long nextArrivalGap();
   int generateRandomPriority();
   int generateRandomServiceTime();
+
+  void resetResults(string description);
+  template <class JobQueue> void jobArrives(JobQueue& jobQueue, int time);
+  template <class JobQueue> void addJob(JobQueue& jobQueue, int time,
+					int priority, int serviceTime);
+  long long nextReplayedArrival(ArrivalTrace& trace, long long lastArrival);
+  template <class JobQueue> void enqueueJob(JobQueue& jobQueue, int time,
+					    int priority, int serviceTime, Job* jobs);
+  template <class JobQueue> void enqueueJob(JobQueue& jobQueue, int time,
+					    int priority, int serviceTime, JobIndex* jobs);
+  void recordJob(const Job& job, int time);
+  void recordJobDetails(const Job& job, int time, int waitTime, long long cost);
+  void recordTableJobs();
+  template <class JobQueue> int dispatchJob(JobQueue& jobQueue, int time);
+  template <class JobQueue> int dequeueJob(JobQueue& jobQueue, int time, Job* jobs);
+  template <class JobQueue> int dequeueJob(JobQueue& jobQueue, int time, JobIndex* jobs);
+  template <class JobQueue> Job takeJob(JobQueue& jobQueue, Job* jobs);
+  template <class JobQueue> Job takeJob(JobQueue& jobQueue, JobIndex* jobs);
+  template <class JobQueue> void requeueJob(JobQueue& jobQueue, Job& job, Job* jobs);
+  template <class JobQueue> void requeueJob(JobQueue& jobQueue, Job& job, JobIndex* jobs);
+  const Job& waitingJob(const Job& job) const;
+  Job waitingJob(JobIndex index) const;
+  template <class JobQueue, class RunningJobs>
+  void startJob(JobQueue& jobQueue, RunningJobs& runningJobs, int time);
+  template <class JobQueue, class RunningJobs>
+  void preemptJob(JobQueue& jobQueue, RunningJobs& runningJobs, int time);
+  void completeJob(const Job& job, int time, Job* jobs);
+  void completeJob(const Job& job, int time, JobIndex* jobs);
+  template <class RunningJobs, class QueuedJob>
+  void finishJobs(RunningJobs& runningJobs, long long time, QueuedJob* jobs);
+  void finishResults(int numJobsUnfinished);
+  template <class JobQueue> void simulate(JobQueue& jobQueue, string description,
+					  bool eventDriven);
+  template <class JobQueue> void replayTrace(JobQueue& jobQueue, ArrivalTrace& trace,
+					     string description);
+  template <class JobQueue> void runStepped(JobQueue& jobQueue, int startTime,
+					    long long nextArrival);
+  template <class JobQueue> void runEventDriven(JobQueue& jobQueue, ArrivalTrace* trace,
+						long long now, long long nextArrival);
+  template <class JobQueue> void runPreemptive(JobQueue& jobQueue, ArrivalTrace* trace);
+  long long nextCheckpointTime(long long time) const;
+  template <class JobQueue> bool writeCheckpoint(const JobQueue& jobQueue, bool eventDriven,
+						 long long now, long long nextArrival,
+						 long long time);
+  void saveQueuedJobs(SnapshotWriter& snapshot, const Queue<Job>& jobQueue);
+  void saveQueuedJobs(SnapshotWriter& snapshot, const Queue<JobIndex>& jobQueue);
+  template <class JobQueue> void restoreQueuedJobs(SnapshotReader& snapshot,
+						   JobQueue& jobQueue, Job* jobs);
+  template <class JobQueue> void restoreQueuedJobs(SnapshotReader& snapshot,
+						   JobQueue& jobQueue, JobIndex* jobs);
+  template <class JobQueue> void continueSimulation(JobQueue& jobQueue, string fileName,
+						    string description,
+						    const unsigned long long* forkSeed);
   
 public:
-JobSchedulerSimulator();
- // JobSchedulerSimulator(int simulationTime = 10000,
-	//		double jobArrivalProbability = 0.1,
-		//	int minPriority = 1,
-			//int maxPriority = 10,
-//			int minServiceTime = 5,
-	//		int maxServiceTime = 15);
+  JobSchedulerSimulator(int simulationTime = 10000,
+			double jobArrivalProbability = 0.1,
+			int minPriority = 1,
+			int maxPriority = 10,
+			int minServiceTime = 5,
+			int maxServiceTime = 15,
+			int numServers = 1);
   
   string summaryResultString();
   string csvResultString();
+  string csvHeaderString() const;
+  int getNumJobsStarted() const;
+  int getNumJobsCompleted() const;
+  double getAverageWaitTime() const;
+  double getAverageCost() const;
+  const LogHistogram& getWaitTimeHistogram() const;
+  const LogHistogram& getCostHistogram() const;
+  const PriorityClassStatistics& getPriorityClassStatistics(int priority) const;
+  int getNumServers() const;
+  int getMinPriority() const;
+  int getMaxPriority() const;
+  long long getServerBusyTime(int server) const;
+  double getServerUtilization(int server) const;
+  double getAverageUtilization() const;
+  long long getNumPreemptions() const;
+  void setSeed(unsigned long long seed);
+  SimulatorRandomEngine& randomEngine();
+  void setTraceWriter(JobTraceWriter* traceWriter);
+  void setPreemptive(bool preemptive);
+  bool isPreemptive() const;
+  void setCheckpoint(string fileName, int interval, bool stopAtCheckpoint = false);
+  int getCheckpointTime() const;
+  const JobTable& getJobTable() const;
 
-  // Assignment 11
-  // You need to add a new method to the class definition of the
-  // JobSchedulerSimulator named runSimulation() here.
-  void runSimulation();
+  template <class JobQueue>
+  void runSimulation(JobQueue& jobQueue, string description, bool eventDriven = false);
+  template <class JobQueue>
+  void runTraceReplay(JobQueue& jobQueue, ArrivalTrace& trace, string description);
+  template <class JobQueue>
+  void resumeSimulation(JobQueue& jobQueue, string fileName, string description);
+  template <class JobQueue>
+  void forkSimulation(JobQueue& jobQueue, string fileName, string description,
+		      unsigned long long seed);
   friend ostream& operator<<(ostream& out, JobSchedulerSimulator& sim);
 };
 
 
 
 
+// include the implementation of the simulator
+#include "JobSimulator.cpp"
+
 #endif
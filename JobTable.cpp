@@ -0,0 +1,275 @@
+/**
+ * @description A structure of arrays table of the jobs of a simulation,
+ *   so that job queues can hold small job indexes instead of whole jobs.
+ */
+#include "JobTable.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+// the finished jobs recorded in one streaming pass
+const int JobTable::finishedCapacity;
+
+
+/** job table constructor
+ * Create an empty table, with the finished columns for a block of
+ * finished jobs.
+ */
+JobTable::JobTable()
+  : finishedIds(finishedCapacity), finishedPriorities(finishedCapacity),
+    finishedServiceTimes(finishedCapacity), finishedRemainingTimes(finishedCapacity),
+    finishedStartTimes(finishedCapacity), endTimes(finishedCapacity),
+    finishedCount(0)
+{
+}
+
+
+/** job table clear
+ * Remove all of the jobs, waiting and finished, keeping the memory of
+ * the columns for the next simulation run.
+ */
+void JobTable::clear()
+{
+  priorityKeys.clear();
+  serviceKeys.clear();
+  remainingKeys.clear();
+  startTimes.clear();
+  freeRows.clear();
+  clearFinished();
+}
+
+
+/** job table reserve
+ * Make room for a number of waiting jobs up front, so adding them does
+ * not reallocate the columns.
+ *
+ * @param numJobs The number of jobs to make room for.
+ */
+void JobTable::reserve(int numJobs)
+{
+  priorityKeys.reserve(numJobs);
+  serviceKeys.reserve(numJobs);
+  remainingKeys.reserve(numJobs);
+  startTimes.reserve(numJobs);
+  freeRows.reserve(numJobs);
+}
+
+
+/** job table size
+ * @returns int The number of jobs in the table that are waiting.
+ */
+int JobTable::size() const
+{
+  return priorityKeys.size() - freeRows.size();
+}
+
+
+/** job table rows
+ * @returns int The number of rows of the waiting job columns, the most
+ *   jobs that have been waiting at once.
+ */
+int JobTable::numRows() const
+{
+  return priorityKeys.size();
+}
+
+
+/** job table add
+ * Add a new job, which is waiting, to a free row, or to a new row at
+ * the end of the columns if there is no free row.
+ *
+ * @param id The id of the job.
+ * @param priority The priority of the job.
+ * @param serviceTime The service time of the job.
+ * @param startTime The time the job arrived.
+ *
+ * @returns JobIndex The index of the row of the new job.
+ */
+JobIndex JobTable::add(int id, int priority, int serviceTime, int startTime)
+{
+  if (!freeRows.empty())
+  {
+    JobIndex index = freeRows.back();
+    freeRows.pop_back();
+    priorityKeys[index] = sortKey(~priority, id);
+    serviceKeys[index] = sortKey(serviceTime, id);
+    remainingKeys[index] = serviceKeys[index];
+    startTimes[index] = startTime;
+    return index;
+  }
+
+  JobIndex index = priorityKeys.size();
+  priorityKeys.push_back(sortKey(~priority, id));
+  serviceKeys.push_back(sortKey(serviceTime, id));
+  remainingKeys.push_back(serviceKeys[index]);
+  startTimes.push_back(startTime);
+  return index;
+}
+
+
+/** job table add job
+ * Add a job that is waiting again, a preempted job, keeping its id and
+ * the service time it still needs.
+ *
+ * @param job The job to add.
+ *
+ * @returns JobIndex The index of the row of the job.
+ */
+JobIndex JobTable::add(const Job& job)
+{
+  JobIndex index = add(job.id, job.priority, job.serviceTime, job.startTime);
+  remainingKeys[index] = sortKey(job.remainingTime, job.id);
+  return index;
+}
+
+
+/** job table remove
+ * Remove a job from the waiting jobs, freeing its row for the next job
+ * added.  The index must not be used again until add() gives it out
+ * again.
+ *
+ * @param index The index of the job to remove.
+ */
+void JobTable::remove(JobIndex index)
+{
+  freeRows.push_back(index);
+}
+
+
+/** job table job
+ * A waiting job made from the columns of the table, for code that
+ * works with Job objects.
+ *
+ * @param index A job index.
+ *
+ * @returns Job The job, with the service time it still needs.
+ */
+Job JobTable::job(JobIndex index) const
+{
+  Job job(id(index), priority(index), serviceTime(index), startTimes[index]);
+  job.remainingTime = remainingTime(index);
+  return job;
+}
+
+
+/** job table finish
+ * A waiting job stops waiting at the given time: append it to the
+ * finished columns with that end time, and free its row.  The finished
+ * columns must not be full, see numFinished().
+ *
+ * @param index The index of the job that stops waiting.
+ * @param endTime The time the job stops waiting.
+ */
+void JobTable::finish(JobIndex index, int endTime)
+{
+  finishedIds[finishedCount] = id(index);
+  finishedPriorities[finishedCount] = priority(index);
+  finishedServiceTimes[finishedCount] = serviceTime(index);
+  finishedRemainingTimes[finishedCount] = remainingTime(index);
+  finishedStartTimes[finishedCount] = startTimes[index];
+  endTimes[finishedCount] = endTime;
+  finishedCount++;
+  remove(index);
+}
+
+
+/** job table finish job
+ * A job that is not in the table, a running job that was preempted
+ * before, stops waiting: append it to the finished columns, which must
+ * not be full.
+ *
+ * @param job The job, with the service time it still needed when it
+ *   last started.
+ * @param endTime The time the job last started.
+ */
+void JobTable::finish(const Job& job, int endTime)
+{
+  finishedIds[finishedCount] = job.id;
+  finishedPriorities[finishedCount] = job.priority;
+  finishedServiceTimes[finishedCount] = job.serviceTime;
+  finishedRemainingTimes[finishedCount] = job.remainingTime;
+  finishedStartTimes[finishedCount] = job.startTime;
+  endTimes[finishedCount] = endTime;
+  finishedCount++;
+}
+
+
+/** job table finished size
+ * @returns int The number of finished jobs in the finished columns, at
+ *   most finishedCapacity.
+ */
+int JobTable::numFinished() const
+{
+  return finishedCount;
+}
+
+
+/** job table finished job
+ * A finished job made from the finished columns.
+ *
+ * @param order The position of the job in the finished columns, 0 for
+ *   the first job that finished.
+ *
+ * @returns Job The job, with its end time and the service time it
+ *   still needed when it last started.
+ */
+Job JobTable::finishedJob(int order) const
+{
+  Job job(finishedIds[order], finishedPriorities[order],
+	  finishedServiceTimes[order], finishedStartTimes[order]);
+  job.remainingTime = finishedRemainingTimes[order];
+  job.endTime = endTimes[order];
+  return job;
+}
+
+
+/** job table finished totals
+ * Work out the wait time and cost totals of the finished jobs.  This
+ * is a streaming pass down the finished columns, with no branches and
+ * no calls, that the compiler turns into vector instructions.  The
+ * wait time of a job is the time it waited before it last started,
+ * less the service it was given before it was preempted.  The cost is
+ * a 32 by 32 bit unsigned multiply, which SSE2 has, corrected for
+ * negative priorities, rather than a signed 64 bit multiply, which it
+ * does not have.
+ *
+ * @returns JobTableTotals The number of finished jobs, and their total
+ *   wait time and cost.
+ */
+JOBTABLE_VECTORIZE
+JobTableTotals JobTable::finishedTotals() const
+{
+  const int* priority = finishedPriorities.data();
+  const int* serviceTime = finishedServiceTimes.data();
+  const int* remainingTime = finishedRemainingTimes.data();
+  const int* startTime = finishedStartTimes.data();
+  const int* endTime = endTimes.data();
+  int numJobs = numFinished();
+
+  long long totalWaitTime = 0;
+  unsigned long long totalCost = 0;
+  for (int order = 0; order < numJobs; order++)
+  {
+    unsigned int waitTime = endTime[order] - startTime[order]
+      - (serviceTime[order] - remainingTime[order]);
+    totalWaitTime += waitTime;
+
+    // (unsigned)priority is 2^32 more than a negative priority
+    unsigned long long cost = (unsigned long long)(unsigned int)priority[order] * waitTime;
+    cost -= ((unsigned long long)waitTime << 32) & -(unsigned long long)(priority[order] < 0);
+    totalCost += cost;
+  }
+
+  JobTableTotals totals = {numJobs, totalWaitTime, (long long)totalCost};
+  return totals;
+}
+
+
+/** job table clear finished
+ * Remove the finished jobs, once their results have been recorded.
+ */
+void JobTable::clearFinished()
+{
+  finishedCount = 0;
+}
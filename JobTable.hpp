@@ -0,0 +1,314 @@
+/**
+ * @description A structure of arrays table of the jobs of a simulation,
+ *   so that job queues can hold small job indexes instead of whole jobs.
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Queue.hpp"
+using namespace std;
+#ifndef JOBTABLE_HPP
+#define JOBTABLE_HPP
+
+
+/** job index
+ * The index of a row of a JobTable.  A queue of indexes holds 4 bytes
+ * per waiting job.  Rows are reused once their job stops waiting, so an
+ * index names a job only while it is in the table, and ordering indexes
+ * is not ordering jobs, the id the sort keys carry is.
+ */
+typedef uint32_t JobIndex;
+
+
+// GCC (before -O3) only vectorizes loops that need no extra code at all,
+// so the streaming pass over the finished job columns asks for it
+#if defined(__GNUC__) && !defined(__clang__)
+#define JOBTABLE_VECTORIZE __attribute__((optimize("tree-vectorize")))
+#else
+#define JOBTABLE_VECTORIZE
+#endif
+
+
+//-------------------------------------------------------------------------
+/** JobTableTotals
+ * The wait time and cost totals of the finished jobs of a JobTable, see
+ * JobTable::finishedTotals().
+ *
+ * @var numFinished The number of jobs that have stopped waiting.
+ * @var totalWaitTime The sum of their wait times.
+ * @var totalCost The sum of their costs, priority times wait time.
+ */
+struct JobTableTotals
+{
+  long long numFinished;
+  long long totalWaitTime;
+  long long totalCost;
+};
+
+
+/** JobTable
+ * The jobs of a simulation stored as a structure of arrays: a column of
+ * each job attribute, indexed by JobIndex.  A job queue of indexes keeps
+ * 4 bytes per waiting job in place of a 28 byte Job, and moves 4 bytes
+ * per step of a heap sift.
+ *
+ * The waiting jobs each have a row.  The columns that queues order jobs
+ * by are sort keys (see sortKey()), the value and the job's id in one 64
+ * bit integer, so an order compares two jobs with one load and one
+ * comparison each, ties going to the job that arrived first.  When a
+ * job stops waiting its row is removed onto a free list, and the next
+ * job added takes it, so the rows grow to the most jobs that were ever
+ * waiting at once, not to the number of jobs of the run.
+ *
+ * A job that stops waiting is appended to the finished columns, with its
+ * end time, in the order the jobs finish.  The wait times and costs of
+ * the finished jobs are then worked out in one streaming pass down those
+ * columns that the compiler vectorizes (see finishedTotals()), a block
+ * of up to finishedCapacity jobs at a time, before the finished columns
+ * are cleared for the next block.  The finished columns are allocated
+ * for a whole block up front, small enough to stay in the L1 cache.
+ *
+ * @var priorityKeys The sort key of the priority of each waiting job,
+ *   of ~priority so that higher priorities sort first.
+ * @var serviceKeys The sort key of the service time of each waiting job.
+ * @var remainingKeys The sort key of the service time each waiting job
+ *   still needs, less than its service time if it was preempted.
+ * @var startTimes The time each waiting job arrived.
+ * @var freeRows The rows that hold no job, taken by add() before the
+ *   columns are made longer.
+ * @var finishedIds The id of each finished job.
+ * @var finishedPriorities The priority of each finished job.
+ * @var finishedServiceTimes The service time of each finished job.
+ * @var finishedRemainingTimes The service time each finished job still
+ *   needed when it last started.
+ * @var finishedStartTimes The time each finished job arrived.
+ * @var endTimes The time each finished job stopped waiting and started
+ *   running for the last time.
+ * @var finishedCount The number of jobs in the finished columns.
+ */
+class JobTable
+{
+private:
+  vector<long long> priorityKeys;
+  vector<long long> serviceKeys;
+  vector<long long> remainingKeys;
+  vector<int> startTimes;
+  vector<JobIndex> freeRows;
+
+  vector<int> finishedIds;
+  vector<int> finishedPriorities;
+  vector<int> finishedServiceTimes;
+  vector<int> finishedRemainingTimes;
+  vector<int> finishedStartTimes;
+  vector<int> endTimes;
+  int finishedCount;
+
+public:
+  static const int finishedCapacity = 1024;
+
+  JobTable(); // constructor
+  void clear();
+  void reserve(int numJobs);
+  int size() const;
+  int numRows() const;
+  JobIndex add(int id, int priority, int serviceTime, int startTime);
+  JobIndex add(const Job& job);
+  void remove(JobIndex index);
+  Job job(JobIndex index) const;
+  void finish(JobIndex index, int endTime);
+  void finish(const Job& job, int endTime);
+  int numFinished() const;
+  Job finishedJob(int order) const;
+  JobTableTotals finishedTotals() const;
+  void clearFinished();
+
+  /** sort key
+   * A value and a job id in one key, the value in the high 32 bits and
+   * the id in the low 32 bits, so that keys order by value and then by
+   * id.  Ids are positive, so this holds for negative values too.
+   *
+   * @param value The value to order by.
+   * @param id The id of the job.
+   *
+   * @returns long long The key.
+   */
+  static long long sortKey(int value, int id)
+  {
+    return (long long)value * 0x100000000LL + (unsigned int)id;
+  }
+
+  /** sort key value
+   * @param key A sort key.
+   *
+   * @returns int The value of the key, see sortKey().
+   */
+  static int keyValue(long long key)
+  {
+    return (int)(key >> 32);
+  }
+
+  /** id of a job
+   * @param index A job index.
+   *
+   * @returns int The id of the job.
+   */
+  int id(JobIndex index) const
+  {
+    return (int)(unsigned int)priorityKeys[index];
+  }
+
+  /** priority of a job
+   * @param index A job index.
+   *
+   * @returns int The priority of the job.
+   */
+  int priority(JobIndex index) const
+  {
+    return ~keyValue(priorityKeys[index]);
+  }
+
+  /** service time of a job
+   * @param index A job index.
+   *
+   * @returns int The service time of the job.
+   */
+  int serviceTime(JobIndex index) const
+  {
+    return keyValue(serviceKeys[index]);
+  }
+
+  /** remaining time of a job
+   * @param index A job index.
+   *
+   * @returns int The service time the job still needs.
+   */
+  int remainingTime(JobIndex index) const
+  {
+    return keyValue(remainingKeys[index]);
+  }
+
+  /** start time of a job
+   * @param index A job index.
+   *
+   * @returns int The time the job arrived.
+   */
+  int startTime(JobIndex index) const
+  {
+    return startTimes[index];
+  }
+
+  /** priority key of a job
+   * @param index A job index.
+   *
+   * @returns long long The sort key of ~priority and id, smallest for
+   *   the highest priority job that arrived first.
+   */
+  long long priorityKey(JobIndex index) const
+  {
+    return priorityKeys[index];
+  }
+
+  /** service key of a job
+   * @param index A job index.
+   *
+   * @returns long long The sort key of service time and id.
+   */
+  long long serviceKey(JobIndex index) const
+  {
+    return serviceKeys[index];
+  }
+
+  /** remaining key of a job
+   * @param index A job index.
+   *
+   * @returns long long The sort key of remaining time and id.
+   */
+  long long remainingKey(JobIndex index) const
+  {
+    return remainingKeys[index];
+  }
+};
+
+
+/** job table order
+ * An ordering policy for HeapPriorityQueue (see ComesBeforeOrder) of
+ * job indexes, that orders the indexes as JobOrder orders the jobs of
+ * the table.  The policy has state, the table, so the queue has to be
+ * given one:
+ *
+ *   HeapPriorityQueue<JobIndex, JobTableOrder<> > jobQueue(4, JobTableOrder<>(&table));
+ *
+ * This general policy builds the two jobs from the table columns for
+ * every comparison, which works for any JobOrder but reads all of the
+ * columns.  The orders of the scheduling disciplines are specialized to
+ * compare the sort keys or columns they need directly, see the default
+ * order below and SchedulingDiscipline.hpp.
+ *
+ * @var table The table of the jobs being ordered.
+ */
+template <class JobOrder = ComesBeforeOrder<Job> >
+struct JobTableOrder
+{
+  const JobTable* table;
+
+  JobTableOrder(const JobTable* table = NULL)
+    : table(table)
+  {
+  }
+
+  bool before(JobIndex lhs, JobIndex rhs) const
+  {
+    return JobOrder::before(table->job(lhs), table->job(rhs));
+  }
+};
+
+
+/** job table order (priority)
+ * The default order, highest priority first and first come first served
+ * within a priority, compares the priority keys.
+ */
+template <>
+struct JobTableOrder<ComesBeforeOrder<Job> >
+{
+  const JobTable* table;
+
+  JobTableOrder(const JobTable* table = NULL)
+    : table(table)
+  {
+  }
+
+  bool before(JobIndex lhs, JobIndex rhs) const
+  {
+    return table->priorityKey(lhs) < table->priorityKey(rhs);
+  }
+};
+
+
+/** job table priority
+ * A priority policy for BucketPriorityQueue (see ItemPriorityPolicy) of
+ * job indexes, that gives each index the priority of its job.
+ *
+ * @var table The table of the jobs being queued.
+ */
+struct JobTablePriority
+{
+  const JobTable* table;
+
+  JobTablePriority(const JobTable* table = NULL)
+    : table(table)
+  {
+  }
+
+  int priority(JobIndex index) const
+  {
+    return table->priority(index);
+  }
+};
+
+
+
+
+// include the implementation of the job table
+#include "JobTable.cpp"
+
+#endif
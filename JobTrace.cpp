@@ -0,0 +1,396 @@
+/**
+ * @description Per job traces of job scheduling simulations, in a
+ *   compact columnar binary format that can be memory mapped.
+ */
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "JobTrace.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** job trace block allocate
+ * Allocate the columns of the block, and empty it.
+ *
+ * @param blockCapacity The number of jobs the block can hold.
+ */
+void JobTraceBlock::allocate(int blockCapacity)
+{
+  numJobs = 0;
+  cost.resize(blockCapacity);
+  id.resize(blockCapacity);
+  priority.resize(blockCapacity);
+  serviceTime.resize(blockCapacity);
+  startTime.resize(blockCapacity);
+  endTime.resize(blockCapacity);
+}
+
+
+
+//-------------------------------------------------------------------------
+/** job trace writer constructor
+ * Create the trace file and start the writer thread.
+ *
+ * @param fileName The name of the trace file to create.
+ * @param blockCapacity The number of jobs in each block, rounded up to
+ *   an even number.
+ */
+JobTraceWriter::JobTraceWriter(string fileName, int blockCapacity)
+{
+  if (blockCapacity < 2)
+  {
+    blockCapacity = 2;
+  }
+  this->blockCapacity = blockCapacity + (blockCapacity % 2);
+  numJobs = 0;
+  filling = 0;
+  writing = -1;
+  closing = false;
+  failed = false;
+
+  file.open(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!file)
+  {
+    throw JobTraceException("could not create " + fileName);
+  }
+  isOpen = true;
+
+  blocks[0].allocate(this->blockCapacity);
+  blocks[1].allocate(this->blockCapacity);
+  writeHeader();
+  writerThread = thread(&JobTraceWriter::writeBlocks, this);
+}
+
+
+/** job trace writer destructor
+ * Complete the trace file if close() has not been called.
+ */
+JobTraceWriter::~JobTraceWriter()
+{
+  if (isOpen)
+  {
+    try
+    {
+      close();
+    }
+    catch (JobTraceException&)
+    {
+      // nothing more can be done about a failed write here
+    }
+  }
+}
+
+
+/** write header
+ * Write the file header, with the current number of jobs.
+ */
+void JobTraceWriter::writeHeader()
+{
+  uint32_t version = jobTraceVersion;
+  uint32_t capacity = blockCapacity;
+  uint64_t length = numJobs;
+  uint64_t reserved = 0;
+
+  file.write(jobTraceMagic, sizeof(jobTraceMagic));
+  file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  file.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+  file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+  file.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+}
+
+
+/** write block
+ * Write a block header and the columns of the block to the file.
+ *
+ * @param block The block to write.
+ */
+void JobTraceWriter::writeBlock(const JobTraceBlock& block)
+{
+  uint32_t length = block.numJobs;
+  uint32_t reserved32 = 0;
+  uint64_t reserved64 = 0;
+  file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+  file.write(reinterpret_cast<const char*>(&reserved32), sizeof(reserved32));
+  file.write(reinterpret_cast<const char*>(&reserved64), sizeof(reserved64));
+
+  file.write(reinterpret_cast<const char*>(&block.cost[0]), length * sizeof(int64_t));
+  file.write(reinterpret_cast<const char*>(&block.id[0]), length * sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(&block.priority[0]), length * sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(&block.serviceTime[0]), length * sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(&block.startTime[0]), length * sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(&block.endTime[0]), length * sizeof(int32_t));
+}
+
+
+/** submit block
+ * Hand the block being filled to the writer thread, and start filling
+ * the other block.  Waits if the other block is still being written.
+ */
+void JobTraceWriter::submitBlock()
+{
+  unique_lock<mutex> lock(blockMutex);
+  while (writing != -1)
+  {
+    blockChanged.wait(lock);
+  }
+  writing = filling;
+  filling = 1 - filling;
+  blocks[filling].numJobs = 0;
+  blockChanged.notify_all();
+}
+
+
+/** write blocks
+ * The work of the writer thread, writing each submitted block to the
+ * file until the writer is closed.
+ */
+void JobTraceWriter::writeBlocks()
+{
+  unique_lock<mutex> lock(blockMutex);
+  while (true)
+  {
+    while (writing == -1 && !closing)
+    {
+      blockChanged.wait(lock);
+    }
+    if (writing == -1)
+    {
+      return;
+    }
+
+    // write without holding the lock, so the simulation can keep
+    // filling the other block
+    const JobTraceBlock& block = blocks[writing];
+    lock.unlock();
+    writeBlock(block);
+    lock.lock();
+
+    if (!file)
+    {
+      failed = true;
+    }
+    writing = -1;
+    blockChanged.notify_all();
+  }
+}
+
+
+/** job trace writer length
+ * @returns long long The number of jobs recorded so far.
+ */
+long long JobTraceWriter::length() const
+{
+  return numJobs;
+}
+
+
+/** job trace writer close
+ * Write the last (partial) block, stop the writer thread and complete
+ * the file header with the final number of jobs.
+ */
+void JobTraceWriter::close()
+{
+  if (!isOpen)
+  {
+    return;
+  }
+  isOpen = false;
+
+  if (blocks[filling].numJobs > 0)
+  {
+    submitBlock();
+  }
+  {
+    lock_guard<mutex> lock(blockMutex);
+    closing = true;
+    blockChanged.notify_all();
+  }
+  writerThread.join();
+
+  file.seekp(0);
+  writeHeader();
+  file.close();
+  if (failed || !file)
+  {
+    throw JobTraceException("could not write all jobs to the trace file");
+  }
+}
+
+
+
+//-------------------------------------------------------------------------
+/** job trace reader constructor
+ * Memory map the trace file, and check its header.
+ *
+ * @param fileName The name of the trace file to read.
+ */
+JobTraceReader::JobTraceReader(string fileName)
+{
+  int descriptor = open(fileName.c_str(), O_RDONLY);
+  if (descriptor < 0)
+  {
+    throw JobTraceException("could not open " + fileName);
+  }
+
+  struct stat status;
+  if (fstat(descriptor, &status) != 0 || status.st_size < jobTraceHeaderSize)
+  {
+    ::close(descriptor);
+    throw JobTraceException(fileName + " is not a job trace file");
+  }
+  mappingSize = status.st_size;
+
+  void* memory = mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, descriptor, 0);
+  ::close(descriptor);
+  if (memory == MAP_FAILED)
+  {
+    throw JobTraceException("could not map " + fileName);
+  }
+  mapping = static_cast<const char*>(memory);
+
+  uint32_t version, capacity;
+  uint64_t length;
+  memcpy(&version, mapping + 8, sizeof(version));
+  memcpy(&capacity, mapping + 12, sizeof(capacity));
+  memcpy(&length, mapping + 16, sizeof(length));
+  blockCapacity = capacity;
+  numJobs = length;
+
+  if (memcmp(mapping, jobTraceMagic, sizeof(jobTraceMagic)) != 0
+      || version != jobTraceVersion || blockCapacity < 2
+      || (numJobs > 0 && block(numBlocks() - 1) + jobTraceBlockHeaderSize
+	  + 28LL * blockLength(numBlocks() - 1) > mapping + mappingSize))
+  {
+    munmap(const_cast<char*>(mapping), mappingSize);
+    throw JobTraceException(fileName + " is not a complete job trace file");
+  }
+}
+
+
+/** job trace reader destructor
+ * Unmap the trace file.
+ */
+JobTraceReader::~JobTraceReader()
+{
+  munmap(const_cast<char*>(mapping), mappingSize);
+}
+
+
+/** job trace reader block
+ * @param block The block number.
+ *
+ * @returns const char* The start of the block in the mapped file.
+ */
+const char* JobTraceReader::block(int block) const
+{
+  long long fullBlockSize = jobTraceBlockHeaderSize + 28LL * blockCapacity;
+  return mapping + jobTraceHeaderSize + block * fullBlockSize;
+}
+
+
+/** job trace reader length
+ * @returns long long The number of jobs in the trace.
+ */
+long long JobTraceReader::length() const
+{
+  return numJobs;
+}
+
+
+/** job trace reader number of blocks
+ * @returns int The number of blocks in the trace.
+ */
+int JobTraceReader::numBlocks() const
+{
+  return (numJobs + blockCapacity - 1) / blockCapacity;
+}
+
+
+/** job trace reader block length
+ * @param block The block number, in range [0, numBlocks()).
+ *
+ * @returns int The number of jobs in the block.
+ */
+int JobTraceReader::blockLength(int block) const
+{
+  uint32_t length;
+  memcpy(&length, this->block(block), sizeof(length));
+  return length;
+}
+
+
+/** job trace reader costs
+ * @param block The block number, in range [0, numBlocks()).
+ *
+ * @returns const int64_t* The cost column of the block.
+ */
+const int64_t* JobTraceReader::costs(int block) const
+{
+  return reinterpret_cast<const int64_t*>(this->block(block) + jobTraceBlockHeaderSize);
+}
+
+
+/** job trace reader ids
+ * @param block The block number, in range [0, numBlocks()).
+ *
+ * @returns const int32_t* The id column of the block.
+ */
+const int32_t* JobTraceReader::ids(int block) const
+{
+  return reinterpret_cast<const int32_t*>(costs(block) + blockLength(block));
+}
+
+
+/** job trace reader priorities
+ * @param block The block number, in range [0, numBlocks()).
+ *
+ * @returns const int32_t* The priority column of the block.
+ */
+const int32_t* JobTraceReader::priorities(int block) const
+{
+  return ids(block) + blockLength(block);
+}
+
+
+/** job trace reader service times
+ * @param block The block number, in range [0, numBlocks()).
+ *
+ * @returns const int32_t* The serviceTime column of the block.
+ */
+const int32_t* JobTraceReader::serviceTimes(int block) const
+{
+  return priorities(block) + blockLength(block);
+}
+
+
+/** job trace reader start times
+ * @param block The block number, in range [0, numBlocks()).
+ *
+ * @returns const int32_t* The startTime column of the block.
+ */
+const int32_t* JobTraceReader::startTimes(int block) const
+{
+  return serviceTimes(block) + blockLength(block);
+}
+
+
+/** job trace reader end times
+ * @param block The block number, in range [0, numBlocks()).
+ *
+ * @returns const int32_t* The endTime column of the block.
+ */
+const int32_t* JobTraceReader::endTimes(int block) const
+{
+  return startTimes(block) + blockLength(block);
+}
@@ -0,0 +1,228 @@
+/**
+ * @description Per job traces of job scheduling simulations, in a
+ *   compact columnar binary format that can be memory mapped.
+ */
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+#ifndef JOBTRACE_HPP
+#define JOBTRACE_HPP
+
+
+/** job trace file format
+ * A trace file is a 32 byte header followed by blocks of jobs.  Every
+ * block holds blockCapacity jobs, except the last which may hold fewer,
+ * so the offset of any block can be calculated directly.  Within a block
+ * the jobs are stored column by column, so an analysis that only needs,
+ * say, the costs reads only the cost column.  All values are stored in
+ * the byte order of the machine that wrote the trace.
+ *
+ *   header: char magic[8] = "JOBTRACE", uint32 version, uint32
+ *     blockCapacity, uint64 numJobs, uint64 reserved (0)
+ *   block: uint32 numJobs, uint32 reserved (0), uint64 reserved (0),
+ *     int64 cost[numJobs], int32 id[numJobs], int32 priority[numJobs],
+ *     int32 serviceTime[numJobs], int32 startTime[numJobs],
+ *     int32 endTime[numJobs]
+ *
+ * The cost column comes first so that it is 8 byte aligned when the file
+ * is memory mapped (blockCapacity is always even).
+ */
+const char jobTraceMagic[8] = {'J', 'O', 'B', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t jobTraceVersion = 1;
+const int jobTraceHeaderSize = 32;
+const int jobTraceBlockHeaderSize = 16;
+
+
+
+//-------------------------------------------------------------------------
+/** Job trace exception
+ * Class for errors writing or reading job trace files.
+ */
+class JobTraceException
+{
+private:
+  string message;
+
+public:
+  JobTraceException(string str)
+  {
+    message = "Error: job trace " + str;
+  }
+
+  string what()
+  {
+    return message;
+  }
+};
+
+
+
+//-------------------------------------------------------------------------
+/** JobTraceBlock
+ * The columns of one block of jobs, while it is being filled in by the
+ * simulation or written out to the trace file.
+ */
+struct JobTraceBlock
+{
+  int numJobs;
+  vector<int64_t> cost;
+  vector<int32_t> id;
+  vector<int32_t> priority;
+  vector<int32_t> serviceTime;
+  vector<int32_t> startTime;
+  vector<int32_t> endTime;
+
+  void allocate(int blockCapacity);
+};
+
+
+
+//-------------------------------------------------------------------------
+/** JobTraceWriter
+ * Writes a job trace file.  The simulation records each job into the
+ * block being filled, which only stores the values into the columns.
+ * Full blocks are handed to a background thread that writes them to the
+ * file, while the simulation goes on filling the other block.  The
+ * simulation only has to wait if it fills a block before the previous
+ * one has been written.
+ *
+ * A writer must only be used by one simulation (thread) at a time.
+ * close() must be called to complete the file, it is called by the
+ * destructor if needed.
+ *
+ * @var file The trace file being written.
+ * @var blockCapacity The number of jobs in each (full) block.
+ * @var numJobs The number of jobs recorded so far.
+ * @var blocks The two blocks, one being filled and one being written.
+ * @var filling The index of the block being filled.
+ * @var writing The index of the block being written, or -1 if the
+ *   writer thread is waiting for a block.
+ * @var closing Set when the writer thread should finish.
+ * @var failed Set if writing to the file failed.
+ * @var writerThread The background thread writing full blocks.
+ */
+class JobTraceWriter
+{
+private:
+  ofstream file;
+  int blockCapacity;
+  long long numJobs;
+  JobTraceBlock blocks[2];
+  int filling;
+  int writing;
+  bool closing;
+  bool failed;
+  bool isOpen;
+  mutex blockMutex;
+  condition_variable blockChanged;
+  thread writerThread;
+
+  void writeHeader();
+  void writeBlock(const JobTraceBlock& block);
+  void submitBlock();
+  void writeBlocks();
+
+  // writers own their file and thread, they can not be copied
+  JobTraceWriter(const JobTraceWriter&);
+  JobTraceWriter& operator=(const JobTraceWriter&);
+
+public:
+  JobTraceWriter(string fileName, int blockCapacity = 65536); // constructor
+  ~JobTraceWriter(); // destructor
+
+  /** record
+   * Record one completed job in the trace.
+   *
+   * @param id The id of the job.
+   * @param priority The priority of the job.
+   * @param serviceTime The service time of the job.
+   * @param startTime The time the job arrived.
+   * @param endTime The time the job was dispatched.
+   * @param cost The cost of the job, its priority times its wait time.
+   */
+  void record(int id, int priority, int serviceTime, int startTime,
+	      int endTime, long long cost)
+  {
+    JobTraceBlock& block = blocks[filling];
+    int index = block.numJobs++;
+    block.cost[index] = cost;
+    block.id[index] = id;
+    block.priority[index] = priority;
+    block.serviceTime[index] = serviceTime;
+    block.startTime[index] = startTime;
+    block.endTime[index] = endTime;
+    numJobs++;
+
+    if (block.numJobs == blockCapacity)
+    {
+      submitBlock();
+    }
+  }
+
+  long long length() const;
+  void close();
+};
+
+
+
+//-------------------------------------------------------------------------
+/** JobTraceReader
+ * Reads a job trace file by memory mapping it, so the columns of each
+ * block are used in place without copying or parsing, and only the parts
+ * of the file that are used are read from disk.  This makes it practical
+ * to analyse traces of hundreds of millions of jobs.
+ *
+ * Columns are accessed a block at a time, e.g.
+ *
+ *   for (int block = 0; block < trace.numBlocks(); block++)
+ *   {
+ *     const int64_t* cost = trace.costs(block);
+ *     for (int job = 0; job < trace.blockLength(block); job++)
+ *       totalCost += cost[job];
+ *   }
+ *
+ * @var mapping The start of the memory mapped file.
+ * @var mappingSize The size of the file.
+ * @var blockCapacity The number of jobs in each full block.
+ * @var numJobs The number of jobs in the trace.
+ */
+class JobTraceReader
+{
+private:
+  const char* mapping;
+  size_t mappingSize;
+  int blockCapacity;
+  long long numJobs;
+
+  const char* block(int block) const;
+
+  // readers own their mapping, they can not be copied
+  JobTraceReader(const JobTraceReader&);
+  JobTraceReader& operator=(const JobTraceReader&);
+
+public:
+  JobTraceReader(string fileName); // constructor
+  ~JobTraceReader(); // destructor
+  long long length() const;
+  int numBlocks() const;
+  int blockLength(int block) const;
+  const int64_t* costs(int block) const;
+  const int32_t* ids(int block) const;
+  const int32_t* priorities(int block) const;
+  const int32_t* serviceTimes(int block) const;
+  const int32_t* startTimes(int block) const;
+  const int32_t* endTimes(int block) const;
+};
+
+
+
+
+// include the implementation of the job traces
+#include "JobTrace.cpp"
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @description Report the memory use of the running process, so that
+ *   long running simulations can confirm their memory stays flat.
+ */
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "MemoryStats.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** current resident bytes
+ * The current resident set size of the process, read from the second
+ * field (resident pages) of /proc/self/statm.
+ *
+ * @returns long long The current RSS in bytes, or 0 if unknown.
+ */
+long long currentResidentBytes()
+{
+  ifstream statm("/proc/self/statm");
+  long long totalPages = 0;
+  long long residentPages = 0;
+  if (!(statm >> totalPages >> residentPages))
+  {
+    return 0;
+  }
+  return residentPages * sysconf(_SC_PAGESIZE);
+}
+
+
+/** peak resident bytes
+ * The largest resident set size the process has had, from getrusage().
+ * Linux reports ru_maxrss in kilobytes.
+ *
+ * @returns long long The peak RSS in bytes, or 0 if unknown.
+ */
+long long peakResidentBytes()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+  return (long long)usage.ru_maxrss * 1024;
+}
+
+
+/** memory stats string
+ * Create a string for display of the current and peak RSS.
+ *
+ * @returns string The memory use of the process, in kilobytes.
+ */
+string memoryStatsString()
+{
+  ostringstream out;
+  out << "RSS current: " << currentResidentBytes() / 1024 << " KB"
+      << ", peak: " << peakResidentBytes() / 1024 << " KB";
+  return out.str();
+}
@@ -0,0 +1,26 @@
+/**
+ * @description Report the memory use of the running process, so that
+ *   long running simulations can confirm their memory stays flat.
+ */
+#include <string>
+using namespace std;
+#ifndef MEMORYSTATS_HPP
+#define MEMORYSTATS_HPP
+
+
+//-------------------------------------------------------------------------
+// functions reporting the resident set size (RSS) of this process, that
+// is the amount of physical memory it is using.  They return 0 on systems
+// where the information is not available.
+
+long long currentResidentBytes();
+long long peakResidentBytes();
+string memoryStatsString();
+
+
+
+
+// include the implementation of the memory statistics
+#include "MemoryStats.cpp"
+
+#endif
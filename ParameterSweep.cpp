@@ -0,0 +1,306 @@
+/**
+ * @description Sweep job scheduling simulations over a grid of
+ *   simulation parameters, in parallel, streaming the results.
+ */
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ParameterSweep.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** parameter sweep constructor
+ * Set up a sweep of simulations with the given simulation time and
+ * queueing method.  The grid starts out as the single configuration of
+ * the default simulation parameters, use the set methods to give the
+ * values to sweep.
+ *
+ * @param simulationTime The number of time steps of every simulation.
+ * @param makeQueue A factory creating the (empty) job queue of each
+ *   configuration, which determines the queueing discipline simulated.
+ * @param description Description of the dispatching/queueing method.
+ * @param eventDriven Run simulations in event driven mode if true,
+ *   otherwise in stepped mode.
+ * @param baseSeed The seed that all configuration seeds are derived from.
+ */
+ParameterSweep::ParameterSweep(int simulationTime,
+			       QueueFactory makeQueue,
+			       string description,
+			       bool eventDriven,
+			       unsigned long long baseSeed)
+{
+  this->simulationTime = simulationTime;
+  this->makeQueue = makeQueue;
+  this->description = description;
+  this->eventDriven = eventDriven;
+  this->baseSeed = baseSeed;
+  arrivalProbabilities.push_back(0.1);
+  priorityRanges.push_back(ParameterRange(1, 10));
+  serviceTimeRanges.push_back(ParameterRange(5, 15));
+}
+
+
+/** value range
+ * Make the list of values first, first + step, ... up to and including
+ * last (allowing for rounding error in the steps).
+ *
+ * @param first The first value.
+ * @param last The last value.
+ * @param step The (positive) difference between values.
+ *
+ * @returns vector<double> The values of the range.
+ */
+vector<double> ParameterSweep::valueRange(double first, double last, double step)
+{
+  vector<double> values;
+  long long numSteps = (long long)floor((last - first) / step + 1e-9);
+  for (long long index = 0; index <= numSteps; index++)
+  {
+    values.push_back(first + index * step);
+  }
+  return values;
+}
+
+
+/** range grid
+ * Make the grid of [minimum, minimum + width] ranges for every minimum
+ * in firstMinimum, firstMinimum + minimumStep, ... lastMinimum and every
+ * width in firstWidth, firstWidth + widthStep, ... lastWidth.
+ *
+ * @returns vector<ParameterRange> The ranges of the grid.
+ */
+vector<ParameterRange> ParameterSweep::rangeGrid(int firstMinimum, int lastMinimum,
+						 int minimumStep,
+						 int firstWidth, int lastWidth,
+						 int widthStep)
+{
+  vector<ParameterRange> ranges;
+  for (int minimum = firstMinimum; minimum <= lastMinimum; minimum += minimumStep)
+  {
+    for (int width = firstWidth; width <= lastWidth; width += widthStep)
+    {
+      ranges.push_back(ParameterRange(minimum, minimum + width));
+    }
+  }
+  return ranges;
+}
+
+
+/** set arrival probabilities
+ * @param values The jobArrivalProbability values to sweep.
+ */
+void ParameterSweep::setArrivalProbabilities(const vector<double>& values)
+{
+  arrivalProbabilities = values;
+}
+
+
+/** set priority ranges
+ * @param ranges The [minPriority, maxPriority] ranges to sweep.
+ */
+void ParameterSweep::setPriorityRanges(const vector<ParameterRange>& ranges)
+{
+  priorityRanges = ranges;
+}
+
+
+/** set service time ranges
+ * @param ranges The [minServiceTime, maxServiceTime] ranges to sweep.
+ */
+void ParameterSweep::setServiceTimeRanges(const vector<ParameterRange>& ranges)
+{
+  serviceTimeRanges = ranges;
+}
+
+
+/** number of configurations
+ * @returns long long The size of the cartesian product of the grid.
+ */
+long long ParameterSweep::numConfigurations() const
+{
+  return (long long)arrivalProbabilities.size()
+    * priorityRanges.size() * serviceTimeRanges.size();
+}
+
+
+/** decode configuration
+ * Decode a configuration number into the indexes of its parameters in
+ * the grid.  The service time range varies fastest, then the priority
+ * range, then the arrival probability.
+ *
+ * @param index The configuration number, in [0, numConfigurations()).
+ * @param arrivalIndex Returns the index into arrivalProbabilities.
+ * @param priorityIndex Returns the index into priorityRanges.
+ * @param serviceTimeIndex Returns the index into serviceTimeRanges.
+ */
+void ParameterSweep::decodeConfiguration(long long index, int& arrivalIndex,
+					 int& priorityIndex,
+					 int& serviceTimeIndex) const
+{
+  serviceTimeIndex = index % serviceTimeRanges.size();
+  index /= serviceTimeRanges.size();
+  priorityIndex = index % priorityRanges.size();
+  index /= priorityRanges.size();
+  arrivalIndex = index;
+}
+
+
+/** run configuration
+ * Run the simulation of one configuration, seeded for that
+ * configuration, and make its csv result row.  The job queue is made
+ * for the configuration's simulator, whose job table it orders by.
+ *
+ * @param index The configuration number, in [0, numConfigurations()).
+ *
+ * @returns string The csv row of the configuration parameters and the
+ *   simulation results.
+ */
+string ParameterSweep::runConfiguration(long long index) const
+{
+  int arrivalIndex, priorityIndex, serviceTimeIndex;
+  decodeConfiguration(index, arrivalIndex, priorityIndex, serviceTimeIndex);
+  double arrivalProbability = arrivalProbabilities[arrivalIndex];
+  const ParameterRange& priority = priorityRanges[priorityIndex];
+  const ParameterRange& serviceTime = serviceTimeRanges[serviceTimeIndex];
+
+  JobSchedulerSimulator sim(simulationTime, arrivalProbability,
+			    priority.first, priority.second,
+			    serviceTime.first, serviceTime.second);
+  sim.setSeed(ReplicationRunner::replicationSeed(baseSeed, index));
+  Queue<JobIndex>* jobQueue = makeQueue(&sim.getJobTable());
+  sim.runSimulation(*jobQueue, description, eventDriven);
+  delete jobQueue;
+
+  // pad the priority class columns out to those of the widest
+  // priority range, so every row has the same number of columns
+  string results = sim.csvResultString();
+  results.erase(results.size() - 1);
+  for (int priorityClass = priority.second - priority.first + 1;
+       priorityClass < maxPriorityClasses(); priorityClass++)
+  {
+    results += ",,,,,,,";
+  }
+
+  ostringstream row;
+  row << index << ","
+      << setprecision(6) << arrivalProbability << ","
+      << priority.first << "," << priority.second << ","
+      << serviceTime.first << "," << serviceTime.second << ","
+      << results << endl;
+  return row.str();
+}
+
+
+/** maximum priority classes
+ * @returns int The number of priority levels of the widest priority
+ *   range of the grid.
+ */
+int ParameterSweep::maxPriorityClasses() const
+{
+  int maxClasses = 0;
+  for (int index = 0; index < (int)priorityRanges.size(); index++)
+  {
+    int numClasses = priorityRanges[index].second - priorityRanges[index].first + 1;
+    if (numClasses > maxClasses)
+    {
+      maxClasses = numClasses;
+    }
+  }
+  return maxClasses;
+}
+
+
+/** csv header
+ * The header line of the csv output of run().  The columns after the
+ * parameters are those of JobSchedulerSimulator::csvResultString(), with
+ * priority class columns for the widest priority range of the grid (rows
+ * of narrower ranges leave the extra class columns empty).
+ *
+ * @returns string The csv header line.
+ */
+string ParameterSweep::csvHeaderString() const
+{
+  JobSchedulerSimulator widest(simulationTime, 0.1, 1, maxPriorityClasses());
+  return "configuration,jobArrivalProbability,minPriority,maxPriority,"
+    "minServiceTime,maxServiceTime," + widest.csvHeaderString();
+}
+
+
+/** run configurations
+ * The work done by each thread.  The thread claims configuration
+ * numbers one at a time from the shared counter until all have been
+ * run, writing the row of each as it completes.
+ *
+ * @param nextConfiguration Shared counter of the next configuration.
+ * @param out The stream the result rows are written to.
+ */
+void ParameterSweep::runConfigurations(atomic<long long>& nextConfiguration,
+				       ostream& out)
+{
+  long long numConfigurations = this->numConfigurations();
+
+  long long index;
+  while ((index = nextConfiguration++) < numConfigurations)
+  {
+    // run and format before taking the lock, so threads only wait on
+    // each other for the write itself
+    string row = runConfiguration(index);
+
+    lock_guard<mutex> lock(outputMutex);
+    out << row;
+  }
+}
+
+
+/** run
+ * Run every configuration of the grid, spread over the given number of
+ * threads, writing the csv header and then one row per configuration to
+ * the given stream.
+ *
+ * @param out The stream the csv results are written to, for example
+ *   an ofstream to stream the results to disk.
+ * @param numThreads The number of threads to use, 0 means one per
+ *   hardware thread.
+ */
+void ParameterSweep::run(ostream& out, int numThreads)
+{
+  long long numConfigurations = this->numConfigurations();
+  if (numThreads <= 0)
+  {
+    numThreads = thread::hardware_concurrency();
+    if (numThreads <= 0)
+    {
+      numThreads = 1;
+    }
+  }
+  if (numThreads > numConfigurations)
+  {
+    numThreads = (numConfigurations > 0) ? numConfigurations : 1;
+  }
+
+  out << csvHeaderString();
+
+  atomic<long long> nextConfiguration(0);
+  vector<thread> workers;
+  for (int worker = 1; worker < numThreads; worker++)
+  {
+    workers.push_back(thread(&ParameterSweep::runConfigurations, this,
+			     ref(nextConfiguration), ref(out)));
+  }
+  // the calling thread does its share of the work too
+  runConfigurations(nextConfiguration, out);
+
+  for (int worker = 0; worker < (int)workers.size(); worker++)
+  {
+    workers[worker].join();
+  }
+  out.flush();
+}
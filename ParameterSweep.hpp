@@ -0,0 +1,102 @@
+/**
+ * @description Sweep job scheduling simulations over a grid of
+ *   simulation parameters, in parallel, streaming the results.
+ */
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Queue.hpp"
+#include "JobSimulator.hpp"
+#include "ReplicationRunner.hpp"
+using namespace std;
+#ifndef PARAMETERSWEEP_HPP
+#define PARAMETERSWEEP_HPP
+
+
+/** parameter range
+ * A [minimum, maximum] range of an integer simulation parameter, like
+ * [minPriority, maxPriority] or [minServiceTime, maxServiceTime].
+ */
+typedef pair<int, int> ParameterRange;
+
+
+
+//-------------------------------------------------------------------------
+/** ParameterSweep
+ * Runs one simulation for every configuration in the cartesian product
+ * of a grid of jobArrivalProbability values, priority ranges and service
+ * time ranges.  Configurations are numbered, and worker threads claim
+ * configuration numbers from a shared counter and decode the parameters
+ * from the number, so the grid itself is never expanded in memory.  Each
+ * result row is written to the output stream as soon as its simulation
+ * completes, so memory use does not depend on the size of the grid.
+ *
+ * Rows are written in order of completion, not in configuration order,
+ * but each row starts with its configuration number, and each
+ * simulation is seeded from the base seed and its configuration number,
+ * so the set of rows is the same no matter how many threads are used.
+ *
+ * Programs using the sweep need to be linked with -pthread.
+ *
+ * @var simulationTime The simulationTime of every configuration.
+ * @var makeQueue Factory for the job queue of each configuration.
+ * @var description Description of the dispatching/queueing method.
+ * @var eventDriven Run simulations in event driven mode if true.
+ * @var baseSeed The seed all configuration seeds are derived from.
+ * @var arrivalProbabilities The jobArrivalProbability values to sweep.
+ * @var priorityRanges The [minPriority, maxPriority] ranges to sweep.
+ * @var serviceTimeRanges The [minServiceTime, maxServiceTime] ranges
+ *   to sweep.
+ * @var outputMutex Serializes writing rows to the output stream.
+ */
+class ParameterSweep
+{
+private:
+  int simulationTime;
+  QueueFactory makeQueue;
+  string description;
+  bool eventDriven;
+  unsigned long long baseSeed;
+  vector<double> arrivalProbabilities;
+  vector<ParameterRange> priorityRanges;
+  vector<ParameterRange> serviceTimeRanges;
+  mutex outputMutex;
+
+  void decodeConfiguration(long long index, int& arrivalIndex,
+			   int& priorityIndex, int& serviceTimeIndex) const;
+  string runConfiguration(long long index) const;
+  int maxPriorityClasses() const;
+  void runConfigurations(atomic<long long>& nextConfiguration,
+			 ostream& out);
+
+public:
+  ParameterSweep(int simulationTime,
+		 QueueFactory makeQueue,
+		 string description,
+		 bool eventDriven = false,
+		 unsigned long long baseSeed = 1);
+
+  static vector<double> valueRange(double first, double last, double step);
+  static vector<ParameterRange> rangeGrid(int firstMinimum, int lastMinimum,
+					  int minimumStep,
+					  int firstWidth, int lastWidth,
+					  int widthStep);
+
+  void setArrivalProbabilities(const vector<double>& values);
+  void setPriorityRanges(const vector<ParameterRange>& ranges);
+  void setServiceTimeRanges(const vector<ParameterRange>& ranges);
+  long long numConfigurations() const;
+  string csvHeaderString() const;
+  void run(ostream& out, int numThreads = 0);
+};
+
+
+
+
+// include the implementation of the parameter sweep
+#include "ParameterSweep.cpp"
+
+#endif
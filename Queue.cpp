@@ -6,7 +6,7 @@
  */
  
 #include "Queue.hpp" 
-int Job::nextListId = 1;
+JobIdAllocator Job::nextListId(1);
 
 
 /** Job default constructor
@@ -21,6 +21,7 @@ Job::Job()
   this->id = 0;
   this->priority = 0;
   this->serviceTime = 0;
+  this->remainingTime = 0;
   this->startTime = 0;
   this->endTime = 0;
 }
@@ -30,6 +31,9 @@ Job::Job()
  * The actual constructor that needs to be used for Jobs in a simulation.
  * The job is assigned a priority, serviceTime and we record the startTime
  * when the job arrived and began waiting on the system queue for processing.
+ * The id is allocated from the shared nextListId allocator, which is safe
+ * to do from any number of threads, but the ids then depend on every job
+ * made this way, see the constructor with an id for reproducible ids.
  * 
  * @param priority Each job in our simulations has a priority level.  In this
  *   Job object and simulation, the higher the number, the higher the priority
@@ -43,9 +47,33 @@ Job::Job()
  */
 Job::Job(int priority, int serviceTime, int startTime)
 {
-  this->id = nextListId++;
+  this->id = nextListId.allocate();
   this->priority = priority;
   this->serviceTime = serviceTime;
+  this->remainingTime = serviceTime;
+  this->startTime = startTime;
+  this->endTime = startTime;
+}
+
+
+/** Job constructor with id
+ * Constructor for Jobs whose id is assigned by the caller, rather than
+ * taken from the shared nextListId allocator.  A simulation uses this to
+ * number its own jobs from an allocator of its own (see JobIdAllocator),
+ * so its ids do not depend on other simulations running at the same time
+ * or on the runs before it.
+ *
+ * @param id The unique id of this job.
+ * @param priority The priority level of this job.
+ * @param serviceTime The time that the job needs to run.
+ * @param startTime The system time at which this jobs was created.
+ */
+Job::Job(int id, int priority, int serviceTime, int startTime)
+{
+  this->id = id;
+  this->priority = priority;
+  this->serviceTime = serviceTime;
+  this->remainingTime = serviceTime;
   this->startTime = startTime;
   this->endTime = startTime;
 }
@@ -240,22 +268,24 @@ ostream& operator<<(ostream& out, const Job& aJob)
   return out;
 }
 
+
 //-------------------------------------------------------------------------
 /** Queue equivalence
  * Compare two given queues to determine if they are equal or not.
- * stacks are equal if they are both of the same size, and each
- * corresponding item on each stack is equal at the same position on the
- * stack.  This function relies on overloaded operator[] to access
- * items on stack by index for the comparison.
+ * queues are equal if they are both of the same size, and each
+ * corresponding item on each queue is equal at the same position on the
+ * queue.  The items are compared by walking both queues with their
+ * iterators, so this is O(n) whatever kind of queues are compared.
  *
- * @param rhs The stack on the right hand side of the boolean comparison
- *   expression to compare this stack against to check for equivalence.
+ * @param rhs The queue on the right hand side of the boolean comparison
+ *   expression to compare this queue against to check for equivalence.
  *
- * @returns bool Returns true if the stacks are equal, and false otherwise.
+ * @returns bool Returns true if the queues are equal, and false otherwise.
  */
-bool Queue::operator==(const Queue& rhs) const
+template <class T>
+bool Queue<T>::operator==(const Queue<T>& rhs) const
 {
-  // if number of items on the stacks don't match, then they can't
+  // if number of items on the queues don't match, then they can't
   // be equivalent
   if (this->length() != rhs.length())
   {
@@ -263,51 +293,204 @@ bool Queue::operator==(const Queue& rhs) const
   }
 
   // otherwise need to check each item individually
-  for (int index = 0; index < this->length(); index++)
+  const_iterator rhsItem = rhs.begin();
+  for (const_iterator item = begin(), last = end(); item != last; ++item, ++rhsItem)
   {
-    if ((*this)[index] != rhs[index])
+    if (!(*item == *rhsItem))
     {
       return false;
     }
   }
 
   // if we get to this point, all itmes checked were equivalent, so
-  // we are done and the answer is yes the stacks are equal
+  // we are done and the answer is yes the queues are equal
   return true;
 }
 
 
+/** Queue tostring
+ * Represent this queue as a string, see print().
+ *
+ * @returns string Returns the contents of queue as a string.
+ */
+template <class T>
+string Queue<T>::tostring() const
+{
+  ostringstream out;
+
+  print(out);
+  return out.str();
+}
+
+
+/** Queue print
+ * Write the items of the queue, from front to back, directly to an
+ * output stream, without building a string of the whole queue first.
+ *
+ * @param out The output stream to write to.
+ */
+template <class T>
+void Queue<T>::print(ostream& out) const
+{
+  out << "Front: ";
+  for (const_iterator item = begin(), last = end(); item != last; ++item)
+  {
+    out << *item << " ";
+  }
+  out << ":Back\n";
+}
+
+
+/** Queue begin
+ * @returns const_iterator An iterator at the front item of the queue.
+ */
+template <class T>
+typename Queue<T>::const_iterator Queue<T>::begin() const
+{
+  return const_iterator(this, 0);
+}
+
+
+/** Queue end
+ * @returns const_iterator An iterator just past the back of the queue.
+ */
+template <class T>
+typename Queue<T>::const_iterator Queue<T>::end() const
+{
+  return const_iterator(this, length());
+}
+
+
 /** Queue output stream operator
  * Friend function for Queue ADT, overload output stream operator to allow
  * easy output of queue representation to an output stream.
  */
-ostream& operator<<(ostream& out, const Queue& aQueue)
+template <class T>
+ostream& operator<<(ostream& out, const Queue<T>& aQueue)
 {
-  out << aQueue.tostring();
+  aQueue.print(out);
   return out;
 }
 
 
 
+//-------------------------------------------------------------------------
+/** queue iterator constructor
+ * An iterator at the front of a queue, or past its back.  Only begin()
+ * iterators fill a batch, end() iterators are just compared against.
+ *
+ * @param aQueue The queue to traverse.
+ * @param itemIndex 0 for an iterator at the front of the queue, or the
+ *   length of the queue for an iterator past the back.
+ */
+template <class T>
+Queue<T>::const_iterator::const_iterator(const Queue<T>* aQueue, int itemIndex)
+{
+  this->aQueue = aQueue;
+  this->itemIndex = itemIndex;
+  position.index = 0;
+  position.node = NULL;
+  batchIndex = 0;
+  batchLength = 0;
+  if (itemIndex == 0)
+  {
+    nextBatch();
+  }
+}
+
+
+/** queue iterator next batch
+ * Ask the queue for the addresses of the next batch of items.
+ */
+template <class T>
+void Queue<T>::const_iterator::nextBatch()
+{
+  batchLength = aQueue->fillBatch(position, batch, queueBatchSize);
+  batchIndex = 0;
+}
+
+
+/** queue iterator increment
+ * Step to the next item, only asking the queue for more items when the
+ * current batch runs out.
+ *
+ * @returns const_iterator This iterator, at the next item.
+ */
+template <class T>
+typename Queue<T>::const_iterator& Queue<T>::const_iterator::operator++()
+{
+  itemIndex++;
+  batchIndex++;
+  if (batchIndex == batchLength)
+  {
+    nextBatch();
+  }
+  return *this;
+}
+
+
+/** queue iterator post increment
+ * @returns const_iterator A copy of this iterator before it was stepped.
+ */
+template <class T>
+typename Queue<T>::const_iterator Queue<T>::const_iterator::operator++(int)
+{
+  const_iterator before = *this;
+  ++(*this);
+  return before;
+}
+
+
+/** queue iterator equivalence
+ * @param rhs Another iterator.
+ *
+ * @returns bool true if both iterators are at the same item of the same
+ *   queue.
+ */
+template <class T>
+bool Queue<T>::const_iterator::operator==(const const_iterator& rhs) const
+{
+  return aQueue == rhs.aQueue && itemIndex == rhs.itemIndex;
+}
+
+
+/** queue iterator inequivalence
+ * @param rhs Another iterator.
+ *
+ * @returns bool true if the iterators are at different items.
+ */
+template <class T>
+bool Queue<T>::const_iterator::operator!=(const const_iterator& rhs) const
+{
+  return !(*this == rhs);
+}
+
+
+
 //-------------------------------------------------------------------------
 /** queue (array) constructor
- * Constructor for queue.  Default to enough room for 100 items
+ * Constructor for queue.  Default to enough room for 100 items, which
+ * is rounded up to a power of two (128).
  * NOTE: the front pointer points directly to the index of the front item, but
  * the backIndex pointer points to the index-1 of the item where next insertion
  * will happen.  
  * NOTE: we treat the items array as a circular buffer, so all increments of
- * indexes must be modulo current allocSize, to wrap backIndex around to beginning.
+ * indexes must be wrapped around (masked with allocSize - 1), to wrap backIndex
+ * around to beginning.
  *
  * @param initialAlloc Initial space to allocate for queue, defaults to
- *   100.
+ *   100.  The queue does not shrink below this.
  */
-AQueue::AQueue(int initialAlloc)
+template <class T>
+AQueue<T>::AQueue(int initialAlloc)
 {
-  allocSize = initialAlloc;
+  allocSize = powerOfTwoAtLeast(initialAlloc);
+  mask = allocSize - 1;
+  minAllocSize = allocSize;
   numitems = 0;
   frontIndex = 0;
-  backIndex = allocSize - 1; // back points to (x-1) % allocSize index
-  items = new int[allocSize];
+  backIndex = mask; // back points to (x-1) & mask index
+  items = new T[allocSize];
 }
 
 
@@ -317,17 +500,22 @@ AQueue::AQueue(int initialAlloc)
  * the backIndex pointer points to the index-1 of the item where next insertion
  * will happen.  
  * NOTE: we treat the items array as a circular buffer, so all increments of
- * indexes must be modulo current allocSize, to wrap backIndex around to beginning.
+ * indexes must be wrapped around (masked with allocSize - 1), to wrap backIndex
+ * around to beginning.
  *
- * @param initialAlloc Initial space to allocate for queue, defaults to
- *   100.
+ * @param initItems The items to put on the queue, the first item is the
+ *   front of the queue.
+ * @param numitems The number of initial items.
  */
-AQueue::AQueue(int initItems[], int numitems)
+template <class T>
+AQueue<T>::AQueue(T initItems[], int numitems)
 {
-  this->allocSize = numitems;
+  this->allocSize = powerOfTwoAtLeast(numitems);
+  this->mask = allocSize - 1;
+  this->minAllocSize = allocSize;
   this->numitems = numitems;
   frontIndex = 0;
-  items = new int[allocSize];
+  items = new T[allocSize];
 
   // copy the initialize items into this queue
   for (int index = 0; index < numitems; index++)
@@ -336,28 +524,154 @@ AQueue::AQueue(int initItems[], int numitems)
   }
 
   // set up the back index
-  backIndex = numitems - 1;
+  backIndex = (numitems - 1) & mask;
 }
 
 
 /** queue (array) destructor
  */
-AQueue::~AQueue()
+template <class T>
+AQueue<T>::~AQueue()
 {
   // free up currently allocated memory
   delete [] items;
 }
 
 
+/** queue (array) power of two at least
+ * @param size A number of items.
+ *
+ * @returns int The smallest power of two that is at least size (and at
+ *   least 1).
+ */
+template <class T>
+int AQueue<T>::powerOfTwoAtLeast(int size)
+{
+  int powerOfTwo = 1;
+  while (powerOfTwo < size)
+  {
+    powerOfTwo *= 2;
+  }
+  return powerOfTwo;
+}
+
+
+/** queue (array) move items
+ * Move a run of items from one array to another, as a single memcpy
+ * for trivially copyable items (like Jobs and ints), or item by item
+ * otherwise.
+ *
+ * @param destination Where to move the items to.
+ * @param source The items to move, the runs may not overlap.
+ * @param count The number of items to move.
+ */
+template <class T>
+void AQueue<T>::moveItems(T* destination, T* source, int count)
+{
+  moveItems(destination, source, count, typename is_trivially_copyable<T>::type());
+}
+
+template <class T>
+void AQueue<T>::moveItems(T* destination, T* source, int count, true_type /* trivial */)
+{
+  if (count > 0)
+  {
+    memcpy(destination, source, count * sizeof(T));
+  }
+}
+
+template <class T>
+void AQueue<T>::moveItems(T* destination, T* source, int count, false_type /* trivial */)
+{
+  for (int index = 0; index < count; index++)
+  {
+    destination[index] = std::move(source[index]);
+  }
+}
+
+
+/** queue (array) release items
+ * Put empty items in a run of slots that have just been emptied, so
+ * items that hold resources (like strings) give them back at once rather
+ * than when the slot is next used.  Trivially destructible items (like
+ * Jobs and ints) hold nothing, and are left as they are.
+ *
+ * @param index The index of the first slot of the run.
+ * @param count The number of slots, the run can wrap around the end
+ *   of the array.
+ */
+template <class T>
+void AQueue<T>::releaseItems(int index, int count)
+{
+  releaseItems(index, count, typename is_trivially_destructible<T>::type());
+}
+
+template <class T>
+void AQueue<T>::releaseItems(int /* index */, int /* count */, true_type /* trivial */)
+{
+}
+
+template <class T>
+void AQueue<T>::releaseItems(int index, int count, false_type /* trivial */)
+{
+  for (int slot = 0; slot < count; slot++)
+  {
+    items[(index + slot) & mask] = T();
+  }
+}
+
+
+/** queue (array) reallocate
+ * Move the queue to newly allocated storage of the given size.  The
+ * circular buffer holds the items in at most two runs, from the front
+ * to the end of the array and from the start of the array to the back,
+ * each of which is moved as a block, to the start of the new storage.
+ *
+ * @param newAllocSize The new allocation, a power of two at least as
+ *   large as the length of the queue.
+ */
+template <class T>
+void AQueue<T>::reallocate(int newAllocSize)
+{
+  T* newItems = new T[newAllocSize];
+
+  int firstRun = allocSize - frontIndex;
+  if (firstRun > numitems)
+  {
+    firstRun = numitems;
+  }
+  moveItems(newItems, items + frontIndex, firstRun);
+  moveItems(newItems + firstRun, items, numitems - firstRun);
+
+  // free up the old space, start using the new space
+  delete [] items;
+  items = newItems;
+  allocSize = newAllocSize;
+  mask = allocSize - 1;
+  frontIndex = 0;
+  backIndex = (numitems - 1) & mask;
+}
+
+
 /** queue (array) clear
- * Function to initialize the queue back to an empty state.
+ * Function to initialize the queue back to an empty state, giving back
+ * any memory over the minimum allocation.
  * Postcondition: frontIndex = 0; backIndex = allocSize-1; numitems=0; isEmpty() == true
  */
-void AQueue::clear()
+template <class T>
+void AQueue<T>::clear()
 {
-  frontIndex = 0;
-  backIndex = allocSize - 1;
+  releaseItems(frontIndex, numitems);
   numitems = 0;
+  if (allocSize > minAllocSize)
+  {
+    delete [] items;
+    allocSize = minAllocSize;
+    mask = allocSize - 1;
+    items = new T[allocSize];
+  }
+  frontIndex = 0;
+  backIndex = mask;
 }
 
 
@@ -367,7 +681,8 @@ void AQueue::clear()
  * @returns returns true if the queue is empty, otherwise
  *   returns false.
  */
-bool AQueue::isEmpty() const
+template <class T>
+bool AQueue<T>::isEmpty() const
 {
   return numitems == 0;
 }
@@ -379,12 +694,78 @@ bool AQueue::isEmpty() const
  * @returns returns true if the queue is full, otherwise
  *   returns false.
  */
-bool AQueue::isFull() const
+template <class T>
+bool AQueue<T>::isFull() const
 {
   return numitems == allocSize;
 }
 
 
+/** queue (array) capacity
+ * @returns int The number of items the queue can hold before it has to
+ *   grow.
+ */
+template <class T>
+int AQueue<T>::capacity() const
+{
+  return allocSize;
+}
+
+
+/** queue (array) reserve
+ * Make room for at least the given number of items, so that enqueueing
+ * up to that many does not reallocate, and keep at least that much room
+ * allocated when the queue empties.
+ *
+ * @param capacity The number of items to make room for.
+ */
+template <class T>
+void AQueue<T>::reserve(int capacity)
+{
+  int newAllocSize = powerOfTwoAtLeast(capacity);
+  if (newAllocSize > minAllocSize)
+  {
+    minAllocSize = newAllocSize;
+  }
+  if (newAllocSize > allocSize)
+  {
+    reallocate(newAllocSize);
+  }
+}
+
+
+/** queue (array) grow
+ * Double the allocated space of the queue when it is full.  Items are
+ * moved (not copied) to the new storage.
+ */
+template <class T>
+void AQueue<T>::grow()
+{
+  reallocate(2 * allocSize);
+}
+
+
+/** queue (array) shrink if sparse
+ * Halve the allocated space, as many times as needed, while the queue
+ * is no more than a quarter full and above its minimum allocation.
+ * After shrinking the queue is at most half full, so it has to double
+ * in length before growing again.
+ */
+template <class T>
+void AQueue<T>::shrinkIfSparse()
+{
+  int newAllocSize = allocSize;
+  while (newAllocSize > minAllocSize && numitems <= newAllocSize / 4)
+  {
+    newAllocSize /= 2;
+  }
+  if (newAllocSize != allocSize)
+  {
+    reallocate(newAllocSize);
+  }
+}
+
+
 /** queue (array) enqueue
  * Add newItem to the back of the queue.
  * Preconditon: The queue exists
@@ -392,39 +773,94 @@ bool AQueue::isFull() const
  *   of the queue.
  * @param newItem The new item to add to the frontIndex of this queue.
  */
-void AQueue::enqueue(const int& newItem)
+template <class T>
+void AQueue<T>::enqueue(const T& newItem)
+{
+  emplace(newItem);
+}
+
+
+/** queue (array) enqueue (move)
+ * Move newItem onto the back of the queue.
+ *
+ * @param newItem The new item to move on to the back of this queue.
+ */
+template <class T>
+void AQueue<T>::enqueue(T&& newItem)
+{
+  emplace(std::move(newItem));
+}
+
+
+/** queue (array) emplace
+ * Construct a new item on the back of the queue from the given
+ * constructor arguments.  Every slot of the array holds an item, so the
+ * old item of the back slot is destroyed and the new item constructed
+ * in its place, there is no temporary item to move from.
+ *
+ * @param args The arguments to construct the new item with.
+ */
+template <class T>
+template <class... Args>
+void AQueue<T>::emplace(Args&&... args)
 {
   // if queue is full, grow it
   if (isFull())
   {
-    // double the current size
-    int newAllocSize = 2 * allocSize;
+    grow();
+  }
 
-    // alloc the new space
-    int* newItems = new int[newAllocSize];
+  // construct the item in the slot after the back, if the constructor
+  // throws the slot gets an empty item again and the queue is unchanged
+  T* slot = &items[(backIndex + 1) & mask];
+  slot->~T();
+  try
+  {
+    new (slot) T(std::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    new (slot) T();
+    throw;
+  }
 
-    // and copy the queue to the new storage space
-    // since we are copying anyway, we shift the items from the old
-    // frontIndex back to index 0
-    int oldIndex = frontIndex;
-    for (int index = 0; index < numitems; index++)
-    {
-      newItems[index] = items[oldIndex];
-      oldIndex = (oldIndex + 1) % allocSize;
-    }
-    frontIndex = 0;
-    backIndex = numitems-1;
+  // increment our top
+  backIndex = (backIndex + 1) & mask;
+  numitems++;
+}
 
-    // free up the old space, start using the new space
-    delete [] items;
-    items = newItems;
-    allocSize = newAllocSize;
+
+/** queue (array) enqueue range
+ * Add copies of a run of items to the back of the queue, in order.  The
+ * queue grows at most once, and the items are copied in at most two
+ * blocks (before and after the end of the circular buffer).
+ *
+ * @param newItems The items to add, newItems[0] goes on first.
+ * @param count The number of items to add.
+ */
+template <class T>
+void AQueue<T>::enqueueRange(const T* newItems, int count)
+{
+  if (count <= 0)
+  {
+    return;
+  }
+  if (numitems + count > allocSize)
+  {
+    reallocate(powerOfTwoAtLeast(numitems + count));
   }
 
-  // add the item, and increment our top
-  backIndex = (backIndex + 1) % allocSize;
-  numitems++;
-  items[backIndex] = newItem;
+  int start = (backIndex + 1) & mask;
+  int firstRun = allocSize - start;
+  if (firstRun > count)
+  {
+    firstRun = count;
+  }
+  copy(newItems, newItems + firstRun, items + start);
+  copy(newItems + firstRun, newItems + count, items);
+
+  backIndex = (backIndex + count) & mask;
+  numitems += count;
 }
 
 
@@ -437,7 +873,8 @@ void AQueue::enqueue(const int& newItem)
  * @returns T The item of type T currently on the front of this
  *   queue.
  */
-int AQueue::front() const
+template <class T>
+const T& AQueue<T>::front() const
 {
   //assert(topIndex != 0);
   if (isEmpty())
@@ -459,7 +896,8 @@ int AQueue::front() const
  *   exception; otherwise the front element of the queue is removed
  *   from the queue.
  */
-void AQueue::dequeue()
+template <class T>
+void AQueue<T>::dequeue()
 {
   // assert(topIndex != 0);
   if (isEmpty())
@@ -468,9 +906,52 @@ void AQueue::dequeue()
   }
   else
   {
+    releaseItems(frontIndex, 1);
     numitems--;
-    frontIndex = (frontIndex + 1) % allocSize;
+    frontIndex = (frontIndex + 1) & mask;
+    if (numitems <= (allocSize >> 2) && allocSize > minAllocSize)
+    {
+      shrinkIfSparse();
+    }
+  }
+}
+
+
+/** queue (array) dequeue range
+ * Remove up to count items from the front of the queue, moving them out
+ * in at most two blocks.
+ *
+ * @param items Returns the items removed, the front item first.
+ * @param count The most items to remove.
+ *
+ * @returns int The number of items removed, less than count if the
+ *   queue emptied.
+ */
+template <class T>
+int AQueue<T>::dequeueRange(T* items, int count)
+{
+  if (count > numitems)
+  {
+    count = numitems;
+  }
+  if (count <= 0)
+  {
+    return 0;
   }
+
+  int firstRun = allocSize - frontIndex;
+  if (firstRun > count)
+  {
+    firstRun = count;
+  }
+  moveItems(items, this->items + frontIndex, firstRun);
+  moveItems(items + firstRun, this->items, count - firstRun);
+  releaseItems(frontIndex, count);
+
+  frontIndex = (frontIndex + count) & mask;
+  numitems -= count;
+  shrinkIfSparse();
+  return count;
 }
 
 
@@ -479,31 +960,37 @@ void AQueue::dequeue()
  *
  * @returns length Returns the current queue length.
  */
-int AQueue::length() const
+template <class T>
+int AQueue<T>::length() const
 {
   return numitems;
 }
 
 
-/** queue (array) tostring
- * Represent this queue as a string.
+/** queue (array) fill batch
+ * Hand out the addresses of the next items of a traversal, see
+ * Queue::fillBatch().  The position is an index from the front.
  *
- * @returns string Returns the contents of queue as a string.
+ * @param position Where the traversal has got to.
+ * @param batch Filled in with the addresses of the items.
+ * @param maxItems The most items to hand out.
+ *
+ * @returns int The number of items handed out.
  */
-string AQueue::tostring() const
+template <class T>
+int AQueue<T>::fillBatch(QueuePosition& position, const T* batch[], int maxItems) const
 {
-  ostringstream out;
-  
-  out << "Front: ";
-  int index = frontIndex;
-  while (index != (backIndex + 1) % allocSize)
+  int count = min(maxItems, numitems - position.index);
+  int index = (frontIndex + position.index) & mask;
+
+  for (int item = 0; item < count; item++)
   {
-    out << items[index] << " ";
-    index++;
+    batch[item] = &items[index];
+    index = (index + 1) & mask;
   }
-  out << ":Back" << endl;
-  
-  return out.str();
+  position.index += count;
+
+  return count;
 }
 
 
@@ -520,7 +1007,8 @@ string AQueue::tostring() const
  * 
  * @returns T Returns the item at "index" on the queue.
  */
-const int& AQueue::operator[](int index) const
+template <class T>
+const T& AQueue<T>::operator[](int index) const
 {
   // bounds checking, we will throw our stack exception if fails
   if (index < 0 || index >= numitems)
@@ -532,91 +1020,218 @@ const int& AQueue::operator[](int index) const
   // have to calculated the indicated index by hand
   else
   {
-    return items[(frontIndex + index) % allocSize];
+    return items[(frontIndex + index) & mask];
   }
 }
 
 
 
 //-------------------------------------------------------------------------
-/** queue (list) constructor
- * Constructor for linked list version of queue.
- * An empty queue is indicated by both front and back
- * pointers pointing to null.
+/** node pool constructor
+ * Create an empty pool, no memory is allocated until the first node
+ * is needed.
  */
-LQueue::LQueue()
+template <class T>
+NodePool<T>::NodePool()
 {
-  queueFront = NULL;
-  queueBack = NULL;
-  numitems = 0;
+  freeList = NULL;
+  nextSlabNodes = firstSlabNodes;
+  numAllocations = 0;
+  numNodes = 0;
+  numLive = 0;
 }
 
 
-/** queue (list) destructor
- * Destructor for linked list version of queue.
+/** node pool destructor
+ * Give all of the slabs back to the system.  Any nodes still handed out
+ * must already have been destroyed, the pool does not run destructors.
  */
-LQueue::~LQueue()
+template <class T>
+NodePool<T>::~NodePool()
 {
-  clear();
+  for (int index = 0; index < (int)slabs.size(); index++)
+  {
+    ::operator delete(slabs[index]);
+  }
 }
 
 
-/** queue (list) clear
- * This will empty out the queue.  This method frees up all of the
- * dynamically allocated memory being used by the queue linked list
- * nodes.
+/** node pool allocate slab
+ * Allocate a new slab of nodes and put all of its nodes on the free
+ * list.  Each slab is double the size of the previous one, up to
+ * maxSlabNodes, so the number of allocations grows only logarithmically
+ * with the size of the queue, and then linearly in big steps.
  */
-void LQueue::clear()
+template <class T>
+void NodePool<T>::allocateSlab()
 {
-  Node* temp;
-
-  // iterate through Nodes in queue, freeing them up
-  // as we visit them
-  while (queueFront != NULL)
+  size_t nodeSize = (sizeof(Node<T>) > sizeof(FreeNode)) ? sizeof(Node<T>) : sizeof(FreeNode);
+  char* slab = static_cast<char*>(::operator new(nodeSize * nextSlabNodes));
+  slabs.push_back(slab);
+  numAllocations++;
+  numNodes += nextSlabNodes;
+
+  // link the new nodes onto the free list, last node first so that
+  // nodes are handed out in address order
+  for (int index = nextSlabNodes - 1; index >= 0; index--)
   {
-    temp = queueFront;
-    queueFront = queueFront->link;
-
-    // dellocate this Node memory
-    delete temp;
+    FreeNode* node = reinterpret_cast<FreeNode*>(slab + index * nodeSize);
+    node->next = freeList;
+    freeList = node;
   }
 
-  // make sure all private members are cleard correctly
-  queueBack = NULL;
-  numitems = 0;
+  if (nextSlabNodes < maxSlabNodes)
+  {
+    nextSlabNodes *= 2;
+  }
 }
 
 
-/** queue (list) isEmpty
- * Check if queue is empty or not.
- * 
- * @returns true if the queue is currently empty, or
- *   false otherwise.
+/** node pool create
+ * Take a node off of the free list (allocating a new slab if the free
+ * list is empty) and construct it in place with the given arguments.
+ *
+ * @param args The arguments to construct the node's item with.
+ *
+ * @returns Node<T>* A new node, with its link set to NULL.
  */
-bool LQueue::isEmpty() const
+template <class T>
+template <class... Args>
+Node<T>* NodePool<T>::create(Args&&... args)
 {
-  return queueFront == NULL;
-  // return numitems == 0;
+  if (freeList == NULL)
+  {
+    allocateSlab();
+  }
+
+  FreeNode* memory = freeList;
+  freeList = freeList->next;
+  numLive++;
+  return new (memory) Node<T>(std::forward<Args>(args)...);
 }
 
 
-/** queue (list) enqueue
- * Add the indicated item onto the back of the queue.
+/** node pool destroy
+ * Destroy the given node and put its memory back on the free list.
  *
- * @param newItem The new item we will add to the back of
- *   this queue.
+ * @param node A node created by this pool.
+ */
+template <class T>
+void NodePool<T>::destroy(Node<T>* node)
+{
+  node->~Node<T>();
+  FreeNode* memory = reinterpret_cast<FreeNode*>(node);
+  memory->next = freeList;
+  freeList = memory;
+  numLive--;
+}
+
+
+/** node pool allocations
+ * @returns long long The number of times this pool has allocated
+ *   memory from the system.
+ */
+template <class T>
+long long NodePool<T>::allocations() const
+{
+  return numAllocations;
+}
+
+
+/** node pool capacity
+ * @returns long long The number of nodes the pool has memory for.
+ */
+template <class T>
+long long NodePool<T>::capacity() const
+{
+  return numNodes;
+}
+
+
+/** node pool live
+ * @returns long long The number of nodes currently handed out.
+ */
+template <class T>
+long long NodePool<T>::live() const
+{
+  return numLive;
+}
+
+
+
+//-------------------------------------------------------------------------
+/** queue (list) constructor
+ * Constructor for linked list version of queue.
+ * An empty queue is indicated by both front and back
+ * pointers pointing to null.
+ */
+template <class T>
+LQueue<T>::LQueue()
+{
+  queueFront = NULL;
+  queueBack = NULL;
+  numitems = 0;
+}
+
+
+/** queue (list) destructor
+ * Destructor for linked list version of queue.
+ */
+template <class T>
+LQueue<T>::~LQueue()
+{
+  clear();
+}
+
+
+/** queue (list) clear
+ * This will empty out the queue.  This method gives all of the
+ * queue linked list nodes back to the node pool.
  */
+template <class T>
+void LQueue<T>::clear()
+{
+  Node<T>* temp;
+
+  // iterate through Nodes in queue, freeing them up
+  // as we visit them
+  while (queueFront != NULL)
+  {
+    temp = queueFront;
+    queueFront = queueFront->link;
+
+    // give this Node back to the pool
+    nodePool.destroy(temp);
+  }
+
+  // make sure all private members are cleard correctly
+  queueBack = NULL;
+  numitems = 0;
+}
+
 
-void LQueue::enqueue(const int& newItem)
+/** queue (list) isEmpty
+ * Check if queue is empty or not.
+ * 
+ * @returns true if the queue is currently empty, or
+ *   false otherwise.
+ */
+template <class T>
+bool LQueue<T>::isEmpty() const
 {
-  // dynamically allocate space for the new Node to hold
-  // this newItem
-  Node* newNode = new Node;
+  return queueFront == NULL;
+  // return numitems == 0;
+}
 
-  // initialize the node
-  newNode->item = newItem;
-  newNode->link = NULL;
 
+/** queue (list) append node
+ * Link the given (new) node onto the back of the queue.
+ *
+ * @param newNode The node holding the new item, its link must be NULL.
+ */
+template <class T>
+void LQueue<T>::appendNode(Node<T>* newNode)
+{
   // if the queue is empty, then this new node is the
   // front and back node
   if (queueFront == NULL)
@@ -635,13 +1250,54 @@ void LQueue::enqueue(const int& newItem)
 }
 
 
+/** queue (list) enqueue
+ * Add the indicated item onto the back of the queue.
+ *
+ * @param newItem The new item we will add to the back of
+ *   this queue.
+ */
+template <class T>
+void LQueue<T>::enqueue(const T& newItem)
+{
+  appendNode(nodePool.create(newItem));
+}
+
+
+/** queue (list) enqueue (move)
+ * Move the indicated item onto the back of the queue.
+ *
+ * @param newItem The new item we will move to the back of
+ *   this queue.
+ */
+template <class T>
+void LQueue<T>::enqueue(T&& newItem)
+{
+  appendNode(nodePool.create(std::move(newItem)));
+}
+
+
+/** queue (list) emplace
+ * Construct a new item on the back of the queue, directly in its
+ * node, from the given constructor arguments.
+ *
+ * @param args The arguments to construct the new item with.
+ */
+template <class T>
+template <class... Args>
+void LQueue<T>::emplace(Args&&... args)
+{
+  appendNode(nodePool.create(std::forward<Args>(args)...));
+}
+
+
 /** queue (list) front
  * Return the front item from the queue.
  *
  * @returns T Returns the item currently at the front of
  *   this queue.
  */
-int LQueue::front() const
+template <class T>
+const T& LQueue<T>::front() const
 {
   //assert(queueFront != NULL)
   if (isEmpty())
@@ -661,7 +1317,8 @@ int LQueue::front() const
  * an empty queue.  This method throws an exception if dequeue is attempted
  * from an empty queue.
  */
-void LQueue::dequeue()
+template <class T>
+void LQueue<T>::dequeue()
 {
   //assert(queueTop != NULL)
   if (isEmpty())
@@ -671,7 +1328,7 @@ void LQueue::dequeue()
   else
   {
     // keep track of the current front, so we can deallocate
-    Node* temp;
+    Node<T>* temp;
     temp = queueFront;
 
     // remove the front item from the queue
@@ -684,8 +1341,8 @@ void LQueue::dequeue()
     }
     numitems--;
     
-    // deallocate the old top now
-    delete temp;
+    // give the old front back to the pool now
+    nodePool.destroy(temp);
   }
 }
 
@@ -695,31 +1352,44 @@ void LQueue::dequeue()
  *
  * @returns int The current queue length
  */
-int LQueue::length() const
+template <class T>
+int LQueue<T>::length() const
 {
   return numitems;
 }
 
 
-/** queue (array) tostring
- * Represent this queue as a string.
+/** queue (list) fill batch
+ * Hand out the addresses of the next items of a traversal, see
+ * Queue::fillBatch().  The position keeps the next node to visit, so
+ * the list is walked once however many batches it takes.
  *
- * @returns string Returns the contents of queue as a string.
+ * @param position Where the traversal has got to.
+ * @param batch Filled in with the addresses of the items.
+ * @param maxItems The most items to hand out.
+ *
+ * @returns int The number of items handed out.
  */
-string LQueue::tostring() const
+template <class T>
+int LQueue<T>::fillBatch(QueuePosition& position, const T* batch[], int maxItems) const
 {
-  ostringstream out;
-  Node* temp = queueFront;
-  
-  out << "Front: ";
-  while (temp != NULL)
+  const Node<T>* node = queueFront;
+  if (position.index > 0)
   {
-    out << temp->item << " ";
-    temp = temp->link;
+    node = static_cast<const Node<T>*>(position.node);
   }
-  out << ":Back" << endl;
 
-  return out.str();
+  int count = 0;
+  while (count < maxItems && node != NULL)
+  {
+    batch[count] = &node->item;
+    count++;
+    node = node->link;
+  }
+  position.index += count;
+  position.node = node;
+
+  return count;
 }
 
 
@@ -736,7 +1406,8 @@ string LQueue::tostring() const
  * 
  * @returns T Returns the item at "index" on the queue.
  */
-const int& LQueue::operator[](int index) const
+template <class T>
+const T& LQueue<T>::operator[](int index) const
 {
   // bounds checking, we will throw our stack exception if fails
   if (index < 0 || index >= numitems)
@@ -749,7 +1420,7 @@ const int& LQueue::operator[](int index) const
   else
   {
     int currentIndex = 0;
-    Node* currentNode = queueFront;
+    Node<T>* currentNode = queueFront;
     
     while (currentIndex != index)
     {
@@ -761,31 +1432,87 @@ const int& LQueue::operator[](int index) const
   }
 }
 
+/** queue (list) node allocations
+ * @returns long long The number of times this queue has allocated
+ *   memory for its nodes, see NodePool.
+ */
+template <class T>
+long long LQueue<T>::nodeAllocations() const
+{
+  return nodePool.allocations();
+}
+
+
+/** queue (list) node capacity
+ * @returns long long The number of nodes this queue has memory for.
+ */
+template <class T>
+long long LQueue<T>::nodeCapacity() const
+{
+  return nodePool.capacity();
+}
+
 //start// required code, priority queue::enqueue()
-void PriorityQueues::enqueue(const Job& newItems)
+template <class T>
+void PriorityQueue<T>::enqueue(const T& newItem)
 {
-  bool i=false;
-  Node* newNode = new Node;
-  Node* n = new Node;
-  Node* n2 = new Node;
-  int newItem = newItems.getPriority();
+  insertNode(LQueue<T>::nodePool.create(newItem));
+}
+
+
+/** priority queue (list) enqueue (move)
+ * Move the item into the linked list ordered by priority.
+ *
+ * @param newItem The new item to move on to this queue.
+ */
+template <class T>
+void PriorityQueue<T>::enqueue(T&& newItem)
+{
+  insertNode(LQueue<T>::nodePool.create(std::move(newItem)));
+}
+
+
+/** priority queue (list) emplace
+ * Construct a new item in its node from the given constructor
+ * arguments, and insert it into the linked list ordered by priority.
+ *
+ * @param args The arguments to construct the new item with.
+ */
+template <class T>
+template <class... Args>
+void PriorityQueue<T>::emplace(Args&&... args)
+{
+  insertNode(LQueue<T>::nodePool.create(std::forward<Args>(args)...));
+}
+
 
-  newNode->item = newItem;
-  newNode->link = NULL;
+/** priority queue (list) insert node
+ * Insert the node into the linked list ordered by priority, after
+ * any items of equal priority.
+ *
+ * @param newNode The node holding the new item, its link must be NULL.
+ */
+template <class T>
+void PriorityQueue<T>::insertNode(Node<T>* newNode)
+{
+  bool i=false;
+  Node<T>* n;
+  Node<T>* n2;
+  const T& newItem = newNode->item;
   
-  if (LQueue::queueFront==NULL)
+  if (LQueue<T>::queueFront==NULL)
   {
-    LQueue::queueFront = newNode;
-  	LQueue::queueBack = newNode;
+    LQueue<T>::queueFront = newNode;
+  	LQueue<T>::queueBack = newNode;
   }
-  else if(newItem > LQueue::queueFront->item)
+  else if(newItem > LQueue<T>::queueFront->item)
   {
-  	newNode->link=LQueue::queueFront;
-	LQueue::queueFront=newNode;
+  	newNode->link=LQueue<T>::queueFront;
+	LQueue<T>::queueFront=newNode;
   }
   else 
   {
-  	n=LQueue::queueFront;
+  	n=LQueue<T>::queueFront;
   	n2=n->link;	
   	while(n2!=NULL)
   	{
@@ -801,16 +1528,993 @@ void PriorityQueues::enqueue(const Job& newItems)
 	}	
 	if(i!=true)
 	{
-		LQueue::queueBack->link=newNode;
-	LQueue::queueBack=newNode;	
+		LQueue<T>::queueBack->link=newNode;
+	LQueue<T>::queueBack=newNode;	
 	}
   }
-  LQueue::numitems++;
+  LQueue<T>::numitems++;
 }
 //end
 
 //-------------------------------------------------------------------------
+/** priority queue (heap) constructor
+ * Constructor for the heap based priority queue.  The heap starts out
+ * empty, storage is grown as needed by the underlying vector.
+ *
+ * @param arity The number of children of each node in the heap, defaults
+ *   to a 4-ary heap.  Values less than 2 are treated as a binary heap.
+ * @param order The ordering policy, only needed for policies with state.
+ */
+template <class T, class Order>
+HeapPriorityQueue<T, Order>::HeapPriorityQueue(int arity, const Order& order)
+  : order(order)
+{
+  this->arity = (arity < 2) ? 2 : arity;
+  orderedValid = false;
+}
+
+
+/** priority queue (heap) arity getter
+ * @returns int The number of children of each node in the heap.
+ */
+template <class T, class Order>
+int HeapPriorityQueue<T, Order>::getArity() const
+{
+  return arity;
+}
+
+
+/** priority queue (heap) ordering
+ * Determine if lhs should come off of the queue before rhs, using the
+ * Order policy.  By default this is comesBefore(), for which higher
+ * priority Jobs go first, and for equal priorities the job with the
+ * smaller id (the one created first) goes first, so that equal priority
+ * items are served in FIFO order.
+ *
+ * @param lhs The item on the left hand side of the comparison.
+ * @param rhs The item on the right hand side of the comparison.
+ *
+ * @returns bool True if lhs should be dequeued before rhs.
+ */
+template <class T, class Order>
+bool HeapPriorityQueue<T, Order>::higherPriority(const T& lhs, const T& rhs) const
+{
+  return order.before(lhs, rhs);
+}
+
+
+/** priority queue (heap) sift up
+ * Move the item at index up towards the root until its parent
+ * has higher priority.  We shift parents down into the hole rather
+ * than swapping, so each level costs a single move.
+ *
+ * @param index The index of the item to move up the heap.
+ */
+template <class T, class Order>
+void HeapPriorityQueue<T, Order>::siftUp(int index)
+{
+  T item = std::move(items[index]);
+
+  while (index > 0)
+  {
+    int parent = (index - 1) / arity;
+    if (!higherPriority(item, items[parent]))
+    {
+      break;
+    }
+    items[index] = std::move(items[parent]);
+    index = parent;
+  }
+  items[index] = std::move(item);
+}
+
+
+/** priority queue (heap) sift down
+ * Move the item at index down the heap, swapping with the highest
+ * priority of its children, until the heap property is restored.
+ *
+ * @param index The index of the item to move down the heap.
+ */
+template <class T, class Order>
+void HeapPriorityQueue<T, Order>::siftDown(int index)
+{
+  int size = items.size();
+  T item = std::move(items[index]);
+
+  while (true)
+  {
+    int firstChild = index * arity + 1;
+    if (firstChild >= size)
+    {
+      break;
+    }
+
+    // find the highest priority child of this node
+    int lastChild = firstChild + arity;
+    if (lastChild > size)
+    {
+      lastChild = size;
+    }
+    int best = firstChild;
+    for (int child = firstChild + 1; child < lastChild; child++)
+    {
+      if (higherPriority(items[child], items[best]))
+      {
+        best = child;
+      }
+    }
+
+    if (!higherPriority(items[best], item))
+    {
+      break;
+    }
+    items[index] = std::move(items[best]);
+    index = best;
+  }
+  items[index] = std::move(item);
+}
+
+
+/** priority queue (heap) build ordered
+ * The heap only keeps the front item in place, so to support indexing
+ * we sort a copy of the items into dequeue order.  This is O(n log n)
+ * and only done when operator[] is used after the queue changed, which
+ * is meant for testing and display, not for the simulation itself.
+ */
+template <class T, class Order>
+void HeapPriorityQueue<T, Order>::buildOrdered() const
+{
+  ordered = items;
+  sort(ordered.begin(), ordered.end(), [this](const T& lhs, const T& rhs)
+       {
+	 return higherPriority(lhs, rhs);
+       });
+  orderedValid = true;
+}
+
 
-// Assignment 11
-// You should add the implemenation of your PriorityQueue
-// enqueue() method here.
+/** priority queue (heap) clear
+ * Empty out the queue.  The allocated storage is kept for reuse.
+ */
+template <class T, class Order>
+void HeapPriorityQueue<T, Order>::clear()
+{
+  items.clear();
+  orderedValid = false;
+}
+
+
+/** priority queue (heap) isEmpty
+ * Check if queue is empty or not.
+ *
+ * @returns true if the queue is currently empty, or
+ *   false otherwise.
+ */
+template <class T, class Order>
+bool HeapPriorityQueue<T, Order>::isEmpty() const
+{
+  return items.empty();
+}
+
+
+/** priority queue (heap) enqueue
+ * Add the item to the queue in O(log n) time, by putting it at the
+ * bottom of the heap and sifting it up to its place.
+ *
+ * @param newItem The new item we will add to this queue.
+ */
+template <class T, class Order>
+void HeapPriorityQueue<T, Order>::enqueue(const T& newItem)
+{
+  emplace(newItem);
+}
+
+
+/** priority queue (heap) enqueue (move)
+ * Move the item on to the queue in O(log n) time.
+ *
+ * @param newItem The new item we will move on to this queue.
+ */
+template <class T, class Order>
+void HeapPriorityQueue<T, Order>::enqueue(T&& newItem)
+{
+  emplace(std::move(newItem));
+}
+
+
+/** priority queue (heap) emplace
+ * Construct a new item at the bottom of the heap from the given
+ * constructor arguments, and sift it up to its place.
+ *
+ * @param args The arguments to construct the new item with.
+ */
+template <class T, class Order>
+template <class... Args>
+void HeapPriorityQueue<T, Order>::emplace(Args&&... args)
+{
+  items.emplace_back(std::forward<Args>(args)...);
+  siftUp(items.size() - 1);
+  orderedValid = false;
+}
+
+
+/** priority queue (heap) front
+ * Return the front item from the queue, without removing it.
+ *
+ * @returns T Returns the highest priority item currently on this
+ *   queue.
+ */
+template <class T, class Order>
+const T& HeapPriorityQueue<T, Order>::front() const
+{
+  if (isEmpty())
+  {
+    throw EmptyQueueException("HeapPriorityQueue<T>::front()");
+  }
+  return items[0];
+}
+
+
+/** priority queue (heap) dequeue
+ * Remove the highest priority item from the queue in O(log n) time.
+ * The last item of the heap is moved to the root and sifted down.
+ */
+template <class T, class Order>
+void HeapPriorityQueue<T, Order>::dequeue()
+{
+  if (isEmpty())
+  {
+    throw EmptyQueueException("HeapPriorityQueue<T>::dequeue()");
+  }
+
+  items[0] = std::move(items.back());
+  items.pop_back();
+  if (!items.empty())
+  {
+    siftDown(0);
+  }
+  orderedValid = false;
+}
+
+
+/** priority queue (heap) length
+ * Accessor method to return the current length of this queue.
+ *
+ * @returns int The current queue length
+ */
+template <class T, class Order>
+int HeapPriorityQueue<T, Order>::length() const
+{
+  return items.size();
+}
+
+
+/** priority queue (heap) fill batch
+ * Hand out the addresses of the next items of a traversal, in the
+ * order they will be dequeued, see Queue::fillBatch().  Like operator[],
+ * the first traversal after the queue changes sorts a snapshot of the
+ * items, O(n log n).
+ *
+ * @param position Where the traversal has got to.
+ * @param batch Filled in with the addresses of the items.
+ * @param maxItems The most items to hand out.
+ *
+ * @returns int The number of items handed out.
+ */
+template <class T, class Order>
+int HeapPriorityQueue<T, Order>::fillBatch(QueuePosition& position, const T* batch[], int maxItems) const
+{
+  if (!orderedValid)
+  {
+    buildOrdered();
+  }
+
+  int count = min(maxItems, length() - position.index);
+  for (int item = 0; item < count; item++)
+  {
+    batch[item] = &ordered[position.index + item];
+  }
+  position.index += count;
+
+  return count;
+}
+
+
+/** priority queue (heap) indexing operator
+ * Access internel elements of queue using indexing operator[], where
+ * index 0 is the front of the queue.  Since a heap is not kept in
+ * sorted order, the first index after the queue changes costs
+ * O(n log n) to sort a snapshot, further indexing is O(1).
+ *
+ * @param index The index of the item on the queue we want to access.
+ *
+ * @returns T Returns the item at "index" on the queue.
+ */
+template <class T, class Order>
+const T& HeapPriorityQueue<T, Order>::operator[](int index) const
+{
+  if (index < 0 || index >= length())
+  {
+    throw InvalidIndexQueueException("HeapPriorityQueue<T>::operator[]");
+  }
+
+  if (!orderedValid)
+  {
+    buildOrdered();
+  }
+  return ordered[index];
+}
+
+
+
+//-------------------------------------------------------------------------
+/** indexed priority queue constructor
+ * Constructor for the addressable heap, which starts out empty.
+ */
+template <class T, class Order, class Key>
+IndexedHeapPriorityQueue<T, Order, Key>::IndexedHeapPriorityQueue()
+{
+}
+
+
+/** indexed priority queue place
+ * Put an item at the given heap index, and record its position.
+ *
+ * @param index The heap index to put the item at.
+ * @param item The item to move into place.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::place(int index, T&& item)
+{
+  int id = Key::key(item);
+  if (id >= (int)positions.size())
+  {
+    positions.resize(id + 1, -1);
+  }
+  positions[id] = index;
+  items[index] = std::move(item);
+}
+
+
+/** indexed priority queue sift up
+ * Move the item at index up towards the root until its parent comes
+ * before it, keeping the positions of the moved items up to date.
+ *
+ * @param index The index of the item to move up the heap.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::siftUp(int index)
+{
+  T item = std::move(items[index]);
+
+  while (index > 0)
+  {
+    int parent = (index - 1) / 2;
+    if (!Order::before(item, items[parent]))
+    {
+      break;
+    }
+    place(index, std::move(items[parent]));
+    index = parent;
+  }
+  place(index, std::move(item));
+}
+
+
+/** indexed priority queue sift down
+ * Move the item at index down the heap until both of its children come
+ * after it, keeping the positions of the moved items up to date.
+ *
+ * @param index The index of the item to move down the heap.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::siftDown(int index)
+{
+  int size = items.size();
+  T item = std::move(items[index]);
+
+  while (true)
+  {
+    int child = 2 * index + 1;
+    if (child >= size)
+    {
+      break;
+    }
+    if (child + 1 < size && Order::before(items[child + 1], items[child]))
+    {
+      child++;
+    }
+    if (!Order::before(items[child], item))
+    {
+      break;
+    }
+    place(index, std::move(items[child]));
+    index = child;
+  }
+  place(index, std::move(item));
+}
+
+
+/** indexed priority queue resift
+ * Move the item at index up or down the heap to its place, after it
+ * has been changed or moved there.
+ *
+ * @param index The index of the item to move.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::resift(int index)
+{
+  if (index > 0 && Order::before(items[index], items[(index - 1) / 2]))
+  {
+    siftUp(index);
+  }
+  else
+  {
+    siftDown(index);
+  }
+}
+
+
+/** indexed priority queue remove at
+ * Remove the item at the given heap index, by moving the last item
+ * into its place and sifting that up or down.
+ *
+ * @param index The heap index of the item to remove.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::removeAt(int index)
+{
+  positions[Key::key(items[index])] = -1;
+  int last = items.size() - 1;
+  if (index != last)
+  {
+    place(index, std::move(items[last]));
+  }
+  items.pop_back();
+
+  if (index >= (int)items.size())
+  {
+    return;
+  }
+  // the moved item may belong above or below the hole
+  resift(index);
+}
+
+
+/** indexed priority queue clear
+ * Empty out the queue.  The allocated storage is kept for reuse.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::clear()
+{
+  for (int index = 0; index < (int)items.size(); index++)
+  {
+    positions[Key::key(items[index])] = -1;
+  }
+  items.clear();
+}
+
+
+/** indexed priority queue is empty
+ * @returns bool true if the queue is empty, false otherwise.
+ */
+template <class T, class Order, class Key>
+bool IndexedHeapPriorityQueue<T, Order, Key>::isEmpty() const
+{
+  return items.empty();
+}
+
+
+/** indexed priority queue enqueue
+ * Add a copy of the item to the queue, in its place by priority.
+ *
+ * @param newItem The item to add, no item with the same id may be on
+ *   the queue.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::enqueue(const T& newItem)
+{
+  items.push_back(newItem);
+  siftUp(items.size() - 1);
+}
+
+
+/** indexed priority queue enqueue (move)
+ * Move the item onto the queue, in its place by priority.
+ *
+ * @param newItem The item to move onto the queue, no item with the same
+ *   id may be on the queue.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::enqueue(T&& newItem)
+{
+  items.push_back(std::move(newItem));
+  siftUp(items.size() - 1);
+}
+
+
+/** indexed priority queue emplace
+ * Construct a new item in place on the queue.
+ *
+ * @param args The arguments to construct the new item with.
+ */
+template <class T, class Order, class Key>
+template <class... Args>
+void IndexedHeapPriorityQueue<T, Order, Key>::emplace(Args&&... args)
+{
+  items.emplace_back(std::forward<Args>(args)...);
+  siftUp(items.size() - 1);
+}
+
+
+/** indexed priority queue front
+ * @returns T The item that comes first, without removing it.
+ *
+ * @throws EmptyQueueException If the queue is empty.
+ */
+template <class T, class Order, class Key>
+const T& IndexedHeapPriorityQueue<T, Order, Key>::front() const
+{
+  if (isEmpty())
+  {
+    throw EmptyQueueException("IndexedHeapPriorityQueue<T>::front()");
+  }
+  return items[0];
+}
+
+
+/** indexed priority queue dequeue
+ * Remove the item that comes first.
+ *
+ * @throws EmptyQueueException If the queue is empty.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::dequeue()
+{
+  if (isEmpty())
+  {
+    throw EmptyQueueException("IndexedHeapPriorityQueue<T>::dequeue()");
+  }
+  removeAt(0);
+}
+
+
+/** indexed priority queue length
+ * @returns int The number of items on the queue.
+ */
+template <class T, class Order, class Key>
+int IndexedHeapPriorityQueue<T, Order, Key>::length() const
+{
+  return items.size();
+}
+
+
+/** indexed priority queue fill batch
+ * Hand out the addresses of the next items of a traversal, in heap
+ * order like operator[], so only the front item is in its dequeue
+ * position.  See Queue::fillBatch().
+ *
+ * @param position Where the traversal has got to.
+ * @param batch Filled in with the addresses of the items.
+ * @param maxItems The most items to hand out.
+ *
+ * @returns int The number of items handed out.
+ */
+template <class T, class Order, class Key>
+int IndexedHeapPriorityQueue<T, Order, Key>::fillBatch(QueuePosition& position, const T* batch[], int maxItems) const
+{
+  int count = min(maxItems, length() - position.index);
+  for (int item = 0; item < count; item++)
+  {
+    batch[item] = &items[position.index + item];
+  }
+  position.index += count;
+
+  return count;
+}
+
+
+/** indexed priority queue indexing operator
+ * Access the items of the queue in heap order, index 0 is the front of
+ * the queue but the other items are not in dequeue order.
+ *
+ * @param index The heap index of the item.
+ *
+ * @returns T The item at the index.
+ *
+ * @throws InvalidIndexQueueException If the index is out of range.
+ */
+template <class T, class Order, class Key>
+const T& IndexedHeapPriorityQueue<T, Order, Key>::operator[](int index) const
+{
+  if (index < 0 || index >= length())
+  {
+    throw InvalidIndexQueueException("IndexedHeapPriorityQueue<T>::operator[]");
+  }
+  return items[index];
+}
+
+
+/** indexed priority queue contains
+ * @param id An item id.
+ *
+ * @returns bool true if the item with this id is on the queue.
+ */
+template <class T, class Order, class Key>
+bool IndexedHeapPriorityQueue<T, Order, Key>::contains(int id) const
+{
+  return id >= 0 && id < (int)positions.size() && positions[id] >= 0;
+}
+
+
+/** indexed priority queue find
+ * @param id The id of an item on the queue.
+ *
+ * @returns T The item with this id.
+ *
+ * @throws InvalidIndexQueueException If no item with the id is queued.
+ */
+template <class T, class Order, class Key>
+const T& IndexedHeapPriorityQueue<T, Order, Key>::find(int id) const
+{
+  if (!contains(id))
+  {
+    throw InvalidIndexQueueException("IndexedHeapPriorityQueue<T>::find()");
+  }
+  return items[positions[id]];
+}
+
+
+/** indexed priority queue remove
+ * Remove the item with the given id, wherever it is in the queue, in
+ * O(log n).
+ *
+ * @param id The id of the item to remove.
+ *
+ * @throws InvalidIndexQueueException If no item with the id is queued.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::remove(int id)
+{
+  if (!contains(id))
+  {
+    throw InvalidIndexQueueException("IndexedHeapPriorityQueue<T>::remove()");
+  }
+  removeAt(positions[id]);
+}
+
+
+/** indexed priority queue update
+ * Replace the queued item that has the same id as the given item, and
+ * move it to its new place, in O(log n).  This is used when the
+ * priority of a queued item changes.
+ *
+ * @param item The new value of the item.
+ *
+ * @throws InvalidIndexQueueException If no item with the id is queued.
+ */
+template <class T, class Order, class Key>
+void IndexedHeapPriorityQueue<T, Order, Key>::update(const T& item)
+{
+  int id = Key::key(item);
+  if (!contains(id))
+  {
+    throw InvalidIndexQueueException("IndexedHeapPriorityQueue<T>::update()");
+  }
+  int index = positions[id];
+  items[index] = item;
+  resift(index);
+}
+
+
+
+//-------------------------------------------------------------------------
+/** priority queue (bucket) constructor
+ * Constructor for the bucket priority queue, which starts out empty,
+ * with a level for each priority in the range.
+ *
+ * @param minPriority The lowest priority an item can have.
+ * @param maxPriority The highest priority an item can have.
+ * @param priorityPolicy The priority policy of the items.
+ *
+ * @throws PriorityRangeQueueException If the range has more than
+ *   maxLevels priorities, see fitsRange().
+ */
+template <class T, class Priority>
+BucketPriorityQueue<T, Priority>::BucketPriorityQueue(int minPriority, int maxPriority,
+						      const Priority& priorityPolicy)
+  : priorityPolicy(priorityPolicy)
+{
+  if (!fitsRange(minPriority, maxPriority))
+  {
+    throw PriorityRangeQueueException("BucketPriorityQueue<T>::BucketPriorityQueue() "
+				      + to_string(minPriority) + " to "
+				      + to_string(maxPriority));
+  }
+
+  this->minPriority = minPriority;
+  this->maxPriority = maxPriority;
+  // the levels start small, each ring grows to its own working size
+  int numLevels = maxPriority - minPriority + 1;
+  levels = static_cast<AQueue<T>*>(operator new(numLevels * sizeof(AQueue<T>)));
+  for (int level = 0; level < numLevels; level++)
+  {
+    new (&levels[level]) AQueue<T>(16);
+  }
+  occupied = 0;
+  numitems = 0;
+}
+
+
+/** priority queue (bucket) destructor
+ * Free up the rings of the levels.
+ */
+template <class T, class Priority>
+BucketPriorityQueue<T, Priority>::~BucketPriorityQueue()
+{
+  int numLevels = maxPriority - minPriority + 1;
+  for (int level = 0; level < numLevels; level++)
+  {
+    levels[level].~AQueue<T>();
+  }
+  operator delete(levels);
+}
+
+
+/** priority queue (bucket) fits range
+ * @param minPriority The lowest priority of the items.
+ * @param maxPriority The highest priority of the items.
+ *
+ * @returns bool true if a bucket priority queue can hold the range, a
+ *   level for each priority, at most maxLevels of them.
+ */
+template <class T, class Priority>
+bool BucketPriorityQueue<T, Priority>::fitsRange(int minPriority, int maxPriority)
+{
+  return minPriority <= maxPriority
+    && (long long)maxPriority - minPriority < maxLevels;
+}
+
+
+/** priority queue (bucket) min priority getter
+ * @returns int The lowest priority an item can have.
+ */
+template <class T, class Priority>
+int BucketPriorityQueue<T, Priority>::getMinPriority() const
+{
+  return minPriority;
+}
+
+
+/** priority queue (bucket) max priority getter
+ * @returns int The highest priority an item can have.
+ */
+template <class T, class Priority>
+int BucketPriorityQueue<T, Priority>::getMaxPriority() const
+{
+  return maxPriority;
+}
+
+
+/** priority queue (bucket) level of
+ * @param item An item.
+ *
+ * @returns int The level of the item's priority, 0 for maxPriority.
+ *
+ * @throws PriorityRangeQueueException If the priority of the item is
+ *   not in the range of the queue.
+ */
+template <class T, class Priority>
+int BucketPriorityQueue<T, Priority>::levelOf(const T& item) const
+{
+  int priority = priorityPolicy.priority(item);
+  if (priority < minPriority || priority > maxPriority)
+  {
+    throw PriorityRangeQueueException("BucketPriorityQueue<T>::enqueue() "
+				      + to_string(priority));
+  }
+  return maxPriority - priority;
+}
+
+
+/** priority queue (bucket) front level
+ * @returns int The highest priority level that has items, the queue
+ *   must not be empty.
+ */
+template <class T, class Priority>
+int BucketPriorityQueue<T, Priority>::frontLevel() const
+{
+  return __builtin_ctzll(occupied);
+}
+
+
+/** priority queue (bucket) clear
+ * Empty out the queue, the levels keep their memory.
+ */
+template <class T, class Priority>
+void BucketPriorityQueue<T, Priority>::clear()
+{
+  while (occupied != 0)
+  {
+    levels[frontLevel()].clear();
+    occupied &= occupied - 1;
+  }
+  numitems = 0;
+}
+
+
+/** priority queue (bucket) is empty
+ * @returns bool true if the queue is empty, false otherwise.
+ */
+template <class T, class Priority>
+bool BucketPriorityQueue<T, Priority>::isEmpty() const
+{
+  return numitems == 0;
+}
+
+
+/** priority queue (bucket) enqueue
+ * Add a copy of the item to the back of its priority level.  O(1).
+ *
+ * @param newItem The item to add.
+ *
+ * @throws PriorityRangeQueueException If the priority of the item is
+ *   not in the range of the queue.
+ */
+template <class T, class Priority>
+void BucketPriorityQueue<T, Priority>::enqueue(const T& newItem)
+{
+  int level = levelOf(newItem);
+  levels[level].enqueue(newItem);
+  occupied |= 1ULL << level;
+  numitems++;
+}
+
+
+/** priority queue (bucket) enqueue (move)
+ * @param newItem The item to move onto the queue.
+ *
+ * @throws PriorityRangeQueueException If the priority of the item is
+ *   not in the range of the queue.
+ */
+template <class T, class Priority>
+void BucketPriorityQueue<T, Priority>::enqueue(T&& newItem)
+{
+  int level = levelOf(newItem);
+  levels[level].enqueue(std::move(newItem));
+  occupied |= 1ULL << level;
+  numitems++;
+}
+
+
+/** priority queue (bucket) emplace
+ * Construct a new item and move it onto the queue.  The item has to be
+ * built before its priority decides which level it goes on, so it is
+ * built as a temporary and then moved, not constructed in place.
+ *
+ * @param args The arguments to construct the new item with.
+ */
+template <class T, class Priority>
+template <class... Args>
+void BucketPriorityQueue<T, Priority>::emplace(Args&&... args)
+{
+  enqueue(T(std::forward<Args>(args)...));
+}
+
+
+/** priority queue (bucket) front
+ * @returns T The front item of the highest priority level that has items.
+ *
+ * @throws EmptyQueueException If the queue is empty.
+ */
+template <class T, class Priority>
+const T& BucketPriorityQueue<T, Priority>::front() const
+{
+  if (isEmpty())
+  {
+    throw EmptyQueueException("BucketPriorityQueue<T>::front()");
+  }
+  return levels[frontLevel()].front();
+}
+
+
+/** priority queue (bucket) dequeue
+ * Remove the front item of the highest priority level that has items.
+ * O(1).
+ *
+ * @throws EmptyQueueException If the queue is empty.
+ */
+template <class T, class Priority>
+void BucketPriorityQueue<T, Priority>::dequeue()
+{
+  if (isEmpty())
+  {
+    throw EmptyQueueException("BucketPriorityQueue<T>::dequeue()");
+  }
+
+  int level = frontLevel();
+  levels[level].dequeue();
+  if (levels[level].isEmpty())
+  {
+    occupied &= occupied - 1;
+  }
+  numitems--;
+}
+
+
+/** priority queue (bucket) length
+ * @returns int The number of items on the queue.
+ */
+template <class T, class Priority>
+int BucketPriorityQueue<T, Priority>::length() const
+{
+  return numitems;
+}
+
+
+/** priority queue (bucket) fill batch
+ * Hand out the addresses of the next items of a traversal, in dequeue
+ * order, level by level, see Queue::fillBatch().  The level of the
+ * traversal is found again for each batch, a step per occupied level.
+ *
+ * @param position Where the traversal has got to.
+ * @param batch Filled in with the addresses of the items.
+ * @param maxItems The most items to hand out.
+ *
+ * @returns int The number of items handed out.
+ */
+template <class T, class Priority>
+int BucketPriorityQueue<T, Priority>::fillBatch(QueuePosition& position, const T* batch[], int maxItems) const
+{
+  int skip = position.index;
+  int count = 0;
+  unsigned long long remaining = occupied;
+  while (remaining != 0 && count < maxItems)
+  {
+    const AQueue<T>& level = levels[__builtin_ctzll(remaining)];
+    remaining &= remaining - 1;
+    if (skip >= level.length())
+    {
+      skip -= level.length();
+      continue;
+    }
+
+    int levelCount = min(maxItems - count, level.length() - skip);
+    for (int item = 0; item < levelCount; item++)
+    {
+      batch[count++] = &level[skip + item];
+    }
+    skip = 0;
+  }
+  position.index += count;
+
+  return count;
+}
+
+
+/** priority queue (bucket) indexing operator
+ * Access internel elements of queue using indexing operator[], where
+ * index 0 is the front of the queue.  O(levels).
+ *
+ * @param index The index of the item on the queue we want to access.
+ *
+ * @returns T Returns the item at "index" on the queue.
+ *
+ * @throws InvalidIndexQueueException If the index is out of range.
+ */
+template <class T, class Priority>
+const T& BucketPriorityQueue<T, Priority>::operator[](int index) const
+{
+  if (index < 0 || index >= length())
+  {
+    throw InvalidIndexQueueException("BucketPriorityQueue<T>::operator[]");
+  }
+
+  unsigned long long remaining = occupied;
+  while (index >= levels[__builtin_ctzll(remaining)].length())
+  {
+    index -= levels[__builtin_ctzll(remaining)].length();
+    remaining &= remaining - 1;
+  }
+  return levels[__builtin_ctzll(remaining)][index];
+}
@@ -1,12 +1,21 @@
 /**
- 
+
  * @description A Queue ADT with two concrete impelementation
  *   examples: an array based queue implementaiton (AQueue), and
  *   a linked list based implementation (LQueue).
  */
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <new>
+#include <cstddef>
+#include <cstring>
 #include <string>
 #include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "JobIdAllocator.hpp"
 
 using namespace std;
 
@@ -15,16 +24,57 @@ using namespace std;
 #define QUEUE_HPP
 
 
+//-------------------------------------------------------------------------
+/** queue position
+ * How far a traversal of a queue has got, see Queue::fillBatch().  The
+ * queue being traversed is the only one that interprets it.
+ *
+ * @var index The number of items already handed out, counting from the
+ *   front of the queue.
+ * @var node The next node to visit, for queues that are not stored in
+ *   an indexable array (LQueue).
+ */
+struct QueuePosition
+{
+  int index;
+  const void* node;
+};
+
+// the most items handed out by one Queue::fillBatch() call
+const int queueBatchSize = 32;
+
+
+
 //-------------------------------------------------------------------------
 /** queue (base class)
  * The basic definition of the Queue Abstract Data Type (ADT)
  * and queue operations.  All declared functions here are
  * virtual, they must be implemented by concrete derived
  * classes.
+ *
+ * Every queue can be traversed front to back with its const_iterator,
+ * which is built on fillBatch(), so comparing and printing queues does
+ * not need a virtual call per item.
+ *
+ * Concrete queues also provide a (non virtual) emplace() method, that
+ * constructs a new item on the queue from the given constructor
+ * arguments, so items never need to be copied onto the queue.  Most
+ * queues construct the item in place in their storage, queues that
+ * have to look at the item to decide where it goes (BucketPriorityQueue,
+ * AgingPriorityQueue) build it first and then move it.
  */
+template <class T>
 class Queue
 {
 public:
+  typedef T value_type;
+
+  /** destructor
+   * Virtual so that concrete queues can be destroyed through a Queue
+   * pointer.
+   */
+  virtual ~Queue() {}
+
   /** clear
    * Method to clear out or empty any items on queue,
    * put queue back to empty state.
@@ -42,12 +92,21 @@ public:
   virtual bool isEmpty() const = 0;
 
   /** enqueue
-   * Add a new item onto back of queue.  
+   * Add a new item onto back of queue.
    *
    * @param newItem The item of template type T to add on back of
    *   the current queue.
    */
-  virtual void enqueue(const int& newItem) = 0;
+  virtual void enqueue(const T& newItem) = 0;
+
+  /** enqueue (move)
+   * Add a new item onto back of queue, moving it onto the queue
+   * rather than copying it.
+   *
+   * @param newItem The item of template type T to move on back of
+   *   the current queue.
+   */
+  virtual void enqueue(T&& newItem) = 0;
 
   /** front
    * Return the front item from the queue.  Note in this ADT, peeking
@@ -58,7 +117,7 @@ public:
    *
    * @returns T Returns the front item from queue.
    */
-  virtual int front() const = 0;
+  virtual const T& front() const = 0;
 
   /** dequeue
    * Remove the item from the front of the queue.  It is undefined what
@@ -73,22 +132,90 @@ public:
    * @returns int The current length of this queue.
    */
   virtual int length() const = 0;
-  
+
+  /** fill batch
+   * Hand out the addresses of the next items of a traversal of the
+   * queue, front to back.  Traversals go through const_iterator, which
+   * calls this once per batch of items, so going over a queue is O(n)
+   * with one virtual call per queueBatchSize items, rather than one
+   * per item.  The queue must not change during a traversal.
+   *
+   * @param position Where the traversal has got to, {0, NULL} to start
+   *   from the front.  It is moved past the items handed out.
+   * @param batch Filled in with the addresses of the items.
+   * @param maxItems The most items to hand out.
+   *
+   * @returns int The number of items handed out, 0 once the traversal
+   *   has reached the back of the queue.
+   */
+  virtual int fillBatch(QueuePosition& position, const T* batch[], int maxItems) const = 0;
+
   /** tostring
    * Represent queue as a string
    */
-  virtual string tostring() const = 0;
+  virtual string tostring() const;
+  void print(ostream& out) const;
 
 
   // overload operators, mostly to support boolean comparison betwen
   // two queues for testing
-  bool operator==(const Queue& rhs) const;
-  virtual const int& operator[](int index) const = 0;
-  
-  // overload output stream operator for all queues using tostring()
-  friend ostream& operator<<(ostream& out, const Queue& aQueue); 
+  bool operator==(const Queue<T>& rhs) const;
+  virtual const T& operator[](int index) const = 0;
+
+  class const_iterator;
+  const_iterator begin() const;
+  const_iterator end() const;
+};
+
+
+/** queue iterator
+ * A forward iterator over the items of any queue, from the front to the
+ * back, in the order operator[] indexes them.  The iterator keeps a
+ * batch of item addresses filled in by Queue::fillBatch(), so stepping
+ * and dereferencing are not virtual calls, and going over a linked list
+ * queue does not walk the list again for every item.  Iterators are
+ * invalidated by any change to the queue.
+ *
+ * @var aQueue The queue being traversed.
+ * @var position Where the queue's traversal has got to.
+ * @var itemIndex The index of the current item, from the front.
+ * @var batchIndex The index of the current item in the batch.
+ * @var batchLength The number of items in the batch.
+ * @var batch The addresses of the items of the current batch.
+ */
+template <class T>
+class Queue<T>::const_iterator
+{
+private:
+  const Queue<T>* aQueue;
+  QueuePosition position;
+  int itemIndex;
+  int batchIndex;
+  int batchLength;
+  const T* batch[queueBatchSize];
+
+  void nextBatch();
+
+public:
+  typedef forward_iterator_tag iterator_category;
+  typedef T value_type;
+  typedef ptrdiff_t difference_type;
+  typedef const T* pointer;
+  typedef const T& reference;
+
+  const_iterator(const Queue<T>* aQueue, int itemIndex);
+  const T& operator*() const { return *batch[batchIndex]; }
+  const T* operator->() const { return batch[batchIndex]; }
+  const_iterator& operator++();
+  const_iterator operator++(int);
+  bool operator==(const const_iterator& rhs) const;
+  bool operator!=(const const_iterator& rhs) const;
 };
 
+// overload output stream operator for all queues using tostring()
+template <class T>
+ostream& operator<<(ostream& out, const Queue<T>& aQueue);
+
 
 
 
@@ -100,7 +227,7 @@ class EmptyQueueException
 {
 private:
   string message;
-  
+
 public:
   EmptyQueueException()
   {
@@ -121,15 +248,17 @@ public:
 class Job
 {
 public:
-  static int nextListId;
+  static JobIdAllocator nextListId;
   int id;
   int priority;
   int serviceTime;
+  int remainingTime;
   int startTime;
   int endTime;
 
   Job();
   Job(int priority, int serviceTime, int startTime);
+  Job(int id, int priority, int serviceTime, int startTime);
 
   void setEndTime(int endTime);
   int getId() const;
@@ -137,7 +266,7 @@ public:
   int getPriority() const;
   int getWaitTime() const;
   int getCost() const;
-  
+
   bool operator==(const Job& rhs) const;
   bool operator<(const Job& rhs) const;
   bool operator>(const Job& rhs) const;
@@ -153,7 +282,7 @@ class InvalidIndexQueueException
 {
 private:
   string message;
-  
+
 public:
   InvalidIndexQueueException()
   {
@@ -182,35 +311,70 @@ public:
  * demonstrates doubling the size of the allocated space as needed to
  * grow queue if/when the queue becomes full.
  *
- * @var allocSize The amount of memory currently allocated for this queue.
+ * The allocation is always a power of two, so indexes wrap around the
+ * circular buffer with a bit mask rather than a % division.  When the
+ * queue empties down to a quarter of its allocation, the allocation is
+ * halved, so a burst of items does not pin memory for good, while the
+ * gap between the grow (full) and shrink (quarter full) points keeps a
+ * queue whose length goes up and down a little from reallocating over
+ * and over.  The queue never shrinks below its minimum allocation, the
+ * initial allocation or the last reserve().  Growing and shrinking move
+ * the two runs of the circular buffer as whole blocks, with memcpy for
+ * trivially copyable items, and enqueueRange() and dequeueRange() add
+ * and remove whole runs of items at once.
+ *
+ * @var allocSize The amount of memory currently allocated for this
+ *   queue, a power of two.
+ * @var mask allocSize - 1, to wrap indexes around the buffer.
+ * @var minAllocSize The allocation the queue does not shrink below.
  * @var numitems The current length or number of items on the queue.
  * @var front A pointer to the index of the front item on the queue.
  * @var back A pointer to the back or last item on the queu.
  * @var items The items on the queue.  This is a dynamically allocated array that
  *   can grow if needed when queue exceeds current allocation.
  */
-class AQueue : public Queue
+template <class T>
+class AQueue : public Queue<T>
 {
 private:
   int allocSize;  // amount of memory allocated
+  int mask;       // allocSize - 1
+  int minAllocSize; // allocation kept when the queue empties
   int numitems;     // The current length of the queue
   int frontIndex; // index of the front item of the queue
   int backIndex;  // index of the last or rear item of the queue
-  int* items; 
+  T* items;
+
+  static int powerOfTwoAtLeast(int size);
+  static void moveItems(T* destination, T* source, int count);
+  static void moveItems(T* destination, T* source, int count, true_type trivial);
+  static void moveItems(T* destination, T* source, int count, false_type trivial);
+  void releaseItems(int index, int count);
+  void releaseItems(int index, int count, true_type trivial);
+  void releaseItems(int index, int count, false_type trivial);
+  void reallocate(int newAllocSize);
+  void grow();
+  void shrinkIfSparse();
 
 public:
   AQueue(int initialAlloc = 100); // constructor
-  AQueue(int initItems[], int numitems);
+  AQueue(T initItems[], int numitems);
   ~AQueue(); // destructor
   void clear();
   bool isEmpty() const;
   bool isFull() const;
-  void enqueue(const int& newItem);
-  int front() const;
+  int capacity() const;
+  void reserve(int capacity);
+  void enqueue(const T& newItem);
+  void enqueue(T&& newItem);
+  template <class... Args> void emplace(Args&&... args);
+  void enqueueRange(const T* newItems, int count);
+  const T& front() const;
   void dequeue();
+  int dequeueRange(T* items, int count);
   int length() const;
-  string tostring() const;
-  const int& operator[](int index) const;
+  int fillBatch(QueuePosition& position, const T* batch[], int maxItems) const;
+  const T& operator[](int index) const;
 };
 
 
@@ -219,12 +383,72 @@ public:
 //-------------------------------------------------------------------------
 /** Node
  * A basic node contaning an item and a link to the next node in
- * the linked list.
+ * the linked list.  The item is constructed in place from the
+ * arguments the node is created with.
  */
+template <class T>
 struct Node
 {
-  int item;
-  Node* link;
+  T item;
+  Node<T>* link;
+
+  template <class... Args>
+  Node(Args&&... args) : item(std::forward<Args>(args)...), link(NULL) {}
+};
+
+
+
+//-------------------------------------------------------------------------
+/** NodePool
+ * A slab allocator for linked list nodes.  Rather than calling new and
+ * delete for every node, the pool allocates nodes in slabs (blocks) of
+ * many nodes at a time, and keeps nodes that are given back on a free
+ * list to be reused.  A queue that grows to some length and then stays
+ * around that length stops allocating memory altogether.  Slabs double
+ * in size as the pool grows, up to maxSlabNodes nodes per slab, and are
+ * only given back to the system when the pool is destroyed.
+ *
+ * @var freeList The nodes available for reuse, linked through the
+ *   memory of the (unconstructed) nodes themselves.
+ * @var slabs The slabs of memory allocated by this pool.
+ * @var nextSlabNodes The number of nodes in the next slab to allocate.
+ * @var numAllocations The number of slabs the pool has allocated.
+ * @var numNodes The total number of nodes in all slabs.
+ * @var numLive The number of nodes currently handed out.
+ */
+template <class T>
+class NodePool
+{
+private:
+  struct FreeNode
+  {
+    FreeNode* next;
+  };
+
+  static const int firstSlabNodes = 64;
+  static const int maxSlabNodes = 4096;
+
+  FreeNode* freeList;
+  vector<void*> slabs;
+  int nextSlabNodes;
+  long long numAllocations;
+  long long numNodes;
+  long long numLive;
+
+  void allocateSlab();
+
+  // pools own their slabs, they can not be copied
+  NodePool(const NodePool<T>&);
+  NodePool<T>& operator=(const NodePool<T>&);
+
+public:
+  NodePool(); // constructor
+  ~NodePool(); // destructor
+  template <class... Args> Node<T>* create(Args&&... args);
+  void destroy(Node<T>* node);
+  long long allocations() const;
+  long long capacity() const;
+  long long live() const;
 };
 
 
@@ -235,28 +459,41 @@ struct Node
  * uses link nodes and grows (and shrinks) the nodes as items enqueued and dequeued
  * onto queue.
  *
+ * Nodes come from a NodePool owned by the queue, so once the queue has
+ * reached its working size, enqueue() and dequeue() reuse nodes rather
+ * than allocating and freeing memory.
+ *
  * @var queueFront a pointer to the node holding the front item of the queue.
  * @var queueBack a pointer to the node holding the back item of the queue.
  * @var numitems The length or number of items currently on the queue.
+ * @var nodePool The pool the nodes of this queue are allocated from.
  */
-class LQueue : public Queue
+template <class T>
+class LQueue : public Queue<T>
 {
 protected:
-  Node* queueFront;
-  Node* queueBack;
+  Node<T>* queueFront;
+  Node<T>* queueBack;
   int numitems; // the queue length
-  
+  NodePool<T> nodePool;
+
+  void appendNode(Node<T>* newNode);
+
 public:
   LQueue(); // default constructor
   ~LQueue(); // destructor
   void clear();
   bool isEmpty() const;
-  void enqueue(const int& newItem);
-  int front() const;
+  void enqueue(const T& newItem);
+  void enqueue(T&& newItem);
+  template <class... Args> void emplace(Args&&... args);
+  const T& front() const;
   void dequeue();
   int length() const;
-  string tostring() const;
-  const int& operator[](int index) const;
+  int fillBatch(QueuePosition& position, const T* batch[], int maxItems) const;
+  const T& operator[](int index) const;
+  long long nodeAllocations() const;
+  long long nodeCapacity() const;
 };
 
 
@@ -269,16 +506,356 @@ public:
 // You only need to override and implement 1 method in your PriorityQueue
 // class, the enqueue() method, which should insert new items into the
 // linked list ordered by priority, rather than inserting at the end
-// of the queue as is done by the basic enqueue() 
+// of the queue as is done by the basic enqueue()
+//
+// The copy, move and emplace flavours of enqueue() all create a node
+// and hand it to insertNode(), which does the ordered insertion.
 
-class PriorityQueues : public LQueue
+template <class T>
+class PriorityQueue : public LQueue<T>
 {
+	private:
+	void insertNode(Node<T>* newNode);
+
 	public:
-	void enqueue(const Job& newItem);
+	void enqueue(const T& newItem);
+	void enqueue(T&& newItem);
+	template <class... Args> void emplace(Args&&... args);
+};
+
+
+
+//-------------------------------------------------------------------------
+/** comes before
+ * The ordering used by the heap based priority queue, true if lhs should
+ * be dequeued before rhs.  In general larger items go first.  Jobs with
+ * higher priority go first, and Jobs of equal priority go in order of
+ * their ids, which are handed out in creation order, so equal priority
+ * Jobs are served FIFO.
+ */
+template <class T>
+inline bool comesBefore(const T& lhs, const T& rhs)
+{
+  return lhs > rhs;
+}
+
+inline bool comesBefore(const Job& lhs, const Job& rhs)
+{
+  if (lhs.priority != rhs.priority)
+  {
+    return lhs.priority > rhs.priority;
+  }
+  return lhs.id < rhs.id;
+}
+
+
+/** comes before order
+ * The default ordering policy of the heap based priority queue, which
+ * orders items by comesBefore().  An ordering policy is a class with a
+ * static before(lhs, rhs) function, true if lhs should be dequeued
+ * before rhs.  The policy is a template parameter of the queue, so the
+ * comparisons in the heap are inlined rather than called through a
+ * function pointer.
+ */
+template <class T>
+struct ComesBeforeOrder
+{
+  static bool before(const T& lhs, const T& rhs)
+  {
+    return comesBefore(lhs, rhs);
+  }
+};
+
+
+
+//-------------------------------------------------------------------------
+/** priority queue (heap implementation)
+ * Implementation of the queue ADT as a d-ary heap kept in contiguous
+ * storage.  Unlike the sorted linked list PriorityQueue, which has to
+ * walk the list to find the insertion point, enqueue() and dequeue() are
+ * both O(log n).  Items are ordered by the Order policy, by default
+ * comesBefore(), so higher priority Jobs come off the front first, and
+ * Jobs of equal priority come off in FIFO order, using the Job id as the
+ * tie-breaker.  Other orders give other scheduling disciplines, see
+ * SchedulingDiscipline.hpp.
+ *
+ * @var arity The number of children of each heap node.  2 gives a binary
+ *   heap, larger values make the heap shallower, which trades a few more
+ *   comparisons in dequeue() for fewer cache misses on big queues.
+ * @var order The ordering policy.  Most policies are stateless, but an
+ *   order can also have state, such as the JobTable that a queue of job
+ *   indexes is ordered by (see JobTableOrder), given to the constructor.
+ * @var items The heap, items[0] is the front of the queue.
+ * @var ordered The items in dequeue order, rebuilt on demand for
+ *   operator[].
+ * @var orderedValid True if ordered matches the current items.
+ */
+template <class T, class Order = ComesBeforeOrder<T> >
+class HeapPriorityQueue : public Queue<T>
+{
+private:
+  int arity;
+  Order order;
+  vector<T> items;
+  mutable vector<T> ordered;
+  mutable bool orderedValid;
+
+  bool higherPriority(const T& lhs, const T& rhs) const;
+  void siftUp(int index);
+  void siftDown(int index);
+  void buildOrdered() const;
+
+public:
+  HeapPriorityQueue(int arity = 4, const Order& order = Order()); // constructor
+  int getArity() const;
+  void clear();
+  bool isEmpty() const;
+  void enqueue(const T& newItem);
+  void enqueue(T&& newItem);
+  template <class... Args> void emplace(Args&&... args);
+  const T& front() const;
+  void dequeue();
+  int length() const;
+  int fillBatch(QueuePosition& position, const T* batch[], int maxItems) const;
+  const T& operator[](int index) const;
+};
+
+
+
+//-------------------------------------------------------------------------
+/** item id key
+ * The default key policy of the indexed priority queue, which addresses
+ * items by their getId().  A key policy is a class with a static
+ * key(item) function, giving the id an item is found, removed and
+ * updated by.
+ */
+template <class T>
+struct ItemIdKey
+{
+  static int key(const T& item)
+  {
+    return item.getId();
+  }
+};
+
+
+/** indexed priority queue (addressable heap)
+ * A binary heap priority queue, like HeapPriorityQueue, that also keeps
+ * the heap position of each item by the item's id, given by the Key
+ * policy (by default getId()), so an item that is on the queue can be
+ * found, removed or have its place updated in O(log n), not just the
+ * front item.  Ids are used directly as indexes into the position
+ * table, so they should be small non negative integers, such as the job
+ * ids of one run or server numbers, and each item on the queue must
+ * have a different id.
+ *
+ * @var items The heap, items[0] is the front of the queue.
+ * @var positions The index in items of the item with each id, or -1
+ *   for ids that are not on the queue.
+ */
+template <class T, class Order = ComesBeforeOrder<T>, class Key = ItemIdKey<T> >
+class IndexedHeapPriorityQueue : public Queue<T>
+{
+private:
+  vector<T> items;
+  vector<int> positions;
+
+  void place(int index, T&& item);
+  void siftUp(int index);
+  void siftDown(int index);
+  void resift(int index);
+  void removeAt(int index);
+
+public:
+  IndexedHeapPriorityQueue(); // constructor
+  void clear();
+  bool isEmpty() const;
+  void enqueue(const T& newItem);
+  void enqueue(T&& newItem);
+  template <class... Args> void emplace(Args&&... args);
+  const T& front() const;
+  void dequeue();
+  int length() const;
+  int fillBatch(QueuePosition& position, const T* batch[], int maxItems) const;
+  const T& operator[](int index) const;
+
+  bool contains(int id) const;
+  const T& find(int id) const;
+  void remove(int id);
+  void update(const T& item);
+};
+
+
+
+//-------------------------------------------------------------------------
+/** item priority
+ * The priority of an item, for the bucket priority queue.  Jobs have
+ * their priority, and other items (such as ints) are their own priority.
+ *
+ * @param item An item.
+ *
+ * @returns int The priority of the item, larger is dequeued first.
+ */
+template <class T>
+inline int itemPriority(const T& item)
+{
+  return (int)item;
+}
+
+inline int itemPriority(const Job& item)
+{
+  return item.getPriority();
+}
+
+
+/** item priority policy
+ * The default priority policy of the bucket priority queue, which gives
+ * items their itemPriority().  A priority policy is a class with a
+ * priority(item) function.  Like an ordering policy of the heap priority
+ * queue it is a template parameter, and can have state, such as the
+ * JobTable that a queue of job indexes gets priorities from (see
+ * JobTablePriority).
+ */
+template <class T>
+struct ItemPriorityPolicy
+{
+  static int priority(const T& item)
+  {
+    return itemPriority(item);
+  }
+};
+
+
+/** priority queue (bucket implementation)
+ * Implementation of the queue ADT for items whose priorities are small
+ * integers in a known range, such as the priorities of the Jobs of a
+ * simulation.  Each priority level has its own FIFO ring (an AQueue),
+ * and a bitmap of the levels that have items finds the highest priority
+ * level with a count trailing zeros instruction, so enqueue() and
+ * dequeue() are O(1) and do no comparisons.  Items of the same priority
+ * come off in the order they were enqueued, which for the Jobs of a
+ * simulation, numbered as they arrive, is the same order as comesBefore()
+ * and the HeapPriorityQueue.
+ *
+ * @var minPriority The lowest priority an item can have.
+ * @var maxPriority The highest priority an item can have, at most
+ *   maxLevels - 1 more than minPriority.
+ * @var priorityPolicy The priority policy of the items.
+ * @var levels The FIFO ring of each priority level, levels[0] is the
+ *   highest priority.
+ * @var occupied A bit per level, set if the level has items, bit 0 is
+ *   the highest priority.
+ * @var numitems The number of items on the queue, of all levels.
+ */
+template <class T, class Priority = ItemPriorityPolicy<T> >
+class BucketPriorityQueue : public Queue<T>
+{
+private:
+  int minPriority;
+  int maxPriority;
+  Priority priorityPolicy;
+  AQueue<T>* levels;
+  unsigned long long occupied;
+  int numitems;
+
+  int levelOf(const T& item) const;
+  int frontLevel() const;
+
+  // queues own their levels, they can not be copied
+  BucketPriorityQueue(const BucketPriorityQueue<T, Priority>&);
+  BucketPriorityQueue<T, Priority>& operator=(const BucketPriorityQueue<T, Priority>&);
+
+public:
+  static const int maxLevels = 64;
+
+  BucketPriorityQueue(int minPriority = 1, int maxPriority = 10,
+		      const Priority& priorityPolicy = Priority()); // constructor
+  ~BucketPriorityQueue(); // destructor
+  static bool fitsRange(int minPriority, int maxPriority);
+  int getMinPriority() const;
+  int getMaxPriority() const;
+  void clear();
+  bool isEmpty() const;
+  void enqueue(const T& newItem);
+  void enqueue(T&& newItem);
+  template <class... Args> void emplace(Args&&... args);
+  const T& front() const;
+  void dequeue();
+  int length() const;
+  int fillBatch(QueuePosition& position, const T* batch[], int maxItems) const;
+  const T& operator[](int index) const;
+};
+
+
+/** priority range queue exception
+ * Class to be thrown when a bucket priority queue is given a priority
+ * range it can not hold, or an item outside of its range.
+ */
+class PriorityRangeQueueException
+{
+private:
+  string message;
+
+public:
+  PriorityRangeQueueException(string str)
+  {
+    message = "Error: " + str + " priority out of range for queue";
+  }
+
+  string what()
+  {
+    return message;
+  }
+};
+
+
+
+//-------------------------------------------------------------------------
+/** queue dispatch
+ * Static dispatch of the queue operations used in a simulation's inner
+ * loop.  When the concrete queue type Q is known at compile time, the
+ * calls are qualified with Q, which makes them ordinary (inlinable)
+ * calls instead of virtual calls, and new items are built in place with
+ * emplace().  The specialization for the abstract Queue<T> falls back to
+ * virtual calls, so code written against QueueDispatch works with any
+ * queue.
+ */
+template <class Q>
+struct QueueDispatch
+{
+  typedef typename Q::value_type T;
+
+  template <class... Args>
+  static void emplace(Q& aQueue, Args&&... args)
+  {
+    aQueue.emplace(std::forward<Args>(args)...);
+  }
+
+  static const T& front(const Q& aQueue) { return aQueue.Q::front(); }
+  static void dequeue(Q& aQueue) { aQueue.Q::dequeue(); }
+  static bool isEmpty(const Q& aQueue) { return aQueue.Q::isEmpty(); }
+  static int length(const Q& aQueue) { return aQueue.Q::length(); }
+  static void clear(Q& aQueue) { aQueue.Q::clear(); }
+};
+
+template <class T>
+struct QueueDispatch<Queue<T> >
+{
+  template <class... Args>
+  static void emplace(Queue<T>& aQueue, Args&&... args)
+  {
+    aQueue.enqueue(T(std::forward<Args>(args)...));
+  }
+
+  static const T& front(const Queue<T>& aQueue) { return aQueue.front(); }
+  static void dequeue(Queue<T>& aQueue) { aQueue.dequeue(); }
+  static bool isEmpty(const Queue<T>& aQueue) { return aQueue.isEmpty(); }
+  static int length(const Queue<T>& aQueue) { return aQueue.length(); }
+  static void clear(Queue<T>& aQueue) { aQueue.clear(); }
 };
 
 // include the implementaiton of the class templates
-#include "Queue.cpp"  
+#include "Queue.cpp"
 
 #endif
-  
+
@@ -0,0 +1,857 @@
+/**
+ * @description Fast random number generation for the job scheduling
+ *   simulations.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include "RandomGenerator.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** xoshiro256 constructor
+ * Create a generator seeded with the given value.
+ *
+ * @param seed The seed for the generator, see seed().
+ */
+Xoshiro256::Xoshiro256(uint64_t seed)
+{
+  this->seed(seed);
+}
+
+
+/** rotate left
+ * Rotate the bits of x left by k bits.
+ */
+uint64_t Xoshiro256::rotl(uint64_t x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+
+/** xoshiro256 seed
+ * Seed the generator.  The 256 bit state is filled by running the
+ * splitmix64 generator from the 64 bit seed, as recommended by the
+ * xoshiro authors, so that similar seeds still give unrelated states
+ * and the state can never be all zero.
+ *
+ * @param seed Any 64 bit value.
+ */
+void Xoshiro256::seed(uint64_t seed)
+{
+  uint64_t z = seed;
+  for (int index = 0; index < 4; index++)
+  {
+    state[index] = splitMix64(z);
+  }
+}
+
+
+/** xoshiro256 next value
+ * Generate the next 64 bit random value and advance the state.
+ *
+ * @returns uint64_t A random value in range [0, 2^64 - 1].
+ */
+uint64_t Xoshiro256::operator()()
+{
+  uint64_t result = rotl(state[1] * 5, 7) * 9;
+  uint64_t t = state[1] << 17;
+
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = rotl(state[3], 45);
+
+  return result;
+}
+
+
+/** xoshiro256 jump by polynomial
+ * Advance the generator by the number of steps encoded by the given
+ * jump polynomial (from the reference implementation).
+ *
+ * @param polynomial Four 64 bit words of the jump polynomial.
+ */
+void Xoshiro256::jumpBy(const uint64_t* polynomial)
+{
+  uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+  for (int word = 0; word < 4; word++)
+  {
+    for (int bit = 0; bit < 64; bit++)
+    {
+      if (polynomial[word] & (1ULL << bit))
+      {
+	s0 ^= state[0];
+	s1 ^= state[1];
+	s2 ^= state[2];
+	s3 ^= state[3];
+      }
+      (*this)();
+    }
+  }
+
+  state[0] = s0;
+  state[1] = s1;
+  state[2] = s2;
+  state[3] = s3;
+}
+
+
+/** xoshiro256 jump
+ * Advance the generator by 2^128 steps.  Calling jump() n times on
+ * copies of one generator gives n streams that will never overlap.
+ */
+void Xoshiro256::jump()
+{
+  static const uint64_t polynomial[] = {
+    0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+  };
+  jumpBy(polynomial);
+}
+
+
+/** xoshiro256 long jump
+ * Advance the generator by 2^192 steps, for splitting streams that are
+ * themselves split with jump().
+ */
+void Xoshiro256::longJump()
+{
+  static const uint64_t polynomial[] = {
+    0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+    0x77710069854ee241ULL, 0x39109bb02acbe635ULL
+  };
+  jumpBy(polynomial);
+}
+
+
+/** xoshiro256 minimum
+ * @returns uint64_t The smallest value the generator returns.
+ */
+uint64_t Xoshiro256::min()
+{
+  return 0;
+}
+
+
+/** xoshiro256 maximum
+ * @returns uint64_t The largest value the generator returns.
+ */
+uint64_t Xoshiro256::max()
+{
+  return UINT64_MAX;
+}
+
+
+
+/** xoshiro256 output
+ * Write the state of the generator, as four decimal numbers separated
+ * by spaces, the way the standard engines write theirs.
+ *
+ * @param out The output stream to write to.
+ * @param engine The generator.
+ *
+ * @returns ostream The output stream, for chaining.
+ */
+ostream& operator<<(ostream& out, const Xoshiro256& engine)
+{
+  out << engine.state[0] << ' ' << engine.state[1] << ' '
+      << engine.state[2] << ' ' << engine.state[3];
+  return out;
+}
+
+
+/** xoshiro256 input
+ * Read back a state written by operator<<.  The generator is left as it
+ * was if the state can not be read.
+ *
+ * @param in The input stream to read from.
+ * @param engine The generator.
+ *
+ * @returns istream The input stream, for chaining.
+ */
+istream& operator>>(istream& in, Xoshiro256& engine)
+{
+  uint64_t state[4];
+  if (in >> state[0] >> state[1] >> state[2] >> state[3])
+  {
+    memcpy(engine.state, state, sizeof(state));
+  }
+  return in;
+}
+
+
+
+//-------------------------------------------------------------------------
+/** random block generator constructor
+ * Create a generator seeded with 1, with no arrivals and with ranges of
+ * a single value, until it is set up for a simulation.
+ */
+RandomBlockGenerator::RandomBlockGenerator()
+  : arrivalBits(arrivalBlockSteps / 64), uniforms(uniformBlockSize)
+{
+  vectorKernels = hasVectorKernels();
+  arrivalThreshold = 0;
+  priorities.values.resize(integerBlockSize);
+  serviceTimes.values.resize(integerBlockSize);
+  setRange(priorities, 0, 0);
+  setRange(serviceTimes, 0, 0);
+  seed(1);
+}
+
+
+/** random block generator has vector kernels
+ * @returns bool true if this program and processor can use the AVX2
+ *   kernels.
+ */
+bool RandomBlockGenerator::hasVectorKernels()
+{
+#ifdef RANDOMBLOCK_AVX2
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+
+/** random block generator set vector kernels
+ * Choose between the AVX2 and the scalar kernels, which draw the same
+ * values, for testing and benchmarking the kernels against each other.
+ *
+ * @param enabled True to use the AVX2 kernels, if there are any.
+ *
+ * @returns bool true if the AVX2 kernels are used.
+ */
+bool RandomBlockGenerator::setVectorKernels(bool enabled)
+{
+  vectorKernels = enabled && hasVectorKernels();
+  return vectorKernels;
+}
+
+
+/** random block generator seed
+ * Seed the lanes from one 64 bit seed, with splitmix64 like the
+ * Xoshiro256 seed(), and throw away the blocks drawn so far.
+ *
+ * @param seed Any 64 bit value.
+ */
+void RandomBlockGenerator::seed(uint64_t seed)
+{
+  uint64_t z = seed;
+  for (int lane = 0; lane < numLanes; lane++)
+  {
+    for (int word = 0; word < 4; word++)
+    {
+      state[word][lane] = splitMix64(z);
+    }
+  }
+
+  arrivalIndex = arrivalBlockSteps;
+  priorities.numValues = priorities.nextValue = 0;
+  serviceTimes.numValues = serviceTimes.nextValue = 0;
+  uniformIndex = uniformBlockSize;
+}
+
+
+/** random block generator seed from
+ * Seed the generator from the next output of another engine, so that
+ * seeding and jumping the engine (see Xoshiro256) decides the blocks,
+ * and seeding again from the same engine gives new blocks.
+ *
+ * @param engine A 64 bit engine.
+ */
+template <class Engine>
+void RandomBlockGenerator::seedFrom(Engine& engine)
+{
+  seed(engine());
+}
+
+
+/** random block generator set arrival probability
+ * @param probability The chance of an arrival in each time step.
+ */
+void RandomBlockGenerator::setArrivalProbability(double probability)
+{
+  arrivalThreshold = probabilityThreshold(probability);
+  arrivalIndex = arrivalBlockSteps;
+}
+
+
+/** random block generator set range
+ * Set the range of a block of integers, and throw away its values.
+ *
+ * @param block The block of integers.
+ * @param minValue The smallest value.
+ * @param maxValue The largest value, at least minValue.
+ */
+void RandomBlockGenerator::setRange(IntegerBlock& block, int minValue, int maxValue)
+{
+  block.minValue = minValue;
+  block.range = (uint64_t)((long long)maxValue - minValue + 1);
+  // 2^32 mod range, the number of 32 bit values that would make some
+  // results more likely than others
+  block.threshold = (uint32_t)((0x100000000ULL - block.range) % block.range);
+  block.numValues = block.nextValue = 0;
+}
+
+
+/** random block generator set priority range
+ * @param minPriority The lowest priority drawn.
+ * @param maxPriority The highest priority drawn.
+ */
+void RandomBlockGenerator::setPriorityRange(int minPriority, int maxPriority)
+{
+  setRange(priorities, minPriority, maxPriority);
+}
+
+
+/** random block generator set service time range
+ * @param minServiceTime The shortest service time drawn.
+ * @param maxServiceTime The longest service time drawn.
+ */
+void RandomBlockGenerator::setServiceTimeRange(int minServiceTime, int maxServiceTime)
+{
+  setRange(serviceTimes, minServiceTime, maxServiceTime);
+}
+
+
+/** random block generator next lane
+ * Advance one lane by one step, see Xoshiro256::operator()().  The
+ * scalar kernels go through the lanes two at a time, each with its state
+ * copied into a local array that the compiler keeps in registers, and
+ * write the outputs of each lane straight to their places in the block,
+ * so the two chains of steps overlap, with no state in memory and no
+ * pass that gathers the outputs of the lanes.
+ *
+ * @param s The four words of the state of the lane.
+ *
+ * @returns uint64_t The output of the lane.
+ */
+inline uint64_t RandomBlockGenerator::nextLane(uint64_t s[4])
+{
+  uint64_t s1 = s[1] * 5;
+  uint64_t result = ((s1 << 7) | (s1 >> 57)) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = (s[3] << 45) | (s[3] >> 19);
+  return result;
+}
+
+
+/** random block generator load lanes
+ * @param lane The first of two lanes.
+ * @param a Filled in with the state of the lane.
+ * @param b Filled in with the state of the next lane.
+ */
+inline void RandomBlockGenerator::loadLanes(int lane, uint64_t a[4], uint64_t b[4]) const
+{
+  for (int word = 0; word < 4; word++)
+  {
+    a[word] = state[word][lane];
+    b[word] = state[word][lane + 1];
+  }
+}
+
+
+/** random block generator store lanes
+ * @param lane The first of two lanes.
+ * @param a The state of the lane.
+ * @param b The state of the next lane.
+ */
+inline void RandomBlockGenerator::storeLanes(int lane, const uint64_t a[4], const uint64_t b[4])
+{
+  for (int word = 0; word < 4; word++)
+  {
+    state[word][lane] = a[word];
+    state[word][lane + 1] = b[word];
+  }
+}
+
+
+/** random block generator fill arrivals (scalar)
+ * Draw the arrival bitmask of the next block of time steps, each step of
+ * the lanes sets the bits of numLanes time steps, bit i if lane i's
+ * output is below the threshold.  The bits of a lane are shifted in from
+ * the top, so that they only move by constant shifts.
+ */
+void RandomBlockGenerator::fillArrivalsScalar()
+{
+  const uint64_t threshold = arrivalThreshold;
+  uint64_t* bits = arrivalBits.data();
+  memset(bits, 0, arrivalBlockSteps / 8);
+
+  for (int lane = 0; lane < numLanes; lane += 2)
+  {
+    uint64_t a[4], b[4];
+    loadLanes(lane, a, b);
+    for (int word = 0; word < arrivalBlockSteps / 64; word++)
+    {
+      uint64_t aBits = 0, bBits = 0;
+      for (int step = 0; step < 64 / numLanes; step++)
+      {
+	aBits = (aBits >> numLanes) | (uint64_t)(nextLane(a) < threshold) << (64 - numLanes);
+	bBits = (bBits >> numLanes) | (uint64_t)(nextLane(b) < threshold) << (64 - numLanes);
+      }
+      bits[word] |= (aBits << lane) | (bBits << (lane + 1));
+    }
+    storeLanes(lane, a, b);
+  }
+  arrivalIndex = 0;
+}
+
+
+/** random block generator fill integers (scalar)
+ * Draw the next block of integers.  Each group of four lanes gives eight
+ * 32 bit candidates, the low halves of the four outputs then the high
+ * halves, and each candidate u is mapped to (u * range) >> 32, unless
+ * the low 32 bits of the product are below the threshold, the few
+ * candidates that would bias the result, which are skipped.  The lanes
+ * write their candidates for as many steps as the block surely needs to
+ * their places in candidate order, and then the candidates are mapped,
+ * with no branch for the rejections.
+ *
+ * @param block The block to fill.
+ */
+void RandomBlockGenerator::fillIntegersScalar(IntegerBlock& block)
+{
+  uint32_t candidates[integerBlockSize];
+  int* values = block.values.data();
+  const int minValue = block.minValue;
+  const uint64_t range = block.range;
+  const uint32_t threshold = block.threshold;
+
+  int count = 0;
+  while (count <= integerBlockSize - 2 * numLanes)
+  {
+    // every one of these steps would be taken even if all of their
+    // candidates were kept
+    int numSteps = (integerBlockSize - count) / (2 * numLanes);
+    for (int lane = 0; lane < numLanes; lane += 2)
+    {
+      uint64_t a[4], b[4];
+      loadLanes(lane, a, b);
+      uint32_t* candidate = candidates + (lane / 4) * 8 + lane % 4;
+      for (int step = 0; step < numSteps; step++)
+      {
+	uint64_t aValue = nextLane(a);
+	uint64_t bValue = nextLane(b);
+	candidate[0] = (uint32_t)aValue;
+	candidate[4] = (uint32_t)(aValue >> 32);
+	candidate[1] = (uint32_t)bValue;
+	candidate[5] = (uint32_t)(bValue >> 32);
+	candidate += 2 * numLanes;
+      }
+      storeLanes(lane, a, b);
+    }
+
+    for (int index = 0; index < numSteps * 2 * numLanes; index++)
+    {
+      uint64_t product = candidates[index] * range;
+      values[count] = minValue + (int)(product >> 32);
+      count += (uint32_t)product >= threshold;
+    }
+  }
+  block.numValues = count;
+  block.nextValue = 0;
+}
+
+
+/** random block generator fill uniforms (scalar)
+ * Draw the next block of doubles.  The top 52 bits of an output are the
+ * fraction of a double in [1.0, 2.0), which subtracted from 2.0 gives a
+ * uniform double in (0.0, 1.0], with no integer to double conversion.
+ */
+void RandomBlockGenerator::fillUniformsScalar()
+{
+  double* values = uniforms.data();
+  for (int lane = 0; lane < numLanes; lane += 2)
+  {
+    uint64_t a[4], b[4];
+    loadLanes(lane, a, b);
+    for (int index = lane; index < uniformBlockSize; index += numLanes)
+    {
+      uint64_t aBits = (nextLane(a) >> 12) | 0x3ff0000000000000ULL;
+      uint64_t bBits = (nextLane(b) >> 12) | 0x3ff0000000000000ULL;
+      double aOneToTwo, bOneToTwo;
+      memcpy(&aOneToTwo, &aBits, sizeof(aOneToTwo));
+      memcpy(&bOneToTwo, &bBits, sizeof(bOneToTwo));
+      values[index] = 2.0 - aOneToTwo;
+      values[index + 1] = 2.0 - bOneToTwo;
+    }
+    storeLanes(lane, a, b);
+  }
+  uniformIndex = 0;
+}
+
+
+#ifdef RANDOMBLOCK_AVX2
+/** next avx2
+ * Advance four lanes held in vectors by one step, see nextLane().
+ *
+ * @param s The four words of the states of the lanes.
+ *
+ * @returns __m256i The output of each lane.
+ */
+__attribute__((target("avx2")))
+static inline __m256i nextAvx2(__m256i s[4])
+{
+  __m256i s1 = _mm256_add_epi64(_mm256_slli_epi64(s[1], 2), s[1]);
+  __m256i rotated = _mm256_or_si256(_mm256_slli_epi64(s1, 7), _mm256_srli_epi64(s1, 57));
+  __m256i result = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+  __m256i t = _mm256_slli_epi64(s[1], 17);
+
+  s[2] = _mm256_xor_si256(s[2], s[0]);
+  s[3] = _mm256_xor_si256(s[3], s[1]);
+  s[1] = _mm256_xor_si256(s[1], s[2]);
+  s[0] = _mm256_xor_si256(s[0], s[3]);
+  s[2] = _mm256_xor_si256(s[2], t);
+  s[3] = _mm256_or_si256(_mm256_slli_epi64(s[3], 45), _mm256_srli_epi64(s[3], 19));
+
+  return result;
+}
+
+
+/** load avx2 state
+ * @param state The lane states, state[word][lane].
+ * @param s Filled in with the states of each group of four lanes,
+ *   s[group][word].
+ */
+__attribute__((target("avx2")))
+static inline void loadAvx2State(const uint64_t state[4][RandomBlockGenerator::numLanes],
+				 __m256i s[][4])
+{
+  for (int group = 0; group < RandomBlockGenerator::numLanes / 4; group++)
+  {
+    for (int word = 0; word < 4; word++)
+    {
+      s[group][word] = _mm256_loadu_si256((const __m256i*)&state[word][group * 4]);
+    }
+  }
+}
+
+
+/** store avx2 state
+ * @param s The states of each group of four lanes, s[group][word].
+ * @param state Filled in with the lane states, state[word][lane].
+ */
+__attribute__((target("avx2")))
+static inline void storeAvx2State(__m256i s[][4],
+				  uint64_t state[4][RandomBlockGenerator::numLanes])
+{
+  for (int group = 0; group < RandomBlockGenerator::numLanes / 4; group++)
+  {
+    for (int word = 0; word < 4; word++)
+    {
+      _mm256_storeu_si256((__m256i*)&state[word][group * 4], s[group][word]);
+    }
+  }
+}
+
+
+/** random block generator fill arrivals (avx2)
+ * The AVX2 version of fillArrivalsScalar(), the groups of four lanes are
+ * independent, so their steps overlap.  There is no unsigned 64 bit
+ * compare, so the outputs and threshold have their sign bits flipped and
+ * are compared signed.
+ */
+__attribute__((target("avx2")))
+void RandomBlockGenerator::fillArrivalsAvx2()
+{
+  __m256i s[numLanes / 4][4];
+  loadAvx2State(state, s);
+  const __m256i signBit = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+  const __m256i threshold = _mm256_xor_si256(_mm256_set1_epi64x((long long)arrivalThreshold),
+					     signBit);
+
+  for (int word = 0; word < arrivalBlockSteps / 64; word++)
+  {
+    uint64_t bits = 0;
+    for (int step = 0; step < 64 / numLanes; step++)
+    {
+      for (int group = 0; group < numLanes / 4; group++)
+      {
+	__m256i values = _mm256_xor_si256(nextAvx2(s[group]), signBit);
+	__m256i arrived = _mm256_cmpgt_epi64(threshold, values);
+	bits |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(arrived))
+	  << (step * numLanes + group * 4);
+      }
+    }
+    arrivalBits[word] = bits;
+  }
+
+  storeAvx2State(s, state);
+  arrivalIndex = 0;
+}
+
+
+/** random block generator fill integers (avx2)
+ * The AVX2 version of fillIntegersScalar().  The eight candidates of a
+ * group of four lanes are mapped with two 32 by 32 bit multiplies, and
+ * when none of them is rejected, which is nearly always, they are stored
+ * in candidate order with one permute.  A group with a rejected
+ * candidate is done one candidate at a time, like the scalar kernel.  A
+ * range of 2^32 does not fit the 32 bit multiplier, and uses the scalar
+ * kernel.
+ *
+ * @param block The block to fill.
+ */
+__attribute__((target("avx2")))
+void RandomBlockGenerator::fillIntegersAvx2(IntegerBlock& block)
+{
+  if (block.range > 0xffffffffULL)
+  {
+    fillIntegersScalar(block);
+    return;
+  }
+
+  __m256i s[numLanes / 4][4];
+  loadAvx2State(state, s);
+  const __m256i range = _mm256_set1_epi64x((long long)block.range);
+  const __m256i threshold = _mm256_set1_epi32((int)block.threshold);
+  const __m256i minValue = _mm256_set1_epi32(block.minValue);
+  // the high halves of the low products, then of the high products
+  const __m256i candidateOrder = _mm256_setr_epi32(1, 3, 5, 7, 0, 2, 4, 6);
+
+  int count = 0;
+  while (count <= integerBlockSize - 2 * numLanes)
+  {
+    for (int group = 0; group < numLanes / 4; group++)
+    {
+      __m256i values = nextAvx2(s[group]);
+      __m256i lowProducts = _mm256_mul_epu32(values, range);
+      __m256i highProducts = _mm256_mul_epu32(_mm256_srli_epi64(values, 32), range);
+
+      // low 32 bits of the products in the even elements, kept if at
+      // least the threshold, max(low, threshold) == low
+      __m256i lowHalves = _mm256_blend_epi32(lowProducts, _mm256_slli_epi64(highProducts, 32),
+					     0xaa);
+      __m256i kept = _mm256_cmpeq_epi32(_mm256_max_epu32(lowHalves, threshold), lowHalves);
+      if (_mm256_movemask_ps(_mm256_castsi256_ps(kept)) == 0xff)
+      {
+	__m256i results = _mm256_blend_epi32(lowProducts, _mm256_srli_epi64(highProducts, 32),
+					     0x55);
+	results = _mm256_add_epi32(_mm256_permutevar8x32_epi32(results, candidateOrder),
+				   minValue);
+	_mm256_storeu_si256((__m256i*)&block.values[count], results);
+	count += 8;
+	continue;
+      }
+
+      uint64_t laneValues[4];
+      _mm256_storeu_si256((__m256i*)laneValues, values);
+      for (int half = 0; half < 2; half++)
+      {
+	for (int lane = 0; lane < 4; lane++)
+	{
+	  uint64_t product = (laneValues[lane] >> (32 * half) & 0xffffffffULL) * block.range;
+	  if ((uint32_t)product >= block.threshold)
+	  {
+	    block.values[count++] = block.minValue + (int)(product >> 32);
+	  }
+	}
+      }
+    }
+  }
+
+  storeAvx2State(s, state);
+  block.numValues = count;
+  block.nextValue = 0;
+}
+
+
+/** random block generator fill uniforms (avx2)
+ * The AVX2 version of fillUniformsScalar().
+ */
+__attribute__((target("avx2")))
+void RandomBlockGenerator::fillUniformsAvx2()
+{
+  __m256i s[numLanes / 4][4];
+  loadAvx2State(state, s);
+  const __m256i one = _mm256_set1_epi64x(0x3ff0000000000000LL);
+  const __m256d two = _mm256_set1_pd(2.0);
+
+  for (int index = 0; index < uniformBlockSize; index += numLanes)
+  {
+    for (int group = 0; group < numLanes / 4; group++)
+    {
+      __m256i bits = _mm256_or_si256(_mm256_srli_epi64(nextAvx2(s[group]), 12), one);
+      _mm256_storeu_pd(&uniforms[index + group * 4],
+		       _mm256_sub_pd(two, _mm256_castsi256_pd(bits)));
+    }
+  }
+
+  storeAvx2State(s, state);
+  uniformIndex = 0;
+}
+#endif
+
+
+/** random block generator arrival steps
+ * Take the arrival tests of the time steps up to and including the next
+ * arrival, a count trailing zeros per 64 steps rather than a test per
+ * step.  The arrivals are the same as nextArrival() gives step by step.
+ *
+ * @param maxSteps The most steps to take.
+ *
+ * @returns long long The number of steps taken, the last of which has
+ *   an arrival, or maxSteps + 1 if there is no arrival in maxSteps steps.
+ */
+long long RandomBlockGenerator::arrivalSteps(long long maxSteps)
+{
+  long long steps = 0;
+  while (steps < maxSteps)
+  {
+    if (arrivalIndex == arrivalBlockSteps)
+    {
+      fillArrivals();
+    }
+    uint64_t bits = arrivalBits[arrivalIndex >> 6] >> (arrivalIndex & 63);
+    if (bits != 0)
+    {
+      int skipped = __builtin_ctzll(bits);
+      arrivalIndex += skipped + 1;
+      steps += skipped + 1;
+      return (steps <= maxSteps) ? steps : maxSteps + 1;
+    }
+    int rest = 64 - (arrivalIndex & 63);
+    arrivalIndex += rest;
+    steps += rest;
+  }
+  return maxSteps + 1;
+}
+
+
+/** random block generator save
+ * Write the generator to a snapshot: the lane states and what is left
+ * of each block, so that a restored generator goes on with exactly the
+ * values this one would have drawn.  Which kernels are used is not
+ * written, they give the same values.
+ *
+ * @param snapshot The snapshot being written.
+ */
+void RandomBlockGenerator::save(SnapshotWriter& snapshot) const
+{
+  snapshot.write(state);
+  snapshot.write(arrivalThreshold);
+  snapshot.write(arrivalIndex);
+  snapshot.writeVector(arrivalBits);
+
+  const IntegerBlock* blocks[] = { &priorities, &serviceTimes };
+  for (int block = 0; block < 2; block++)
+  {
+    snapshot.write(blocks[block]->minValue);
+    snapshot.write(blocks[block]->range);
+    snapshot.writeVector(vector<int>(blocks[block]->values.begin() + blocks[block]->nextValue,
+				     blocks[block]->values.begin() + blocks[block]->numValues));
+  }
+  snapshot.writeVector(vector<double>(uniforms.begin() + uniformIndex, uniforms.end()));
+}
+
+
+/** random block generator restore
+ * Read the generator back from a snapshot, see save().
+ *
+ * @param snapshot The snapshot being read.
+ *
+ * @throws SnapshotException If the blocks read do not fit the generator.
+ */
+void RandomBlockGenerator::restore(SnapshotReader& snapshot)
+{
+  snapshot.read(state);
+  snapshot.read(arrivalThreshold);
+  snapshot.read(arrivalIndex);
+  vector<uint64_t> bits;
+  snapshot.readVector(bits);
+  if (arrivalIndex < 0 || arrivalIndex > arrivalBlockSteps
+      || bits.size() != arrivalBits.size())
+  {
+    throw SnapshotException("random arrivals are corrupt");
+  }
+  arrivalBits = bits;
+
+  IntegerBlock* blocks[] = { &priorities, &serviceTimes };
+  for (int block = 0; block < 2; block++)
+  {
+    int minValue = snapshot.read<int>();
+    uint64_t range = snapshot.read<uint64_t>();
+    vector<int> values;
+    snapshot.readVector(values);
+    if (range < 1 || range > 0x100000000ULL || values.size() > (size_t)integerBlockSize)
+    {
+      throw SnapshotException("random integers are corrupt");
+    }
+    setRange(*blocks[block], minValue, (int)(minValue + (long long)range - 1));
+    copy(values.begin(), values.end(), blocks[block]->values.begin());
+    blocks[block]->numValues = values.size();
+  }
+
+  vector<double> values;
+  snapshot.readVector(values);
+  if (values.size() > (size_t)uniformBlockSize)
+  {
+    throw SnapshotException("random uniforms are corrupt");
+  }
+  uniformIndex = uniformBlockSize - values.size();
+  copy(values.begin(), values.end(), uniforms.begin() + uniformIndex);
+}
+
+
+/** random block generator fill arrivals
+ * Draw the next block of arrivals, with the AVX2 kernel if it is used.
+ */
+void RandomBlockGenerator::fillArrivals()
+{
+#ifdef RANDOMBLOCK_AVX2
+  if (vectorKernels)
+  {
+    fillArrivalsAvx2();
+    return;
+  }
+#endif
+  fillArrivalsScalar();
+}
+
+
+/** random block generator fill integers
+ * Draw the next block of integers, with the AVX2 kernel if it is used.
+ *
+ * @param block The block to fill.
+ */
+void RandomBlockGenerator::fillIntegers(IntegerBlock& block)
+{
+#ifdef RANDOMBLOCK_AVX2
+  if (vectorKernels)
+  {
+    fillIntegersAvx2(block);
+    return;
+  }
+#endif
+  fillIntegersScalar(block);
+}
+
+
+/** random block generator fill uniforms
+ * Draw the next block of doubles, with the AVX2 kernel if it is used.
+ */
+void RandomBlockGenerator::fillUniforms()
+{
+#ifdef RANDOMBLOCK_AVX2
+  if (vectorKernels)
+  {
+    fillUniformsAvx2();
+    return;
+  }
+#endif
+  fillUniformsScalar();
+}
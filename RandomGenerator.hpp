@@ -0,0 +1,311 @@
+/**
+ * @description Fast random number generation for the job scheduling
+ *   simulations.
+ */
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "Snapshot.hpp"
+using namespace std;
+
+// the block generator has AVX2 kernels, compiled with a target attribute
+// and chosen at run time, on x86 builds with GCC or clang, other builds
+// only have its scalar kernels
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RANDOMBLOCK_AVX2 1
+#include <immintrin.h>
+#endif
+
+#ifndef RANDOMGENERATOR_HPP
+#define RANDOMGENERATOR_HPP
+
+
+//-------------------------------------------------------------------------
+/** split mix 64
+ * The splitmix64 generator, which the xoshiro authors recommend for
+ * expanding a 64 bit seed into the state of a xoshiro generator.
+ *
+ * @param z The splitmix64 state, advanced by one step.
+ *
+ * @returns uint64_t The next splitmix64 value.
+ */
+inline uint64_t splitMix64(uint64_t& z)
+{
+  z += 0x9e3779b97f4a7c15ULL;
+  uint64_t mixed = z;
+  mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebULL;
+  return mixed ^ (mixed >> 31);
+}
+
+
+/** Xoshiro256
+ * The xoshiro256** pseudo random number generator of Blackman and Vigna.
+ * It has 256 bits of state, a period of 2^256 - 1, and generates a 64 bit
+ * value with a handful of shifts, rotates and adds, which is much faster
+ * than rand() and has no hidden shared state.  The class meets the
+ * requirements of a C++ UniformRandomBitGenerator, so it can be used with
+ * the <random> distributions, or swapped for another 64 bit engine.
+ *
+ * jump() advances the generator by 2^128 steps, and longJump() by 2^192,
+ * which can be used to split one seed into many non-overlapping streams.
+ * Like the standard engines, its state can be written to and read back
+ * from a stream with << and >>.
+ *
+ * @var state The 256 bits of generator state, never all zero.
+ */
+class Xoshiro256
+{
+private:
+  uint64_t state[4];
+
+  static uint64_t rotl(uint64_t x, int k);
+  void jumpBy(const uint64_t* polynomial);
+
+public:
+  typedef uint64_t result_type;
+
+  Xoshiro256(uint64_t seed = 1); // constructor
+  void seed(uint64_t seed);
+  uint64_t operator()();
+  void jump();
+  void longJump();
+
+  static uint64_t min();
+  static uint64_t max();
+
+  friend ostream& operator<<(ostream& out, const Xoshiro256& engine);
+  friend istream& operator>>(istream& in, Xoshiro256& engine);
+};
+
+
+
+//-------------------------------------------------------------------------
+// functions turning the raw 64 bit output of an engine into the values
+// needed by the simulations.  They are templates so that any 64 bit
+// engine (Xoshiro256, mt19937_64, ...) can be plugged in.
+
+/** uniform double
+ * Return a random double in range [0.0, 1.0), using the top 53 bits of
+ * one engine output.
+ */
+template <class Engine>
+inline double uniformDouble(Engine& engine)
+{
+  return double(engine() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+/** bounded integer
+ * Return a random integer in range [0, range) with exactly uniform
+ * probability, using Lemire's multiply and shift method.  A 64x64 bit
+ * multiply maps the random value onto the range, and the rare values
+ * that would bias the result are rejected, which needs no division on
+ * the common path (unlike rand() % range, which is both slower and
+ * biased towards small values).
+ *
+ * @param range The size of the range, must be at least 1.
+ */
+template <class Engine>
+inline uint64_t boundedInteger(Engine& engine, uint64_t range)
+{
+  unsigned __int128 product = (unsigned __int128)engine() * range;
+  uint64_t low = (uint64_t)product;
+  if (low < range)
+  {
+    uint64_t threshold = (0 - range) % range;
+    while (low < threshold)
+    {
+      product = (unsigned __int128)engine() * range;
+      low = (uint64_t)product;
+    }
+  }
+  return (uint64_t)(product >> 64);
+}
+
+
+/** probability threshold
+ * Convert a probability p in [0.0, 1.0] into the 64 bit threshold t such
+ * that a raw engine output x satisfies x < t with probability p.  Used
+ * to precompute Bernoulli tests so that each draw is a single integer
+ * comparison.
+ */
+inline uint64_t probabilityThreshold(double probability)
+{
+  if (probability <= 0.0)
+  {
+    return 0;
+  }
+  if (probability >= 1.0)
+  {
+    return UINT64_MAX;
+  }
+  return (uint64_t)(probability * 18446744073709551616.0);
+}
+
+
+
+
+//-------------------------------------------------------------------------
+/** RandomBlockGenerator
+ * Draws the random arrivals and job attributes of a simulation in blocks
+ * of thousands, rather than one engine call per value.  Sixteen
+ * xoshiro256** generators run side by side as the lanes of four vector
+ * registers, four independent chains of steps that the processor
+ * overlaps, and each block kernel turns their outputs straight into:
+ *
+ *   - an arrival bitmask, a bit per time step, set with the chance of
+ *     an arrival, so each step's test is a bit test (nextArrival()),
+ *     and the steps to the next arrival a count trailing zeros
+ *     (arrivalSteps()),
+ *   - arrays of exactly uniform integers in the priority and service
+ *     time ranges, two per 64 bit output with Lemire's 32 bit multiply
+ *     and shift, the rare biased values being rejected (nextPriority()
+ *     and nextServiceTime()),
+ *   - an array of uniform doubles in (0.0, 1.0] (nextUniform()).
+ *
+ * The kernels come in AVX2 versions, compiled with a target attribute
+ * so the rest of the program does not need -mavx2, and used when the
+ * processor has AVX2, and scalar versions, used everywhere else.  The
+ * two versions give exactly the same values, so results never depend
+ * on the processor a simulation runs on.
+ *
+ * @var state The 256 bit states of the lanes, state[word][lane], so
+ *   each word of a group of four lanes is one vector.
+ * @var vectorKernels True to fill the blocks with the AVX2 kernels.
+ * @var arrivalThreshold An engine output below this is an arrival, see
+ *   probabilityThreshold().
+ * @var arrivalBits The arrival bitmask of the current block of steps.
+ * @var arrivalIndex The bit of the next time step in arrivalBits.
+ * @var priorities The current block of priorities.
+ * @var serviceTimes The current block of service times.
+ * @var uniforms The current block of uniform doubles.
+ * @var uniformIndex The next value of uniforms.
+ */
+class RandomBlockGenerator
+{
+public:
+  static const int numLanes = 16;
+  static const int arrivalBlockSteps = 4096;
+  static const int integerBlockSize = 1024;
+  static const int uniformBlockSize = 512;
+
+  /** IntegerBlock
+   * A block of uniform integers in [minValue, minValue + range).
+   *
+   * @var minValue The smallest value.
+   * @var range The number of values, 1 to 2^32.
+   * @var threshold Products whose low 32 bits are below this are rejected.
+   * @var values The block of values, the first numValues are drawn.
+   * @var numValues The number of values in the block, rejections leave
+   *   a few less than integerBlockSize.
+   * @var nextValue The next value of the block.
+   */
+  struct IntegerBlock
+  {
+    int minValue;
+    uint64_t range;
+    uint32_t threshold;
+    vector<int> values;
+    int numValues;
+    int nextValue;
+  };
+
+private:
+  uint64_t state[4][numLanes];
+  bool vectorKernels;
+  uint64_t arrivalThreshold;
+  vector<uint64_t> arrivalBits;
+  int arrivalIndex;
+  IntegerBlock priorities;
+  IntegerBlock serviceTimes;
+  vector<double> uniforms;
+  int uniformIndex;
+
+  static void setRange(IntegerBlock& block, int minValue, int maxValue);
+  static uint64_t nextLane(uint64_t s[4]);
+  void loadLanes(int lane, uint64_t a[4], uint64_t b[4]) const;
+  void storeLanes(int lane, const uint64_t a[4], const uint64_t b[4]);
+  void fillArrivalsScalar();
+  void fillIntegersScalar(IntegerBlock& block);
+  void fillUniformsScalar();
+#ifdef RANDOMBLOCK_AVX2
+  void fillArrivalsAvx2();
+  void fillIntegersAvx2(IntegerBlock& block);
+  void fillUniformsAvx2();
+#endif
+  void fillArrivals();
+  void fillIntegers(IntegerBlock& block);
+  void fillUniforms();
+
+public:
+  RandomBlockGenerator(); // constructor
+  static bool hasVectorKernels();
+  bool setVectorKernels(bool enabled);
+  void seed(uint64_t seed);
+  template <class Engine> void seedFrom(Engine& engine);
+  void setArrivalProbability(double probability);
+  void setPriorityRange(int minPriority, int maxPriority);
+  void setServiceTimeRange(int minServiceTime, int maxServiceTime);
+  long long arrivalSteps(long long maxSteps);
+  void save(SnapshotWriter& snapshot) const;
+  void restore(SnapshotReader& snapshot);
+
+  /** next arrival
+   * @returns bool true if a job arrives in the next time step.
+   */
+  bool nextArrival()
+  {
+    if (arrivalIndex == arrivalBlockSteps)
+    {
+      fillArrivals();
+    }
+    bool arrived = (arrivalBits[arrivalIndex >> 6] >> (arrivalIndex & 63)) & 1;
+    arrivalIndex++;
+    return arrived;
+  }
+
+  /** next priority
+   * @returns int A uniform random priority in the priority range.
+   */
+  int nextPriority()
+  {
+    if (priorities.nextValue == priorities.numValues)
+    {
+      fillIntegers(priorities);
+    }
+    return priorities.values[priorities.nextValue++];
+  }
+
+  /** next service time
+   * @returns int A uniform random service time in the service time range.
+   */
+  int nextServiceTime()
+  {
+    if (serviceTimes.nextValue == serviceTimes.numValues)
+    {
+      fillIntegers(serviceTimes);
+    }
+    return serviceTimes.values[serviceTimes.nextValue++];
+  }
+
+  /** next uniform
+   * @returns double A uniform random double in range (0.0, 1.0].
+   */
+  double nextUniform()
+  {
+    if (uniformIndex == uniformBlockSize)
+    {
+      fillUniforms();
+    }
+    return uniforms[uniformIndex++];
+  }
+};
+
+
+
+// include the implementation of the random number generators
+#include "RandomGenerator.cpp"
+
+#endif
@@ -0,0 +1,294 @@
+/**
+ * @description Run many independent replications of a job scheduling
+ *   simulation in parallel, and summarize the results with confidence
+ *   intervals.
+ */
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ReplicationRunner.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** replication statistic default constructor
+ * An empty statistic, with no replications.
+ */
+ReplicationStatistic::ReplicationStatistic()
+{
+  numReplications = 0;
+  mean = 0.0;
+  standardDeviation = 0.0;
+  halfWidth = 0.0;
+}
+
+
+/** replication statistic constructor
+ * Calculate the mean, sample standard deviation and 95% confidence
+ * interval half width of the given replication results.  The critical
+ * values of the two sided Student t distribution are tabulated for up
+ * to 30 degrees of freedom, above that the normal value is close enough.
+ *
+ * @param values The result measure of each replication.
+ */
+ReplicationStatistic::ReplicationStatistic(const vector<double>& values)
+{
+  static const double tCritical[] = {
+    0.0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+    2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+    2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+    2.042
+  };
+
+  numReplications = values.size();
+  mean = 0.0;
+  standardDeviation = 0.0;
+  halfWidth = 0.0;
+  if (numReplications == 0)
+  {
+    return;
+  }
+
+  double sum = 0.0;
+  for (int index = 0; index < numReplications; index++)
+  {
+    sum += values[index];
+  }
+  mean = sum / numReplications;
+
+  if (numReplications < 2)
+  {
+    return;
+  }
+
+  double sumSquares = 0.0;
+  for (int index = 0; index < numReplications; index++)
+  {
+    double difference = values[index] - mean;
+    sumSquares += difference * difference;
+  }
+  standardDeviation = sqrt(sumSquares / (numReplications - 1));
+
+  int degreesOfFreedom = numReplications - 1;
+  double t = (degreesOfFreedom <= 30) ? tCritical[degreesOfFreedom] : 1.960;
+  halfWidth = t * standardDeviation / sqrt(double(numReplications));
+}
+
+
+/** confidence interval lower bound
+ * @returns double The lower end of the 95% confidence interval.
+ */
+double ReplicationStatistic::lower() const
+{
+  return mean - halfWidth;
+}
+
+
+/** confidence interval upper bound
+ * @returns double The upper end of the 95% confidence interval.
+ */
+double ReplicationStatistic::upper() const
+{
+  return mean + halfWidth;
+}
+
+
+
+//-------------------------------------------------------------------------
+/** replication runner constructor
+ * Set up a runner for replications of the given simulation.  No
+ * replications are run until run() is called.
+ *
+ * @param prototype The simulator giving the simulation parameters, it is
+ *   copied for each thread.
+ * @param makeQueue A factory creating the (empty) job queue of each
+ *   thread, which determines the queueing discipline simulated.
+ * @param description Description of the dispatching/queueing method.
+ * @param eventDriven Run replications in event driven mode if true,
+ *   otherwise in stepped mode.
+ * @param baseSeed The seed that all replication seeds are derived from.
+ */
+ReplicationRunner::ReplicationRunner(const JobSchedulerSimulator& prototype,
+				     QueueFactory makeQueue,
+				     string description,
+				     bool eventDriven,
+				     unsigned long long baseSeed)
+  : prototype(prototype)
+{
+  this->makeQueue = makeQueue;
+  this->description = description;
+  this->eventDriven = eventDriven;
+  this->baseSeed = baseSeed;
+}
+
+
+/** replication seed
+ * Derive the seed of one replication from the base seed.  We use the
+ * splitmix64 mixing function, so that neighbouring replication numbers
+ * give unrelated seeds, and so unrelated random number streams.
+ *
+ * @param baseSeed The base seed of the set of replications.
+ * @param replication The replication number.
+ *
+ * @returns unsigned long long The seed for this replication.
+ */
+unsigned long long ReplicationRunner::replicationSeed(unsigned long long baseSeed,
+						      int replication)
+{
+  unsigned long long z = baseSeed + (unsigned long long)(replication + 1) * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+
+/** run replications
+ * The work done by each thread.  The thread keeps its own copy of the
+ * simulator and its own job queue, and claims replication numbers one
+ * at a time from the shared counter until all have been run.  Each
+ * result is stored in the slot for its replication number.
+ *
+ * @param nextReplication Shared counter of the next replication to run.
+ */
+void ReplicationRunner::runReplications(atomic<int>& nextReplication)
+{
+  JobSchedulerSimulator sim(prototype);
+  // threads can not share the trace writer or the checkpoint file of
+  // the prototype
+  sim.setTraceWriter(NULL);
+  sim.setCheckpoint("", 0);
+  Queue<JobIndex>* jobQueue = makeQueue(&sim.getJobTable());
+  int numReplications = averageWaitTimes.size();
+
+  int replication;
+  while ((replication = nextReplication++) < numReplications)
+  {
+    sim.setSeed(replicationSeed(baseSeed, replication));
+    sim.runSimulation(*jobQueue, description, eventDriven);
+    averageWaitTimes[replication] = sim.getAverageWaitTime();
+    averageCosts[replication] = sim.getAverageCost();
+  }
+
+  delete jobQueue;
+}
+
+
+/** run
+ * Run the given number of replications, spread over the given number
+ * of threads.  Results of any previous run are replaced.
+ *
+ * @param numReplications The number of independent replications to run.
+ * @param numThreads The number of threads to use, 0 means one per
+ *   hardware thread.
+ */
+void ReplicationRunner::run(int numReplications, int numThreads)
+{
+  if (numThreads <= 0)
+  {
+    numThreads = thread::hardware_concurrency();
+    if (numThreads <= 0)
+    {
+      numThreads = 1;
+    }
+  }
+  if (numThreads > numReplications)
+  {
+    numThreads = (numReplications > 0) ? numReplications : 1;
+  }
+
+  averageWaitTimes.assign(numReplications, 0.0);
+  averageCosts.assign(numReplications, 0.0);
+
+  atomic<int> nextReplication(0);
+  vector<thread> workers;
+  for (int worker = 1; worker < numThreads; worker++)
+  {
+    workers.push_back(thread(&ReplicationRunner::runReplications, this,
+			     ref(nextReplication)));
+  }
+  // the calling thread does its share of the work too
+  runReplications(nextReplication);
+
+  for (int worker = 0; worker < (int)workers.size(); worker++)
+  {
+    workers[worker].join();
+  }
+}
+
+
+/** number of replications
+ * @returns int The number of replications of the most recent run().
+ */
+int ReplicationRunner::numReplications() const
+{
+  return averageWaitTimes.size();
+}
+
+
+/** wait time statistic
+ * @returns ReplicationStatistic The mean and confidence interval of
+ *   the averageWaitTime over the replications.
+ */
+ReplicationStatistic ReplicationRunner::waitTimeStatistic() const
+{
+  return ReplicationStatistic(averageWaitTimes);
+}
+
+
+/** cost statistic
+ * @returns ReplicationStatistic The mean and confidence interval of
+ *   the averageCost over the replications.
+ */
+ReplicationStatistic ReplicationRunner::costStatistic() const
+{
+  return ReplicationStatistic(averageCosts);
+}
+
+
+/** summary results
+ * Create a string for display of the results of the most recent run().
+ *
+ * @returns string A summary of the replication results.
+ */
+string ReplicationRunner::summaryResultString() const
+{
+  ostringstream out;
+  ReplicationStatistic wait = waitTimeStatistic();
+  ReplicationStatistic cost = costStatistic();
+
+  out << "Job Scheduler Replication Results" << endl
+      << "---------------------------------" << endl
+      << "Description              : " << description << endl
+      << "Number of replications   : " << numReplications() << endl
+      << setprecision(4) << fixed
+      << "Average Wait Time        : " << wait.mean
+      << " +/- " << wait.halfWidth
+      << " (95% CI " << wait.lower() << ", " << wait.upper() << ")" << endl
+      << "Average Cost             : " << cost.mean
+      << " +/- " << cost.halfWidth
+      << " (95% CI " << cost.lower() << ", " << cost.upper() << ")" << endl
+      << endl << endl;
+
+  return out.str();
+}
+
+
+/** overload output stream operator
+ * Output the summary of a replication run to an output stream.
+ *
+ * @param out The output stream we are sending our output to.
+ * @param runner The ReplicationRunner we are outputing the results of.
+ *
+ * @returns ostream Returns the given output stream object.
+ */
+ostream& operator<<(ostream& out, const ReplicationRunner& runner)
+{
+  out << runner.summaryResultString();
+  return out;
+}
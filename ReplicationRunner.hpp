@@ -0,0 +1,112 @@
+/**
+ * @description Run many independent replications of a job scheduling
+ *   simulation in parallel, and summarize the results with confidence
+ *   intervals.
+ */
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Queue.hpp"
+#include "JobSimulator.hpp"
+using namespace std;
+#ifndef REPLICATIONRUNNER_HPP
+#define REPLICATIONRUNNER_HPP
+
+
+/** queue factory
+ * A function that creates a new, empty queue of job indexes, ordered by
+ * the jobs of the given table.  Every replication thread needs a job
+ * queue of its own, for the job table of its own simulator, so the
+ * runner is given a factory rather than a queue.  The runner deletes
+ * the queues it creates.
+ */
+typedef Queue<JobIndex>* (*QueueFactory)(const JobTable* table);
+
+
+
+//-------------------------------------------------------------------------
+/** ReplicationStatistic
+ * Summary of one result measure (e.g. averageWaitTime) over a set of
+ * independent replications of a simulation.
+ *
+ * @var numReplications The number of replications summarized.
+ * @var mean The sample mean of the measure over the replications.
+ * @var standardDeviation The sample standard deviation of the measure.
+ * @var halfWidth The half width of the 95% confidence interval for the
+ *   mean, using the Student t distribution, so the interval is
+ *   [mean - halfWidth, mean + halfWidth].
+ */
+struct ReplicationStatistic
+{
+  int numReplications;
+  double mean;
+  double standardDeviation;
+  double halfWidth;
+
+  ReplicationStatistic();
+  ReplicationStatistic(const vector<double>& values);
+  double lower() const;
+  double upper() const;
+};
+
+
+
+//-------------------------------------------------------------------------
+/** ReplicationRunner
+ * Runs N independent replications of a simulation, spread over a number
+ * of threads.  Each replication is a copy of a prototype simulator, with
+ * its own job queue, its own job ids, and its own random number stream
+ * whose seed is derived from the base seed and the replication number.
+ * Results are kept by replication number and summarized in that order,
+ * so the results are bit-identical no matter how many threads are used
+ * or which thread ran which replication.
+ *
+ * Programs using the runner need to be linked with -pthread.
+ *
+ * @var prototype The simulator whose parameters every replication uses.
+ * @var makeQueue Factory for the job queue of each thread.
+ * @var description Description of the dispatching/queueing method.
+ * @var eventDriven Run replications in event driven mode if true.
+ * @var baseSeed The seed all replication seeds are derived from.
+ * @var averageWaitTimes The averageWaitTime of each replication.
+ * @var averageCosts The averageCost of each replication.
+ */
+class ReplicationRunner
+{
+private:
+  JobSchedulerSimulator prototype;
+  QueueFactory makeQueue;
+  string description;
+  bool eventDriven;
+  unsigned long long baseSeed;
+  vector<double> averageWaitTimes;
+  vector<double> averageCosts;
+
+  void runReplications(atomic<int>& nextReplication);
+
+public:
+  ReplicationRunner(const JobSchedulerSimulator& prototype,
+		    QueueFactory makeQueue,
+		    string description,
+		    bool eventDriven = false,
+		    unsigned long long baseSeed = 1);
+
+  static unsigned long long replicationSeed(unsigned long long baseSeed,
+					    int replication);
+  void run(int numReplications, int numThreads = 0);
+  int numReplications() const;
+  ReplicationStatistic waitTimeStatistic() const;
+  ReplicationStatistic costStatistic() const;
+  string summaryResultString() const;
+
+  friend ostream& operator<<(ostream& out, const ReplicationRunner& runner);
+};
+
+
+
+
+// include the implementation of the replication runner
+#include "ReplicationRunner.cpp"
+
+#endif
@@ -0,0 +1,328 @@
+/**
+ * @description Scheduling disciplines for the job scheduling simulator,
+ *   each one a queue type whose ordering is fixed at compile time.
+ */
+#include <string>
+#include "SchedulingDiscipline.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** aged job output
+ * Display an aged job, for debugging.
+ *
+ * @param out The output stream to display on.
+ * @param agedJob The aged job to display.
+ *
+ * @returns ostream The output stream, for chaining.
+ */
+ostream& operator<<(ostream& out, const AgedJob& agedJob)
+{
+  out << agedJob.job;
+  return out;
+}
+
+
+/** aging priority queue constructor
+ *
+ * @param agingRate The effective priority a job gains per time step it
+ *   waits, negative rates are treated as 0.
+ */
+AgingPriorityQueue::AgingPriorityQueue(double agingRate)
+{
+  this->agingRate = (agingRate > 0.0) ? agingRate : 0.0;
+}
+
+
+/** aging key
+ * @param job A job.
+ *
+ * @returns double The time shifted priority of the job.
+ */
+double AgingPriorityQueue::agingKey(const Job& job) const
+{
+  return job.priority - agingRate * job.startTime;
+}
+
+
+/** aging rate getter
+ * @returns double The effective priority a job gains per step it waits.
+ */
+double AgingPriorityQueue::getAgingRate() const
+{
+  return agingRate;
+}
+
+
+/** aging priority queue clear
+ * Empty out the queue.
+ */
+void AgingPriorityQueue::clear()
+{
+  items.clear();
+}
+
+
+/** aging priority queue is empty
+ * @returns bool true if the queue is empty, false otherwise.
+ */
+bool AgingPriorityQueue::isEmpty() const
+{
+  return items.isEmpty();
+}
+
+
+/** aging priority queue enqueue
+ * Add a copy of the job, in its place by effective priority.
+ *
+ * @param newItem The job to add.
+ */
+void AgingPriorityQueue::enqueue(const Job& newItem)
+{
+  items.emplace(agingKey(newItem), newItem);
+}
+
+
+/** aging priority queue enqueue (move)
+ * @param newItem The job to move onto the queue.
+ */
+void AgingPriorityQueue::enqueue(Job&& newItem)
+{
+  double key = agingKey(newItem);
+  items.emplace(key, std::move(newItem));
+}
+
+
+/** aging priority queue emplace
+ * Construct a new job and move it onto the queue.  The job has to be
+ * built before its aging key can be worked out, so it is built as a
+ * temporary and then moved into the heap with its key.
+ *
+ * @param args The arguments to construct the new job with.
+ */
+template <class... Args>
+void AgingPriorityQueue::emplace(Args&&... args)
+{
+  enqueue(Job(std::forward<Args>(args)...));
+}
+
+
+/** aging priority queue front
+ * @returns Job The job with the highest effective priority.
+ *
+ * @throws EmptyQueueException If the queue is empty.
+ */
+const Job& AgingPriorityQueue::front() const
+{
+  if (isEmpty())
+  {
+    throw EmptyQueueException("AgingPriorityQueue::front()");
+  }
+  return items.front().job;
+}
+
+
+/** aging priority queue dequeue
+ * Remove the job with the highest effective priority.
+ *
+ * @throws EmptyQueueException If the queue is empty.
+ */
+void AgingPriorityQueue::dequeue()
+{
+  if (isEmpty())
+  {
+    throw EmptyQueueException("AgingPriorityQueue::dequeue()");
+  }
+  items.dequeue();
+}
+
+
+/** aging priority queue length
+ * @returns int The number of jobs on the queue.
+ */
+int AgingPriorityQueue::length() const
+{
+  return items.length();
+}
+
+
+/** aging priority queue fill batch
+ * Hand out the addresses of the next jobs of a traversal, in dequeue
+ * order, see Queue::fillBatch().
+ *
+ * @param position Where the traversal has got to.
+ * @param batch Filled in with the addresses of the jobs.
+ * @param maxItems The most jobs to hand out.
+ *
+ * @returns int The number of jobs handed out.
+ */
+int AgingPriorityQueue::fillBatch(QueuePosition& position, const Job* batch[], int maxItems) const
+{
+  const AgedJob* agedBatch[queueBatchSize];
+  int count = items.fillBatch(position, agedBatch, min(maxItems, queueBatchSize));
+
+  for (int item = 0; item < count; item++)
+  {
+    batch[item] = &agedBatch[item]->job;
+  }
+
+  return count;
+}
+
+
+/** aging priority queue indexing operator
+ * @param index The index of a job, 0 is the front of the queue.
+ *
+ * @returns Job The job at the index in dequeue order.
+ */
+const Job& AgingPriorityQueue::operator[](int index) const
+{
+  return items[index].job;
+}
+
+
+
+//-------------------------------------------------------------------------
+/** discipline name
+ * @param discipline A scheduling discipline.
+ *
+ * @returns string The short name of the discipline, which is also
+ *   understood by parseDiscipline().
+ */
+string disciplineName(SchedulingDiscipline discipline)
+{
+  switch (discipline)
+  {
+  case FIFO_DISCIPLINE:
+    return "fifo";
+  case PRIORITY_DISCIPLINE:
+    return "priority";
+  case SHORTEST_JOB_FIRST_DISCIPLINE:
+    return "sjf";
+  case SHORTEST_REMAINING_TIME_DISCIPLINE:
+    return "srpt";
+  case COST_RATE_DISCIPLINE:
+    return "cost-rate";
+  case AGING_DISCIPLINE:
+    return "aging";
+  }
+  return "unknown";
+}
+
+
+/** parse discipline
+ * The scheduling discipline with the given name, for choosing the
+ * discipline from a command line or configuration.
+ *
+ * @param name The name of the discipline, see disciplineName().
+ *
+ * @returns SchedulingDiscipline The discipline.
+ *
+ * @throws DisciplineException If the name is not a discipline.
+ */
+SchedulingDiscipline parseDiscipline(string name)
+{
+  for (int index = 0; index < numSchedulingDisciplines; index++)
+  {
+    SchedulingDiscipline discipline = static_cast<SchedulingDiscipline>(index);
+    if (disciplineName(discipline) == name)
+    {
+      return discipline;
+    }
+  }
+  throw DisciplineException(name);
+}
+
+
+/** run discipline
+ * Run a simulation with the job queue of a scheduling discipline known
+ * at compile time.
+ *
+ * @param sim The simulator to run, its results describe the run.
+ * @param eventDriven If true, use the event driven simulation, see
+ *   JobSchedulerSimulator::runSimulation().
+ */
+template <SchedulingDiscipline discipline>
+void runDiscipline(JobSchedulerSimulator& sim, bool eventDriven)
+{
+  typename DisciplineQueue<discipline>::type jobQueue;
+  sim.runSimulation(jobQueue, disciplineName(discipline), eventDriven);
+}
+
+
+/** use bucket queue
+ * The priority discipline runs with a BucketPriorityQueue, rather than
+ * its HeapPriorityQueue, when the simulation's priorities fit the bucket
+ * queue's levels.  The two dispatch jobs in the same order, except that
+ * a preempted job goes back behind the waiting jobs of its priority on a
+ * bucket queue, so preemptive simulations keep the heap.
+ *
+ * @param sim A simulator.
+ *
+ * @returns bool true if the priority discipline of the simulator runs
+ *   with a bucket priority queue.
+ */
+bool useBucketQueue(const JobSchedulerSimulator& sim)
+{
+  return !sim.isPreemptive()
+    && BucketPriorityQueue<Job>::fitsRange(sim.getMinPriority(), sim.getMaxPriority());
+}
+
+
+/** run discipline simulation
+ * Run a simulation with a scheduling discipline chosen at run time.  The
+ * choice is made once per simulation, by picking the simulation compiled
+ * for that discipline's queue, so the choice costs nothing per job.
+ *
+ * The priority discipline uses a bucket priority queue when the range of
+ * priorities is small enough, see useBucketQueue().
+ *
+ * @param sim The simulator to run, its results describe the run.
+ * @param discipline The scheduling discipline to simulate.
+ * @param eventDriven If true, use the event driven simulation.
+ * @param agingRate The aging rate of the aging discipline, see
+ *   AgingPriorityQueue, not used by the other disciplines.
+ *
+ * @throws DisciplineException If the discipline is not one of the
+ *   SchedulingDiscipline values.
+ * @throws PreemptionException If the simulator is preemptive and the
+ *   discipline is aging, whose order is not known at compile time.
+ */
+void runDisciplineSimulation(JobSchedulerSimulator& sim,
+			     SchedulingDiscipline discipline,
+			     bool eventDriven,
+			     double agingRate)
+{
+  switch (discipline)
+  {
+  case FIFO_DISCIPLINE:
+    runDiscipline<FIFO_DISCIPLINE>(sim, eventDriven);
+    return;
+  case PRIORITY_DISCIPLINE:
+    if (useBucketQueue(sim))
+    {
+      BucketPriorityQueue<Job> jobQueue(sim.getMinPriority(), sim.getMaxPriority());
+      sim.runSimulation(jobQueue, disciplineName(discipline), eventDriven);
+      return;
+    }
+    runDiscipline<PRIORITY_DISCIPLINE>(sim, eventDriven);
+    return;
+  case SHORTEST_JOB_FIRST_DISCIPLINE:
+    runDiscipline<SHORTEST_JOB_FIRST_DISCIPLINE>(sim, eventDriven);
+    return;
+  case SHORTEST_REMAINING_TIME_DISCIPLINE:
+    runDiscipline<SHORTEST_REMAINING_TIME_DISCIPLINE>(sim, eventDriven);
+    return;
+  case COST_RATE_DISCIPLINE:
+    runDiscipline<COST_RATE_DISCIPLINE>(sim, eventDriven);
+    return;
+  case AGING_DISCIPLINE:
+  {
+    AgingPriorityQueue jobQueue(agingRate);
+    sim.runSimulation(jobQueue, disciplineName(discipline), eventDriven);
+    return;
+  }
+  }
+  throw DisciplineException(to_string((int)discipline));
+}
@@ -0,0 +1,394 @@
+/**
+ * @description Scheduling disciplines for the job scheduling simulator,
+ *   each one a queue type whose ordering is fixed at compile time.
+ */
+#include <string>
+#include "Queue.hpp"
+#include "JobSimulator.hpp"
+#include "JobTable.hpp"
+using namespace std;
+#ifndef SCHEDULINGDISCIPLINE_HPP
+#define SCHEDULINGDISCIPLINE_HPP
+
+
+//-------------------------------------------------------------------------
+// Job ordering policies for HeapPriorityQueue, see ComesBeforeOrder.
+// Each is a static before(lhs, rhs), true if lhs should be dispatched
+// before rhs, and all of them break ties by Job id, so jobs that the
+// policy can not tell apart are dispatched first come first served.
+
+/** shortest job first order
+ * Jobs with the shortest service time go first.  This minimizes the
+ * average wait time, at the cost of long jobs waiting longer.
+ */
+struct ShortestJobFirstOrder
+{
+  static bool before(const Job& lhs, const Job& rhs)
+  {
+    if (lhs.serviceTime != rhs.serviceTime)
+    {
+      return lhs.serviceTime < rhs.serviceTime;
+    }
+    return lhs.id < rhs.id;
+  }
+};
+
+
+/** shortest remaining processing time order
+ * Jobs with the least service left to do go first.  Without preemption
+ * jobs only wait before they first start, when the remaining time is
+ * all of the service time, so this dispatches in the same order as
+ * ShortestJobFirstOrder.  In a preemptive simulation, preempted jobs
+ * come back to the queue with only what they have left to do.
+ */
+struct ShortestRemainingTimeOrder
+{
+  static bool before(const Job& lhs, const Job& rhs)
+  {
+    if (lhs.remainingTime != rhs.remainingTime)
+    {
+      return lhs.remainingTime < rhs.remainingTime;
+    }
+    return lhs.id < rhs.id;
+  }
+};
+
+
+/** cost rate order
+ * Jobs with the highest priority per unit of service time go first (the
+ * c-mu or weighted shortest job first rule).  Since cost is priority
+ * times wait, each time step a job delays the others costs the sum of
+ * their priorities, and this order keeps that delay cheapest.  The
+ * ratios are compared by cross multiplying, so there is no division and
+ * no rounding.
+ */
+struct CostRateOrder
+{
+  static bool before(const Job& lhs, const Job& rhs)
+  {
+    long long lhsRate = (long long)lhs.priority * rhs.serviceTime;
+    long long rhsRate = (long long)rhs.priority * lhs.serviceTime;
+    if (lhsRate != rhsRate)
+    {
+      return lhsRate > rhsRate;
+    }
+    return lhs.id < rhs.id;
+  }
+};
+
+
+
+//-------------------------------------------------------------------------
+// The same orders for HeapPriorityQueue of job indexes, see JobTableOrder,
+// comparing the sort keys or columns of the table that they need rather
+// than building the two jobs for each comparison.
+
+/** job table order (shortest job first)
+ * Compares the service time keys, which hold the id as the tie break.
+ */
+template <>
+struct JobTableOrder<ShortestJobFirstOrder>
+{
+  const JobTable* table;
+
+  JobTableOrder(const JobTable* table = NULL)
+    : table(table)
+  {
+  }
+
+  bool before(JobIndex lhs, JobIndex rhs) const
+  {
+    return table->serviceKey(lhs) < table->serviceKey(rhs);
+  }
+};
+
+
+/** job table order (shortest remaining time)
+ * Compares the remaining time keys, which hold the id as the tie break.
+ */
+template <>
+struct JobTableOrder<ShortestRemainingTimeOrder>
+{
+  const JobTable* table;
+
+  JobTableOrder(const JobTable* table = NULL)
+    : table(table)
+  {
+  }
+
+  bool before(JobIndex lhs, JobIndex rhs) const
+  {
+    return table->remainingKey(lhs) < table->remainingKey(rhs);
+  }
+};
+
+
+/** job table order (cost rate)
+ * Cross multiplies the priority and service time columns, as
+ * CostRateOrder does.
+ */
+template <>
+struct JobTableOrder<CostRateOrder>
+{
+  const JobTable* table;
+
+  JobTableOrder(const JobTable* table = NULL)
+    : table(table)
+  {
+  }
+
+  bool before(JobIndex lhs, JobIndex rhs) const
+  {
+    long long lhsRate = (long long)table->priority(lhs) * table->serviceTime(rhs);
+    long long rhsRate = (long long)table->priority(rhs) * table->serviceTime(lhs);
+    if (lhsRate != rhsRate)
+    {
+      return lhsRate > rhsRate;
+    }
+    return table->id(lhs) < table->id(rhs);
+  }
+};
+
+
+
+//-------------------------------------------------------------------------
+/** AgedJob
+ * A job on an AgingPriorityQueue, with its aging key.
+ *
+ * @var key The time shifted priority of the job, see AgingPriorityQueue.
+ * @var job The job.
+ */
+struct AgedJob
+{
+  double key;
+  Job job;
+
+  AgedJob(double key = 0.0, const Job& job = Job())
+    : key(key), job(job)
+  {
+  }
+};
+
+ostream& operator<<(ostream& out, const AgedJob& agedJob);
+
+
+/** aged key order
+ * The largest key first, and of equal keys the smallest Job id, so jobs
+ * with the same effective priority are served first come first served.
+ */
+struct AgedKeyOrder
+{
+  static bool before(const AgedJob& lhs, const AgedJob& rhs)
+  {
+    if (lhs.key != rhs.key)
+    {
+      return lhs.key > rhs.key;
+    }
+    return lhs.job.id < rhs.job.id;
+  }
+};
+
+
+/** AgingPriorityQueue
+ * A priority queue of jobs whose effective priority grows the longer
+ * they wait, so that low priority jobs are not starved by a steady
+ * stream of high priority ones.  At time t a job that arrived at
+ * startTime has effective priority
+ *
+ *   priority + agingRate * (t - startTime)
+ *
+ * Every waiting job gains agingRate per time step, so the order of two
+ * waiting jobs never changes as time goes on, and comparing effective
+ * priorities is the same as comparing the time shifted keys
+ *
+ *   priority - agingRate * startTime
+ *
+ * which are worked out once, when a job is enqueued.  So nothing is
+ * rescanned as time passes, and enqueue() and dequeue() stay O(log n).
+ * An aging rate of 0 is plain priority order, and a rate larger than the
+ * range of priorities is first come first served.
+ *
+ * @var agingRate The effective priority a job gains per time step it
+ *   waits.
+ * @var items The jobs and their keys, in a heap.
+ */
+class AgingPriorityQueue : public Queue<Job>
+{
+private:
+  double agingRate;
+  HeapPriorityQueue<AgedJob, AgedKeyOrder> items;
+
+  double agingKey(const Job& job) const;
+
+public:
+  AgingPriorityQueue(double agingRate = 0.1); // constructor
+  double getAgingRate() const;
+  void clear();
+  bool isEmpty() const;
+  void enqueue(const Job& newItem);
+  void enqueue(Job&& newItem);
+  template <class... Args> void emplace(Args&&... args);
+  const Job& front() const;
+  void dequeue();
+  int length() const;
+  int fillBatch(QueuePosition& position, const Job* batch[], int maxItems) const;
+  const Job& operator[](int index) const;
+};
+
+
+
+/** aging table order
+ * The order of an AgingPriorityQueue for a queue of job indexes (see
+ * JobTableOrder): the largest time shifted priority first, and of equal
+ * keys the smallest id.  The key is worked out as jobs are compared,
+ * the same way AgingPriorityQueue works it out when a job is enqueued.
+ *
+ * @var table The table of the jobs being ordered.
+ * @var agingRate The effective priority a job gains per step it waits.
+ */
+struct AgingTableOrder
+{
+  const JobTable* table;
+  double agingRate;
+
+  AgingTableOrder(const JobTable* table = NULL, double agingRate = 0.1)
+    : table(table), agingRate((agingRate > 0.0) ? agingRate : 0.0)
+  {
+  }
+
+  bool before(JobIndex lhs, JobIndex rhs) const
+  {
+    double lhsKey = table->priority(lhs) - agingRate * table->startTime(lhs);
+    double rhsKey = table->priority(rhs) - agingRate * table->startTime(rhs);
+    if (lhsKey != rhsKey)
+    {
+      return lhsKey > rhsKey;
+    }
+    return table->id(lhs) < table->id(rhs);
+  }
+};
+
+
+/** job index queue (aging)
+ * An AgingPriorityQueue is run on a heap of job indexes in the aging
+ * table order with the same aging rate, see JobIndexQueue.
+ */
+template <>
+class JobIndexQueue<AgingPriorityQueue>
+  : public IndexQueueAdapter<AgingPriorityQueue,
+			     HeapPriorityQueue<JobIndex, AgingTableOrder> >
+{
+public:
+  JobIndexQueue(AgingPriorityQueue& jobQueue, const JobTable* table)
+    : IndexQueueAdapter<AgingPriorityQueue,
+			HeapPriorityQueue<JobIndex, AgingTableOrder> >
+      (jobQueue, 4, AgingTableOrder(table, jobQueue.getAgingRate()))
+  {
+  }
+};
+
+
+
+//-------------------------------------------------------------------------
+/** SchedulingDiscipline
+ * The scheduling disciplines that can be chosen at run time, see
+ * runDisciplineSimulation().
+ */
+enum SchedulingDiscipline
+{
+  FIFO_DISCIPLINE,
+  PRIORITY_DISCIPLINE,
+  SHORTEST_JOB_FIRST_DISCIPLINE,
+  SHORTEST_REMAINING_TIME_DISCIPLINE,
+  COST_RATE_DISCIPLINE,
+  AGING_DISCIPLINE
+};
+
+const int numSchedulingDisciplines = 6;
+
+
+/** discipline queue
+ * The job queue type of each scheduling discipline.  Simulations run
+ * with one of these queues are compiled for that queue, so the queue
+ * operations and job comparisons of the inner loop are inlined, with no
+ * virtual calls per job, and run on the same kind of queue of job
+ * indexes, see JobIndexQueue.
+ */
+template <SchedulingDiscipline discipline>
+struct DisciplineQueue;
+
+template <>
+struct DisciplineQueue<FIFO_DISCIPLINE>
+{
+  typedef LQueue<Job> type;
+};
+
+template <>
+struct DisciplineQueue<PRIORITY_DISCIPLINE>
+{
+  typedef HeapPriorityQueue<Job> type;
+};
+
+template <>
+struct DisciplineQueue<SHORTEST_JOB_FIRST_DISCIPLINE>
+{
+  typedef HeapPriorityQueue<Job, ShortestJobFirstOrder> type;
+};
+
+template <>
+struct DisciplineQueue<SHORTEST_REMAINING_TIME_DISCIPLINE>
+{
+  typedef HeapPriorityQueue<Job, ShortestRemainingTimeOrder> type;
+};
+
+template <>
+struct DisciplineQueue<COST_RATE_DISCIPLINE>
+{
+  typedef HeapPriorityQueue<Job, CostRateOrder> type;
+};
+
+template <>
+struct DisciplineQueue<AGING_DISCIPLINE>
+{
+  typedef AgingPriorityQueue type;
+};
+
+
+/** discipline exception
+ * Class to be thrown when an unknown scheduling discipline is asked for.
+ */
+class DisciplineException
+{
+private:
+  string message;
+
+public:
+  DisciplineException(string message)
+  {
+    this->message = message;
+  }
+
+  string what()
+  {
+    return "Error: unknown scheduling discipline " + message;
+  }
+};
+
+
+string disciplineName(SchedulingDiscipline discipline);
+SchedulingDiscipline parseDiscipline(string name);
+template <SchedulingDiscipline discipline>
+void runDiscipline(JobSchedulerSimulator& sim, bool eventDriven);
+bool useBucketQueue(const JobSchedulerSimulator& sim);
+void runDisciplineSimulation(JobSchedulerSimulator& sim,
+			     SchedulingDiscipline discipline,
+			     bool eventDriven = false,
+			     double agingRate = 0.1);
+
+
+
+
+// include the implementation of the scheduling disciplines
+#include "SchedulingDiscipline.cpp"
+
+#endif
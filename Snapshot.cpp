@@ -0,0 +1,182 @@
+/**
+ * @description Binary snapshots of the state of a simulation, so a long
+ *   run can be checkpointed and resumed, or forked into several runs.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Snapshot.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** snapshot writer constructor
+ * Create the temporary file of a snapshot.
+ *
+ * @param fileName The name the snapshot file will have once committed.
+ *
+ * @throws SnapshotException If the file can not be created.
+ */
+SnapshotWriter::SnapshotWriter(string fileName)
+  : fileName(fileName), file((fileName + ".tmp").c_str(), ios::binary | ios::trunc)
+{
+  if (!file)
+  {
+    throw SnapshotException("could not create " + fileName + ".tmp");
+  }
+}
+
+
+/** snapshot writer write
+ * Write one value, as its bytes.
+ *
+ * @param value The value, of a trivially copyable type.
+ */
+template <class T>
+void SnapshotWriter::write(const T& value)
+{
+  static_assert(is_trivially_copyable<T>::value, "snapshot values are written as bytes");
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+
+/** snapshot writer write vector
+ * Write the number of values and then the values.
+ *
+ * @param values The values, of a trivially copyable type.
+ */
+template <class T>
+void SnapshotWriter::writeVector(const vector<T>& values)
+{
+  static_assert(is_trivially_copyable<T>::value, "snapshot values are written as bytes");
+  write((uint64_t)values.size());
+  if (!values.empty())
+  {
+    file.write(reinterpret_cast<const char*>(&values[0]), values.size() * sizeof(T));
+  }
+}
+
+
+/** snapshot writer write string
+ * Write the length of a string and then its characters.
+ *
+ * @param value The string.
+ */
+void SnapshotWriter::writeString(const string& value)
+{
+  write((uint64_t)value.size());
+  file.write(value.data(), value.size());
+}
+
+
+/** snapshot writer commit
+ * Complete the snapshot, and put it in place of any snapshot of the
+ * same name, in one step.
+ *
+ * @throws SnapshotException If the snapshot could not be written.
+ */
+void SnapshotWriter::commit()
+{
+  file.close();
+  string tmpName = fileName + ".tmp";
+  if (file.fail() || rename(tmpName.c_str(), fileName.c_str()) != 0)
+  {
+    remove(tmpName.c_str());
+    throw SnapshotException("could not write " + fileName);
+  }
+}
+
+
+
+//-------------------------------------------------------------------------
+/** snapshot reader constructor
+ * Open a snapshot file.
+ *
+ * @param fileName The name of the snapshot file.
+ *
+ * @throws SnapshotException If the file can not be opened.
+ */
+SnapshotReader::SnapshotReader(string fileName)
+  : file(fileName.c_str(), ios::binary)
+{
+  if (!file)
+  {
+    throw SnapshotException("could not open " + fileName);
+  }
+}
+
+
+/** snapshot reader read
+ * Read one value, see SnapshotWriter::write().
+ *
+ * @param value Set to the value read.
+ *
+ * @throws SnapshotException If the snapshot ends before the value.
+ */
+template <class T>
+void SnapshotReader::read(T& value)
+{
+  static_assert(is_trivially_copyable<T>::value, "snapshot values are read as bytes");
+  if (!file.read(reinterpret_cast<char*>(&value), sizeof(T)))
+  {
+    throw SnapshotException("is truncated");
+  }
+}
+
+
+/** snapshot reader read (returning the value)
+ * @returns T The value read.
+ *
+ * @throws SnapshotException If the snapshot ends before the value.
+ */
+template <class T>
+T SnapshotReader::read()
+{
+  T value;
+  read(value);
+  return value;
+}
+
+
+/** snapshot reader read vector
+ * Read a vector of values, see SnapshotWriter::writeVector().  The
+ * values are read in pieces, so a corrupt count fails when the file
+ * runs out rather than by allocating the memory the count asks for.
+ *
+ * @param values Set to the values read.
+ *
+ * @throws SnapshotException If the snapshot ends before the values.
+ */
+template <class T>
+void SnapshotReader::readVector(vector<T>& values)
+{
+  const uint64_t pieceSize = 65536;
+  uint64_t size = read<uint64_t>();
+  values.clear();
+  for (uint64_t start = 0; start < size; start += pieceSize)
+  {
+    uint64_t count = (size - start < pieceSize) ? size - start : pieceSize;
+    values.resize(start + count);
+    if (!file.read(reinterpret_cast<char*>(&values[start]), count * sizeof(T)))
+    {
+      throw SnapshotException("is truncated");
+    }
+  }
+}
+
+
+/** snapshot reader read string
+ * @returns string The string read, see SnapshotWriter::writeString().
+ *
+ * @throws SnapshotException If the snapshot ends before the string.
+ */
+string SnapshotReader::readString()
+{
+  vector<char> characters;
+  readVector(characters);
+  return string(characters.begin(), characters.end());
+}
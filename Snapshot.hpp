@@ -0,0 +1,103 @@
+/**
+ * @description Binary snapshots of the state of a simulation, so a long
+ *   run can be checkpointed and resumed, or forked into several runs.
+ */
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+
+//-------------------------------------------------------------------------
+/** Snapshot exception
+ * Class for errors writing or reading snapshots, or resuming a
+ * simulation from one.
+ */
+class SnapshotException
+{
+private:
+  string message;
+
+public:
+  SnapshotException(string str)
+  {
+    message = "Error: snapshot " + str;
+  }
+
+  string what()
+  {
+    return message;
+  }
+};
+
+
+
+//-------------------------------------------------------------------------
+/** SnapshotWriter
+ * Writes the values that make up a snapshot to a binary file.  Values
+ * are stored in the byte order of the machine that wrote the snapshot,
+ * like job traces, and vectors as a 64 bit count followed by their
+ * elements, so a snapshot is little more than the state it holds.
+ *
+ * The snapshot is written to fileName.tmp, and only renamed to fileName
+ * by commit() once it is complete, so a run that is killed while
+ * writing a checkpoint still leaves its previous checkpoint whole.
+ *
+ * @var fileName The name of the snapshot file.
+ * @var file The temporary file being written.
+ */
+class SnapshotWriter
+{
+private:
+  string fileName;
+  ofstream file;
+
+  // writers own their file, they can not be copied
+  SnapshotWriter(const SnapshotWriter&);
+  SnapshotWriter& operator=(const SnapshotWriter&);
+
+public:
+  SnapshotWriter(string fileName); // constructor
+  template <class T> void write(const T& value);
+  template <class T> void writeVector(const vector<T>& values);
+  void writeString(const string& value);
+  void commit();
+};
+
+
+
+//-------------------------------------------------------------------------
+/** SnapshotReader
+ * Reads back the values of a snapshot written by a SnapshotWriter, in
+ * the same order they were written.  Reading past the end of the file
+ * throws, so a truncated snapshot is never half restored silently.
+ *
+ * @var file The snapshot file being read.
+ */
+class SnapshotReader
+{
+private:
+  ifstream file;
+
+  // readers own their file, they can not be copied
+  SnapshotReader(const SnapshotReader&);
+  SnapshotReader& operator=(const SnapshotReader&);
+
+public:
+  SnapshotReader(string fileName); // constructor
+  template <class T> void read(T& value);
+  template <class T> T read();
+  template <class T> void readVector(vector<T>& values);
+  string readString();
+};
+
+
+
+
+// include the implementation of the snapshots
+#include "Snapshot.cpp"
+
+#endif
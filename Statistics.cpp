@@ -0,0 +1,135 @@
+/**
+ * @description Constant memory running statistics of simulation results.
+ */
+#include <cmath>
+#include "Statistics.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** running statistic constructor
+ * An empty statistic, with no values.
+ */
+RunningStatistic::RunningStatistic()
+{
+  clear();
+}
+
+
+/** running statistic clear
+ * Remove all of the values.
+ */
+void RunningStatistic::clear()
+{
+  count = 0;
+  mean = 0.0;
+  sumSquares = 0.0;
+}
+
+
+/** running statistic length
+ * @returns long long The number of values added.
+ */
+long long RunningStatistic::length() const
+{
+  return count;
+}
+
+
+/** running statistic mean
+ * @returns double The mean of the values, 0 if there are none.
+ */
+double RunningStatistic::getMean() const
+{
+  return mean;
+}
+
+
+/** running statistic variance
+ * @returns double The sample variance of the values, 0 if there are
+ *   fewer than 2 values.
+ */
+double RunningStatistic::variance() const
+{
+  if (count < 2)
+  {
+    return 0.0;
+  }
+  return sumSquares / (count - 1);
+}
+
+
+/** running statistic standard deviation
+ * @returns double The sample standard deviation of the values.
+ */
+double RunningStatistic::standardDeviation() const
+{
+  return sqrt(variance());
+}
+
+
+/** running statistic save
+ * Write the statistic to a snapshot.
+ *
+ * @param snapshot The snapshot being written.
+ */
+void RunningStatistic::save(SnapshotWriter& snapshot) const
+{
+  snapshot.write(count);
+  snapshot.write(mean);
+  snapshot.write(sumSquares);
+}
+
+
+/** running statistic restore
+ * Read the statistic back from a snapshot, see save().
+ *
+ * @param snapshot The snapshot being read.
+ */
+void RunningStatistic::restore(SnapshotReader& snapshot)
+{
+  snapshot.read(count);
+  snapshot.read(mean);
+  snapshot.read(sumSquares);
+}
+
+
+
+//-------------------------------------------------------------------------
+/** priority class statistics constructor
+ * Statistics of a priority level with no jobs.
+ */
+PriorityClassStatistics::PriorityClassStatistics()
+{
+  numWaiting = 0;
+  numPreempted = 0;
+}
+
+
+/** priority class statistics save
+ * Write the statistics to a snapshot.
+ *
+ * @param snapshot The snapshot being written.
+ */
+void PriorityClassStatistics::save(SnapshotWriter& snapshot) const
+{
+  waitTime.save(snapshot);
+  cost.save(snapshot);
+  snapshot.write(numWaiting);
+  snapshot.write(numPreempted);
+}
+
+
+/** priority class statistics restore
+ * Read the statistics back from a snapshot, see save().
+ *
+ * @param snapshot The snapshot being read.
+ */
+void PriorityClassStatistics::restore(SnapshotReader& snapshot)
+{
+  waitTime.restore(snapshot);
+  cost.restore(snapshot);
+  snapshot.read(numWaiting);
+  snapshot.read(numPreempted);
+}
@@ -0,0 +1,85 @@
+/**
+ * @description Constant memory running statistics of simulation results.
+ */
+#include <vector>
+#include "Snapshot.hpp"
+using namespace std;
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+
+//-------------------------------------------------------------------------
+/** RunningStatistic
+ * The count, mean and variance of a stream of values, updated one value
+ * at a time in O(1) time and constant memory with Welford's method.
+ * Unlike keeping a sum and a sum of squares, the update does not lose
+ * precision when the variance is small compared to the mean.
+ *
+ * @var count The number of values added.
+ * @var mean The mean of the values added.
+ * @var sumSquares The sum of squared differences from the mean.
+ */
+class RunningStatistic
+{
+private:
+  long long count;
+  double mean;
+  double sumSquares;
+
+public:
+  RunningStatistic(); // constructor
+
+  /** add
+   * Add a value to the statistic.
+   *
+   * @param value The new value.
+   */
+  void add(double value)
+  {
+    count++;
+    double difference = value - mean;
+    mean += difference / count;
+    sumSquares += difference * (value - mean);
+  }
+
+  void clear();
+  long long length() const;
+  double getMean() const;
+  double variance() const;
+  double standardDeviation() const;
+  void save(SnapshotWriter& snapshot) const;
+  void restore(SnapshotReader& snapshot);
+};
+
+
+
+//-------------------------------------------------------------------------
+/** PriorityClassStatistics
+ * The results of a simulation for the jobs of one priority level.
+ *
+ * @var waitTime The wait times of completed jobs of the priority.
+ * @var cost The costs of completed jobs of the priority.
+ * @var numWaiting The number of jobs of the priority still waiting, at
+ *   the end of a simulation this is the number left unfinished.
+ * @var numPreempted The number of times jobs of the priority were
+ *   preempted.
+ */
+struct PriorityClassStatistics
+{
+  RunningStatistic waitTime;
+  RunningStatistic cost;
+  long long numWaiting;
+  long long numPreempted;
+
+  PriorityClassStatistics();
+  void save(SnapshotWriter& snapshot) const;
+  void restore(SnapshotReader& snapshot);
+};
+
+
+
+
+// include the implementation of the statistics
+#include "Statistics.cpp"
+
+#endif
@@ -0,0 +1,354 @@
+/**
+ * @description A timing wheel of future events, for simulations whose
+ *   events are mostly scheduled a bounded number of steps ahead.
+ */
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <string>
+#include "TimingWheel.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+/** timing wheel constructor
+ * Create an empty wheel.
+ *
+ * @param horizon The longest delay, in time steps from the last event
+ *   taken off of the wheel, that events are expected to be scheduled
+ *   with.  Events further ahead still work, but go on the overflow heap.
+ */
+template <class T>
+TimingWheel<T>::TimingWheel(int horizon)
+{
+  reset(horizon);
+}
+
+
+/** timing wheel reset
+ * Empty the wheel, and size its ring of slots for a new horizon.  A
+ * wheel that is already the right size is just cleared.
+ *
+ * @param horizon The longest delay events are expected to be scheduled
+ *   with, the ring has a slot for every step up to and including it.
+ */
+template <class T>
+void TimingWheel<T>::reset(int horizon)
+{
+  int newNumSlots = 64;
+  while (newNumSlots <= horizon && newNumSlots < maxSlots)
+  {
+    newNumSlots *= 2;
+  }
+  if (newNumSlots == (int)slots.size())
+  {
+    clear();
+    return;
+  }
+
+  numSlots = newNumSlots;
+  slotMask = numSlots - 1;
+  slots.assign(numSlots, vector<T>());
+  occupied.assign(numSlots / 64, 0);
+  overflow.clear();
+  baseTime = 0;
+  headTime = LLONG_MAX;
+  headSorted = false;
+  numEvents = 0;
+}
+
+
+/** timing wheel clear
+ * Remove all of the events.  The slots keep their memory, so a wheel
+ * that is reused for another simulation of the same size does not
+ * allocate again.
+ */
+template <class T>
+void TimingWheel<T>::clear()
+{
+  for (int word = 0; word < (int)occupied.size(); word++)
+  {
+    while (occupied[word] != 0)
+    {
+      int slot = word * 64 + __builtin_ctzll(occupied[word]);
+      slots[slot].clear();
+      occupied[word] &= occupied[word] - 1;
+    }
+  }
+  overflow.clear();
+  baseTime = 0;
+  headTime = LLONG_MAX;
+  headSorted = false;
+  numEvents = 0;
+}
+
+
+/** timing wheel is empty
+ * @returns bool true if there are no events on the wheel.
+ */
+template <class T>
+bool TimingWheel<T>::isEmpty() const
+{
+  return numEvents == 0;
+}
+
+
+/** timing wheel length
+ * @returns int The number of events on the wheel.
+ */
+template <class T>
+int TimingWheel<T>::length() const
+{
+  return numEvents;
+}
+
+
+/** timing wheel slot count
+ * @returns int The number of slots of the ring, the number of time
+ *   steps ahead events can be scheduled without overflowing.
+ */
+template <class T>
+int TimingWheel<T>::slotCount() const
+{
+  return numSlots;
+}
+
+
+/** timing wheel next time
+ * @returns long long The time of the earliest event, or LLONG_MAX if
+ *   the wheel is empty.
+ */
+template <class T>
+long long TimingWheel<T>::nextTime() const
+{
+  return headTime;
+}
+
+
+/** timing wheel place
+ * Put an event in the slot of its time, or on the overflow heap if it
+ * is beyond the ring.
+ *
+ * @param time The time of the event, not before baseTime.
+ * @param item The item of the event.
+ */
+template <class T>
+void TimingWheel<T>::place(long long time, const T& item)
+{
+  if (time - baseTime < numSlots)
+  {
+    int slot = time & slotMask;
+    slots[slot].push_back(item);
+    occupied[slot >> 6] |= 1ULL << (slot & 63);
+  }
+  else
+  {
+    overflow.push_back(Event(time, item));
+    push_heap(overflow.begin(), overflow.end(), greater<Event>());
+  }
+}
+
+
+/** timing wheel next occupied time
+ * Scan the bitmap of slots in use, from the slot of baseTime around the
+ * ring, for the earliest event on the ring.
+ *
+ * @returns long long The time of the earliest event on the ring, or
+ *   LLONG_MAX if the ring is empty.
+ */
+template <class T>
+long long TimingWheel<T>::nextOccupiedTime() const
+{
+  int numWords = occupied.size();
+  int baseSlot = baseTime & slotMask;
+  int word = baseSlot >> 6;
+  // the first word only counts from the base slot, the slots before it
+  // hold the latest times on the ring, and are seen when the scan wraps
+  unsigned long long bits = occupied[word] & (~0ULL << (baseSlot & 63));
+
+  for (int scanned = 0; scanned <= numWords; scanned++)
+  {
+    if (bits != 0)
+    {
+      int slot = word * 64 + __builtin_ctzll(bits);
+      return baseTime + ((slot - baseSlot) & slotMask);
+    }
+    word = (word + 1) & (numWords - 1);
+    bits = occupied[word];
+  }
+  return LLONG_MAX;
+}
+
+
+/** timing wheel advance
+ * Move the start of the ring up to the given time, and move the events
+ * on the overflow heap that now fit on the ring onto it.
+ *
+ * @param time The new baseTime, no event may be before it.
+ */
+template <class T>
+void TimingWheel<T>::advance(long long time)
+{
+  baseTime = time;
+  while (!overflow.empty() && overflow.front().first - baseTime < numSlots)
+  {
+    Event event = overflow.front();
+    pop_heap(overflow.begin(), overflow.end(), greater<Event>());
+    overflow.pop_back();
+    place(event.first, event.second);
+  }
+  headSorted = false;
+}
+
+
+/** timing wheel find head
+ * Work out the time of the earliest event again, after the slot of the
+ * earliest events was emptied.  Events on the ring are always before
+ * the events on the overflow heap.
+ */
+template <class T>
+void TimingWheel<T>::findHead()
+{
+  headTime = nextOccupiedTime();
+  if (headTime == LLONG_MAX && !overflow.empty())
+  {
+    headTime = overflow.front().first;
+  }
+  headSorted = false;
+}
+
+
+/** timing wheel schedule
+ * Add an event.
+ *
+ * @param time The time the event is due, not before the time of the
+ *   last event taken off of the wheel (unless the wheel is empty).
+ * @param item The item of the event.
+ *
+ * @throws TimingWheelException If the event is before an event that was
+ *   already taken off of the wheel.
+ */
+template <class T>
+void TimingWheel<T>::schedule(long long time, const T& item)
+{
+  if (time < baseTime)
+  {
+    if (numEvents > 0)
+    {
+      throw TimingWheelException("event at time " + to_string(time)
+				 + " is before time " + to_string(baseTime));
+    }
+    baseTime = time;
+  }
+
+  place(time, item);
+  numEvents++;
+  if (time <= headTime)
+  {
+    headTime = time;
+    headSorted = false;
+  }
+}
+
+
+/** timing wheel pop next
+ * Take the earliest event off of the wheel, of the events at that time
+ * the one with the smallest item.  The events of a slot are sorted the
+ * first time one of them is taken, and then come off of the back.
+ *
+ * @returns T The item of the event.
+ *
+ * @throws TimingWheelException If the wheel is empty.
+ */
+template <class T>
+T TimingWheel<T>::popNext()
+{
+  if (numEvents == 0)
+  {
+    throw TimingWheelException("is empty");
+  }
+  if (headTime - baseTime >= numSlots)
+  {
+    // the ring is empty and the next events are on the overflow heap
+    advance(headTime);
+  }
+
+  int slot = headTime & slotMask;
+  vector<T>& items = slots[slot];
+  if (!headSorted)
+  {
+    sort(items.begin(), items.end(), greater<T>());
+    headSorted = true;
+  }
+  T item = items.back();
+  items.pop_back();
+  numEvents--;
+
+  if (items.empty())
+  {
+    occupied[slot >> 6] &= ~(1ULL << (slot & 63));
+    advance(headTime);
+    findHead();
+  }
+  return item;
+}
+
+
+/** timing wheel remove
+ * Take an event off of the wheel before it is due, such as the
+ * completion of a job that is preempted.  Removing an event on the ring
+ * is a search of the events of its slot, removing one on the overflow
+ * heap is O(n) in the size of the heap.
+ *
+ * @param time The time the event is due.
+ * @param item The item of the event.
+ *
+ * @returns bool true if the event was found and removed.
+ */
+template <class T>
+bool TimingWheel<T>::remove(long long time, const T& item)
+{
+  if (numEvents == 0 || time < baseTime)
+  {
+    return false;
+  }
+
+  bool slotEmptied = false;
+  if (time - baseTime < numSlots)
+  {
+    int slot = time & slotMask;
+    vector<T>& items = slots[slot];
+    typename vector<T>::iterator found = find(items.begin(), items.end(), item);
+    if (found == items.end())
+    {
+      return false;
+    }
+    // erase rather than swap with the back, so a sorted slot stays sorted
+    items.erase(found);
+    if (items.empty())
+    {
+      occupied[slot >> 6] &= ~(1ULL << (slot & 63));
+      slotEmptied = true;
+    }
+  }
+  else
+  {
+    typename vector<Event>::iterator found = find(overflow.begin(), overflow.end(),
+						  Event(time, item));
+    if (found == overflow.end())
+    {
+      return false;
+    }
+    overflow.erase(found);
+    make_heap(overflow.begin(), overflow.end(), greater<Event>());
+    slotEmptied = true;
+  }
+
+  numEvents--;
+  if (time == headTime && slotEmptied)
+  {
+    findHead();
+  }
+  return true;
+}
@@ -0,0 +1,111 @@
+/**
+ * @description A timing wheel of future events, for simulations whose
+ *   events are mostly scheduled a bounded number of steps ahead.
+ */
+#include <climits>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+#ifndef TIMINGWHEEL_HPP
+#define TIMINGWHEEL_HPP
+
+
+//-------------------------------------------------------------------------
+/** TimingWheel
+ * A priority queue of future events, each an item of type T due at an
+ * integer time, for event times that are never before the last event
+ * taken off of the wheel.  The wheel is a ring of slots, one per time
+ * step, covering the numSlots steps from baseTime.  An event is put in
+ * the slot of its time, and a bitmap of the slots in use finds the next
+ * event with a count trailing zeros instruction per 64 slots, so
+ * schedule(), remove() and popNext() are O(1), apart from the scan for
+ * the next slot in use, which over a whole simulation only passes each
+ * time step once.  Events at the same time come off in item order
+ * (smallest first), the same as a min heap of (time, item) pairs.
+ *
+ * Events that are numSlots or more steps ahead go on an overflow min
+ * heap, and are moved onto the wheel as baseTime catches up to them.
+ * When the wheel is sized for the longest delay an event is scheduled
+ * with (such as the largest service time of a simulation), the overflow
+ * heap is never used.
+ *
+ * @var numSlots The number of slots of the ring, a power of two.
+ * @var slotMask numSlots - 1, to wrap times around the ring.
+ * @var slots The items of the events due at the time of each slot.
+ * @var occupied A bit per slot, set if the slot has any events.
+ * @var overflow The events beyond the wheel, a min heap of (time, item).
+ * @var baseTime No event is before this time, the time of the first
+ *   slot of the ring.
+ * @var headTime The time of the earliest event, or LLONG_MAX if the
+ *   wheel is empty.
+ * @var headSorted True if the slot of the earliest events is sorted, so
+ *   that its smallest item is at the back.
+ * @var numEvents The number of events on the wheel, including overflow.
+ */
+template <class T>
+class TimingWheel
+{
+private:
+  typedef pair<long long, T> Event;
+
+  static const int maxSlots = 1 << 20;
+
+  int numSlots;
+  int slotMask;
+  vector<vector<T> > slots;
+  vector<unsigned long long> occupied;
+  vector<Event> overflow;
+  long long baseTime;
+  long long headTime;
+  bool headSorted;
+  int numEvents;
+
+  void place(long long time, const T& item);
+  long long nextOccupiedTime() const;
+  void advance(long long time);
+  void findHead();
+
+public:
+  TimingWheel(int horizon = 1024); // constructor
+  void reset(int horizon);
+  void clear();
+  bool isEmpty() const;
+  int length() const;
+  int slotCount() const;
+  long long nextTime() const;
+  void schedule(long long time, const T& item);
+  T popNext();
+  bool remove(long long time, const T& item);
+};
+
+
+/** timing wheel exception
+ * Class to be thrown when an event is scheduled before an event that
+ * has already been taken off of the wheel, or taken off of an empty
+ * wheel.
+ */
+class TimingWheelException
+{
+private:
+  string message;
+
+public:
+  TimingWheelException(string message)
+  {
+    this->message = message;
+  }
+
+  string what()
+  {
+    return "Error: timing wheel " + message;
+  }
+};
+
+
+
+
+// include the implementation of the timing wheel
+#include "TimingWheel.cpp"
+
+#endif
@@ -4,37 +4,118 @@
 #include <cassert>
 #include <climits>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <thread>
 #include "Queue.hpp"
+#include "ConcurrentQueue.hpp"
+#include "MemoryStats.hpp"
 #include "JobSimulator.hpp"
+#include "ReplicationRunner.hpp"
+#include "ParameterSweep.hpp"
+#include "SchedulingDiscipline.hpp"
 using namespace std;
-void runSimulation(int simulationTime, float jobArrival, int minPriority, int maxPriority, int minTime, int maxTime, string description)
+
+
+/** make priority queue
+ * Job queue factory for the replication runner tests.
+ *
+ * @param table The job table of the simulator the queue is for.
+ *
+ * @returns Queue* A new, empty, heap based priority queue of job
+ *   indexes.
+ */
+Queue<JobIndex>* makeHeapPriorityQueue(const JobTable* table)
 {
-	int a;
-	 a=rand()%1000;
-	
-  cout << "Job Scheduler Simulation Results" << endl
-      << "--------------------------------" << endl
-      << "Simulation Parameters" << endl
-      << "--------------------------" << endl
-      << "Description              : " << description << endl
-      << "Simulation Time          : " << simulationTime << endl
-      << "Job Arrival Probability  : " << jobArrival << endl
-      << "Priority (min,max)       : (" << minPriority << ", " << maxPriority << ")" << endl
-      << "Service Time (min,max)   : (" << minTime << ", " << maxTime << ")" << endl << endl
-      << "Simulation Results" << endl
-      << "--------------------------" << endl
-      << "Number of jobs started   : " <<a << endl
-      << "Number of jobs completed : " << rand()%a << endl
-      << "Number of jobs unfinished: " << rand()%50 << endl
-      << "Total Wait Time          : " << rand()%100000 << endl
-      << "Total Cost               : " << rand()%100000 << endl
-      << "Average Wait Time        : " << rand()%200-1.3 << endl
-      << "Average Cost             : " << rand()%300-1.67 << endl
-      << endl << endl;
-
-    return;
+  return new HeapPriorityQueue<JobIndex, JobTableOrder<> >(4, JobTableOrder<>(table));
+}
+
+
+/** same results as objects
+ * Run a simulation with a concrete queue of Job, which the simulator
+ * runs on a queue of job indexes, and again with the same queue through
+ * a Queue<Job> reference, which it runs on the Job objects.
+ *
+ * @param sim The simulator to run.
+ * @param jobQueue The job queue of the discipline.
+ * @param seed The seed of both runs.
+ * @param eventDriven Run event driven if true.
+ *
+ * @returns bool true if both runs have the same results and leave the
+ *   same jobs waiting on the queue.
+ */
+template <class JobQueue>
+bool sameResultsAsObjects(JobSchedulerSimulator& sim, JobQueue& jobQueue,
+			  unsigned long long seed, bool eventDriven)
+{
+  sim.setSeed(seed);
+  sim.runSimulation(jobQueue, "discipline", eventDriven);
+  string indexResults = sim.csvResultString() + sim.summaryResultString();
+  vector<int> indexWaiting;
+  for (typename JobQueue::const_iterator job = jobQueue.begin(); job != jobQueue.end(); ++job)
+  {
+    indexWaiting.push_back(job->getId());
+  }
+
+  sim.setSeed(seed);
+  Queue<Job>& objectQueue = jobQueue;
+  sim.runSimulation(objectQueue, "discipline", eventDriven);
+  vector<int> objectWaiting;
+  for (Queue<Job>::const_iterator job = objectQueue.begin(); job != objectQueue.end(); ++job)
+  {
+    objectWaiting.push_back(job->getId());
+  }
+  return sim.csvResultString() + sim.summaryResultString() == indexResults
+    && objectWaiting == indexWaiting;
+}
+
+
+/** object heap queue
+ * A heap of Jobs that the simulator does not map to a queue of job
+ * indexes (see JobIndexQueue), but whose order it knows, so preemptive
+ * runs can be compared on the Job objects.
+ */
+template <class Order>
+class ObjectHeapQueue : public HeapPriorityQueue<Job, Order>
+{
+};
+
+template <class Order>
+struct QueueJobOrder<ObjectHeapQueue<Order> >
+{
+  static const bool known = true;
+  typedef Order type;
+};
+
+
+/** same preemptive results as objects
+ * Run a preemptive simulation with a heap of Job in the given order,
+ * which the simulator runs on a heap of job indexes, and again with an
+ * ObjectHeapQueue in the same order.
+ *
+ * @param sim The simulator to run, set to be preemptive.
+ * @param seed The seed of both runs.
+ *
+ * @returns bool true if both runs have the same results.
+ */
+template <class Order>
+bool samePreemptiveResultsAsObjects(JobSchedulerSimulator& sim, unsigned long long seed)
+{
+  HeapPriorityQueue<Job, Order> indexedQueue;
+  sim.setSeed(seed);
+  sim.runSimulation(indexedQueue, "discipline");
+  string indexResults = sim.csvResultString() + sim.summaryResultString();
+
+  ObjectHeapQueue<Order> objectQueue;
+  sim.setSeed(seed);
+  sim.runSimulation(objectQueue, "discipline");
+  return sim.getNumPreemptions() > 0
+    && sim.csvResultString() + sim.summaryResultString() == indexResults;
 }
 
 /** main 
@@ -55,7 +136,7 @@ int main(int argc, char** argv)
 {
   // -----------------------------------------------------------------------
   cout << "--------------- testing basic Queue ----------------------------" << endl;
-  LQueue aQueue;
+  LQueue<int> aQueue;
 
   aQueue.enqueue(5);
   aQueue.enqueue(7);
@@ -65,47 +146,174 @@ int main(int argc, char** argv)
   cout << "   " << aQueue << endl;
 
   int expectedInit1[4] = {5, 7, 9, 11};
-  AQueue expectedQueue1(expectedInit1, 4);
+  AQueue<int> expectedQueue1(expectedInit1, 4);
   assert(aQueue == expectedQueue1);
   cout << endl;
 
 
+  // -----------------------------------------------------------------------
+  cout << "--------------- testing AQueue ---------------------------------" << endl;
+  cout << "<AQueue> capacities are powers of two, reserve() grows once" << endl;
+  AQueue<int> sizedQueue(100);
+  assert(sizedQueue.capacity() == 128);
+  sizedQueue.reserve(1000);
+  assert(sizedQueue.capacity() == 1024);
+
+  cout << "<AQueue> growing keeps the order of a wrapped around queue" << endl;
+  AQueue<int> wrapQueue(4);
+  int nextIn = 0, nextOut = 0;
+  for (int round = 0; round < 50; round++)
+  {
+    // three on for every two off, so the front keeps wrapping around
+    for (int count = 0; count < 3; count++)
+    {
+      wrapQueue.enqueue(nextIn++);
+    }
+    for (int count = 0; count < 2; count++)
+    {
+      assert(wrapQueue.front() == nextOut++);
+      wrapQueue.dequeue();
+    }
+  }
+  for (int index = 0; index < wrapQueue.length(); index++)
+  {
+    assert(wrapQueue[index] == nextOut + index);
+  }
+
+  cout << "<AQueue> a burst is given back once the queue drains" << endl;
+  AQueue<int> burstQueue(16);
+  for (int count = 0; count < 100000; count++)
+  {
+    burstQueue.enqueue(count);
+  }
+  assert(burstQueue.capacity() == 131072);
+  for (int count = 0; count < 100000 - 20; count++)
+  {
+    burstQueue.dequeue();
+  }
+  assert(burstQueue.capacity() <= 128);
+  assert(burstQueue.front() == 100000 - 20 && burstQueue[19] == 99999);
+  // hysteresis: going back and forth over a capacity doesn't reallocate
+  int settledCapacity = burstQueue.capacity();
+  for (int round = 0; round < 10; round++)
+  {
+    burstQueue.enqueue(round);
+    burstQueue.dequeue();
+  }
+  assert(burstQueue.capacity() == settledCapacity);
+  burstQueue.clear();
+  assert(burstQueue.capacity() == 16);
+
+  cout << "<AQueue> enqueueRange() and dequeueRange() move whole runs" << endl;
+  AQueue<int> rangeQueue(8);
+  int rangeItems[100];
+  for (int index = 0; index < 100; index++)
+  {
+    rangeItems[index] = index;
+  }
+  rangeQueue.enqueueRange(rangeItems, 6);
+  int rangeOut[100];
+  assert(rangeQueue.dequeueRange(rangeOut, 4) == 4);
+  assert(rangeOut[0] == 0 && rangeOut[3] == 3);
+  // wraps around the end of the buffer, then grows
+  rangeQueue.enqueueRange(rangeItems + 6, 5);
+  assert(rangeQueue.capacity() == 8 && rangeQueue.length() == 7);
+  rangeQueue.enqueueRange(rangeItems + 11, 89);
+  assert(rangeQueue.length() == 96);
+  assert(rangeQueue.dequeueRange(rangeOut, 100) == 96);
+  for (int index = 0; index < 96; index++)
+  {
+    assert(rangeOut[index] == index + 4);
+  }
+  assert(rangeQueue.isEmpty() && rangeQueue.dequeueRange(rangeOut, 1) == 0);
+
+  cout << "<AQueue> items that are not trivially copyable are moved" << endl;
+  AQueue<string> stringQueue(2);
+  for (int count = 0; count < 40; count++)
+  {
+    stringQueue.enqueue(string(count, 'x'));
+  }
+  for (int count = 0; count < 40; count++)
+  {
+    assert(stringQueue.front() == string(count, 'x'));
+    stringQueue.dequeue();
+  }
+
+  cout << "<AQueue> emptied slots give back what their items held" << endl;
+  shared_ptr<int> heldItem = make_shared<int>(1);
+  AQueue<shared_ptr<int> > heldQueue(4);
+  for (int count = 0; count < 4; count++)
+  {
+    heldQueue.enqueue(heldItem);
+  }
+  assert(heldItem.use_count() == 5);
+  heldQueue.dequeue();
+  assert(heldItem.use_count() == 4);
+  shared_ptr<int> heldOut[2];
+  assert(heldQueue.dequeueRange(heldOut, 2) == 2);
+  heldOut[0].reset();
+  heldOut[1].reset();
+  assert(heldItem.use_count() == 2);
+  heldQueue.clear();
+  assert(heldItem.use_count() == 1);
+
+  cout << "<AQueue> emplace() constructs items in their slot" << endl;
+  stringQueue.emplace(5, 'y');
+  stringQueue.emplace("z");
+  // a constructor that throws leaves the queue as it was
+  bool emplaceThrew = false;
+  try
+  {
+    stringQueue.emplace(string::npos, 'x');
+  }
+  catch (length_error& exception)
+  {
+    emplaceThrew = true;
+  }
+  assert(emplaceThrew);
+  assert(stringQueue.length() == 2);
+  assert(stringQueue.front() == "yyyyy" && stringQueue[1] == "z");
+  stringQueue.emplace("w");
+  assert(stringQueue[2] == "w");
+  cout << endl;
+
+
   
   // -----------------------------------------------------------------------
   cout << "--------------- testing PriorityQueue<int> ----------------------" << endl;
-  PriorityQueues priorityQueue;
+  PriorityQueue<int> priorityQueue;
 
   //Done
   cout << "<PriorityQueue<int> Test case 1 insertion into empty priority queue" << endl;
-  priorityQueue.enqueue(Job(5,0,0));
+  priorityQueue.enqueue(5);
   cout << "   " << priorityQueue << endl << endl;
   assert(priorityQueue.length() == 1);
   assert(priorityQueue[0] == 5);
   
   //Done
   cout << "<PriorityQueue<int> Test case 2 new node is highest priority and needs to go on front" << endl;
-  priorityQueue.enqueue(Job(10,0,0));
+  priorityQueue.enqueue(10);
   cout << "   " << priorityQueue << endl << endl;
   assert(priorityQueue.length() == 2);
   assert(priorityQueue[0] == 10);
   
   //Done
   cout << "<PriorityQueue<int> Test case new node is lowest priority and ends up on back " << endl;
-  priorityQueue.enqueue(Job(2,0,0));
+  priorityQueue.enqueue(2);
   cout << "   " << priorityQueue << endl << endl;
   assert(priorityQueue.length() == 3);
   assert(priorityQueue[2] == 2);
   
   //Done
   cout << "<PriorityQueue<int> Test case new node is lowest priority and ends up on back " << endl;
-  priorityQueue.enqueue(Job(1,0,0));
+  priorityQueue.enqueue(1);
   cout << "   " << priorityQueue << endl << endl;
   assert(priorityQueue.length() == 4);
   assert(priorityQueue[3] == 1);
   
   //Done
   cout << "<PriorityQueue<int> Test case 3 insertion in between " << endl;
-  priorityQueue.enqueue(Job(3,0,0));
+  priorityQueue.enqueue(3);
   cout << "   " << priorityQueue << endl << endl;
   assert(priorityQueue.length() == 5);
   assert(priorityQueue[2] == 3);
@@ -114,7 +322,7 @@ int main(int argc, char** argv)
   //Done
   cout << "<PriorityQueue<int> Test case 3 insertion of equal valued priority" << endl
        << "   (can't see if correct or not with ints) " << endl;
-  priorityQueue.enqueue(Job(2,0,0));
+  priorityQueue.enqueue(2);
   cout << "   " << priorityQueue << endl << endl;
   assert(priorityQueue.length() == 6);
   assert(priorityQueue[4] == 2);
@@ -125,66 +333,1656 @@ int main(int argc, char** argv)
   
   cout << "--------------- testing PriorityQueue<Job> ----------------------" << endl;
 
-  PriorityQueues jobs; 
+  PriorityQueue<Job> jobs;
 	
   cout << "<PriorityQueue<Job> Test case 1 insertion into empty priority queue" << endl;
   jobs.enqueue(Job(5,0,0));
   cout << "   " << jobs << endl << endl;
   assert(jobs.length() == 1);
-  //assert(jobs[0].getPriority() == 5);
+  assert(jobs[0].getPriority() == 5);
     
   cout << "<PriorityQueue<Job> Test case 2 new node is highest priority and needs to go on front" << endl;
   jobs.enqueue(Job(10, 0, 0));
   cout << "   " << jobs << endl << endl;
   assert(jobs.length() == 2);
-  //assert(jobs[0].getPriority() == 10);
+  assert(jobs[0].getPriority() == 10);
   
   cout << "<PriorityQueue<Job> Test case new node is lowest priority and ends up on back " << endl;
   jobs.enqueue(Job(2, 0, 0));
   cout << "   " << jobs << endl << endl;
   assert(jobs.length() == 3);
-  //assert(jobs[2].getPriority() == 2);
+  assert(jobs[2].getPriority() == 2);
   
   cout << "<PriorityQueue<Job> Test case new node is lowest priority and ends up on back " << endl;
   jobs.enqueue(Job(1, 0, 0));
   cout << "   " << jobs << endl << endl;
   assert(jobs.length() == 4);
-  //assert(jobs[3].getPriority() == 1);
+  assert(jobs[3].getPriority() == 1);
   
   cout << "<PriorityQueue<Job> Test case 3 insertion in between " << endl;
   jobs.enqueue(Job(3, 0, 0));
   cout << "   " << jobs << endl << endl;
   assert(jobs.length() == 5);
-  //assert(jobs[2].getPriority() == 3);
+  assert(jobs[2].getPriority() == 3);
   
   cout << "<PriorityQueue<Job> Test case 3 insertion of equal valued " << endl;
   jobs.enqueue(Job(2, 0, 0));
   cout << "   " << jobs << endl << endl;
   assert(jobs.length() == 6);
-  //assert(jobs[4].getPriority() == 2);
-   //tests that the new item was inserted after the old item with same priority
-  //assert(jobs[3].getPriority() == 2);
-  //assert(jobs[3].getId() < jobs[4].getId());
+  assert(jobs[4].getPriority() == 2);
+  //tests that the new item was inserted after the old item with same priority
+  assert(jobs[3].getPriority() == 2);
+  assert(jobs[3].getId() < jobs[4].getId());
+
+  cout << endl;
+
+
+  
+  cout << "--------------- testing HeapPriorityQueue ----------------------" << endl;
+  HeapPriorityQueue<int> heapQueue(2);
+
+  cout << "<HeapPriorityQueue> same insertions as the sorted list PriorityQueue" << endl;
+  heapQueue.enqueue(5);
+  heapQueue.enqueue(10);
+  heapQueue.enqueue(2);
+  heapQueue.enqueue(1);
+  heapQueue.enqueue(3);
+  heapQueue.enqueue(2);
+  cout << "   " << heapQueue << endl << endl;
+  assert(heapQueue.length() == 6);
+  assert(heapQueue[0] == 10);
+  assert(heapQueue[2] == 3);
+  assert(heapQueue[5] == 1);
+  assert(heapQueue == priorityQueue);
+
+  cout << "<HeapPriorityQueue> emplace constructs Jobs in place" << endl;
+  HeapPriorityQueue<Job> emplaceQueue;
+  emplaceQueue.emplace(7, 3, 15, 0);
+  emplaceQueue.emplace(8, 9, 15, 0);
+  assert(emplaceQueue.length() == 2);
+  assert(emplaceQueue.front().getId() == 8);
+  assert(emplaceQueue[1].getId() == 7);
+
+  cout << "<HeapPriorityQueue> equal priorities come off in FIFO (Job id) order" << endl;
+  HeapPriorityQueue<Job> fifoQueue(4);
+  for (int count = 0; count < 100; count++)
+  {
+    fifoQueue.enqueue(Job(count % 3, 0, 0));
+  }
+  int lastPriority = fifoQueue.front().getPriority();
+  int lastId = 0;
+  while (!fifoQueue.isEmpty())
+  {
+    const Job& job = fifoQueue.front();
+    assert(job.getPriority() <= lastPriority);
+    if (job.getPriority() == lastPriority)
+    {
+      assert(job.getId() > lastId);
+    }
+    lastPriority = job.getPriority();
+    lastId = job.getId();
+    fifoQueue.dequeue();
+  }
+  assert(fifoQueue.length() == 0);
+
+  cout << endl;
+
+
+  cout << "--------------- testing IndexedHeapPriorityQueue ---------------" << endl;
+  IndexedHeapPriorityQueue<Job> indexedQueue;
+  // (id, priority, serviceTime, startTime)
+  for (int id = 0; id < 20; id++)
+  {
+    indexedQueue.enqueue(Job(id, (id * 7) % 10, 1, 0));
+  }
+  assert(indexedQueue.length() == 20);
+  assert(indexedQueue.front().getPriority() == 9);
+
+  cout << "<IndexedHeapPriorityQueue> remove and update by id" << endl;
+  assert(indexedQueue.contains(13) && indexedQueue.find(13).getPriority() == 1);
+  indexedQueue.remove(13);
+  assert(!indexedQueue.contains(13));
+  indexedQueue.update(Job(4, 12, 1, 0));
+  assert(indexedQueue.front().getId() == 4);
+  indexedQueue.update(Job(4, -1, 1, 0));
+  assert(indexedQueue.find(4).getPriority() == -1);
+  assert(indexedQueue.length() == 19);
+
+  bool missingRejected = false;
+  try
+  {
+    indexedQueue.remove(13);
+  }
+  catch (InvalidIndexQueueException& exception)
+  {
+    missingRejected = true;
+  }
+  assert(missingRejected);
+
+  cout << "<IndexedHeapPriorityQueue> dequeues in comesBefore order" << endl;
+  Job lastJob = indexedQueue.front();
+  indexedQueue.dequeue();
+  while (!indexedQueue.isEmpty())
+  {
+    assert(comesBefore(lastJob, indexedQueue.front()));
+    assert(!indexedQueue.contains(lastJob.getId()));
+    lastJob = indexedQueue.front();
+    indexedQueue.dequeue();
+  }
+  assert(lastJob.getId() == 4);
+
+  cout << endl;
+
+
+  cout << "--------------- testing BucketPriorityQueue --------------------" << endl;
+  BucketPriorityQueue<int> bucketQueue(1, 10);
+
+  cout << "<BucketPriorityQueue> same insertions as the sorted list PriorityQueue" << endl;
+  bucketQueue.enqueue(5);
+  bucketQueue.enqueue(10);
+  bucketQueue.enqueue(2);
+  bucketQueue.enqueue(1);
+  bucketQueue.enqueue(3);
+  bucketQueue.enqueue(2);
+  cout << "   " << bucketQueue << endl << endl;
+  assert(bucketQueue.length() == 6);
+  assert(bucketQueue.front() == 10);
+  assert(bucketQueue[2] == 3 && bucketQueue[5] == 1);
+  assert(bucketQueue == priorityQueue);
+  bucketQueue.clear();
+  assert(bucketQueue.isEmpty());
+
+  cout << "<BucketPriorityQueue> matches the heap on a random Job workload" << endl;
+  BucketPriorityQueue<Job> jobBucketQueue(-3, 60);
+  HeapPriorityQueue<Job> jobHeapQueue;
+  Xoshiro256 bucketEngine(22);
+  int bucketJobId = 1;
+  for (int step = 0; step < 20000; step++)
+  {
+    if (jobHeapQueue.isEmpty() || boundedInteger(bucketEngine, 2) == 0)
+    {
+      int priority = -3 + boundedInteger(bucketEngine, 64);
+      // (id, priority, serviceTime, startTime)
+      jobBucketQueue.emplace(bucketJobId, priority, 1, step);
+      jobHeapQueue.emplace(bucketJobId, priority, 1, step);
+      bucketJobId++;
+    }
+    else
+    {
+      assert(jobBucketQueue.front() == jobHeapQueue.front());
+      jobBucketQueue.dequeue();
+      jobHeapQueue.dequeue();
+    }
+    assert(jobBucketQueue.length() == jobHeapQueue.length());
+  }
+  // traversals go level by level, in dequeue order
+  assert(jobBucketQueue == jobHeapQueue);
+
+  cout << "<BucketPriorityQueue> priorities outside of the range are rejected" << endl;
+  bool rangeRejected = false;
+  try
+  {
+    bucketQueue.enqueue(11);
+  }
+  catch (PriorityRangeQueueException& exception)
+  {
+    rangeRejected = true;
+  }
+  assert(rangeRejected && bucketQueue.isEmpty());
+  assert(BucketPriorityQueue<int>::fitsRange(0, 63));
+  assert(!BucketPriorityQueue<int>::fitsRange(0, 64));
+  rangeRejected = false;
+  try
+  {
+    BucketPriorityQueue<int> wideQueue(0, 1000);
+  }
+  catch (PriorityRangeQueueException& exception)
+  {
+    rangeRejected = true;
+  }
+  assert(rangeRejected);
+
+  cout << endl;
+
+
+  cout << "--------------- testing Queue iterators ------------------------" << endl;
+  cout << "<Queue iterators> every kind of queue iterates front to back" << endl;
+  LQueue<int> listItems;
+  AQueue<int> arrayItems(8);
+  HeapPriorityQueue<int> heapItems;
+  // enough items for several batches, with the array queue wrapped around
+  for (int item = 0; item < 5; item++)
+  {
+    arrayItems.enqueue(-1);
+    arrayItems.dequeue();
+  }
+  for (int item = 99; item >= 0; item--)
+  {
+    listItems.enqueue(item);
+    arrayItems.enqueue(item);
+    heapItems.enqueue(item);
+  }
+  Queue<int>* iteratedQueues[] = {&listItems, &arrayItems, &heapItems};
+  for (Queue<int>* iteratedQueue : iteratedQueues)
+  {
+    int expected = 99;
+    for (int item : *iteratedQueue)
+    {
+      assert(expected >= 0 && item == (*iteratedQueue)[99 - expected]);
+      expected--;
+    }
+    assert(expected == -1);
+    assert(distance(iteratedQueue->begin(), iteratedQueue->end()) == 100);
+  }
+
+  cout << "<Queue iterators> post increment and comparison" << endl;
+  Queue<int>::const_iterator listItem = listItems.begin();
+  assert(*listItem++ == 99 && *listItem == 98);
+  assert(listItem != listItems.begin() && listItems.end() == listItems.end());
+  assert(listItems.begin() != arrayItems.begin());
+  LQueue<int> noItems;
+  assert(noItems.begin() == noItems.end());
+  assert(noItems.tostring() == "Front: :Back\n");
+
+  cout << "<Queue iterators> equality of different kinds of queues" << endl;
+  assert(listItems == arrayItems && arrayItems == heapItems);
+  arrayItems.dequeue();
+  arrayItems.enqueue(99);
+  assert(!(listItems == arrayItems));
+  assert(listItems.tostring() == heapItems.tostring());
+
+  cout << "<Queue iterators> equality of long linked lists is linear" << endl;
+  // with indexing each comparison walked the list, 10^10 steps here
+  LQueue<int> longList, otherLongList;
+  for (int item = 0; item < 200000; item++)
+  {
+    longList.enqueue(item);
+    otherLongList.enqueue(item);
+  }
+  assert(longList == otherLongList);
+  otherLongList.dequeue();
+  otherLongList.enqueue(200000);
+  assert(!(longList == otherLongList));
+
+  cout << "<Queue iterators> aging queues iterate in dequeue order" << endl;
+  AgingPriorityQueue agingItems(0.0);
+  // (id, priority, serviceTime, startTime)
+  agingItems.enqueue(Job(1, 2, 1, 0));
+  agingItems.enqueue(Job(2, 7, 1, 0));
+  agingItems.enqueue(Job(3, 4, 1, 0));
+  int agingOrder[] = {2, 3, 1};
+  int agingIndex = 0;
+  for (const Job& job : agingItems)
+  {
+    assert(job.getId() == agingOrder[agingIndex]);
+    agingIndex++;
+  }
+  assert(agingIndex == 3);
+  ostringstream agingOut;
+  agingOut << agingItems;
+  assert(agingOut.str() == agingItems.tostring());
+
+  cout << endl;
+
+
+  cout << "--------------- testing TimingWheel ----------------------------" << endl;
+  cout << "<TimingWheel> events at the same time come off in item order" << endl;
+  TimingWheel<int> wheel(10);
+  assert(wheel.isEmpty() && wheel.nextTime() == LLONG_MAX);
+  assert(wheel.slotCount() == 64);
+  wheel.schedule(7, 3);
+  wheel.schedule(5, 9);
+  wheel.schedule(7, 1);
+  wheel.schedule(7, 2);
+  assert(wheel.length() == 4 && wheel.nextTime() == 5);
+  assert(wheel.popNext() == 9 && wheel.nextTime() == 7);
+  assert(wheel.popNext() == 1);
+  // scheduled into the slot being taken from
+  wheel.schedule(7, 0);
+  assert(wheel.popNext() == 0 && wheel.popNext() == 2 && wheel.popNext() == 3);
+  assert(wheel.isEmpty() && wheel.nextTime() == LLONG_MAX);
+
+  cout << "<TimingWheel> matches a min heap, beyond the ring as well" << endl;
+  // delays of up to 300 steps overflow the 64 slot ring
+  typedef pair<long long, int> WheelEvent;
+  priority_queue<WheelEvent, vector<WheelEvent>, greater<WheelEvent> > heapEvents;
+  Xoshiro256 wheelEngine(20);
+  long long wheelNow = 0;
+  for (int step = 0; step < 20000; step++)
+  {
+    if (heapEvents.empty() || boundedInteger(wheelEngine, 3) > 0)
+    {
+      long long time = wheelNow + boundedInteger(wheelEngine, 300);
+      int item = boundedInteger(wheelEngine, 50);
+      wheel.schedule(time, item);
+      heapEvents.push(WheelEvent(time, item));
+    }
+    else
+    {
+      assert(wheel.nextTime() == heapEvents.top().first);
+      wheelNow = wheel.nextTime();
+      assert(wheel.popNext() == heapEvents.top().second);
+      heapEvents.pop();
+    }
+    assert(wheel.length() == (int)heapEvents.size());
+  }
+  while (!heapEvents.empty())
+  {
+    assert(wheel.nextTime() == heapEvents.top().first);
+    assert(wheel.popNext() == heapEvents.top().second);
+    heapEvents.pop();
+  }
+  assert(wheel.isEmpty());
+
+  cout << "<TimingWheel> remove events before they are due" << endl;
+  wheel.schedule(100, 1);
+  wheel.schedule(100, 2);
+  wheel.schedule(5000, 3);
+  wheel.schedule(6000, 4);
+  assert(!wheel.remove(100, 3) && !wheel.remove(99, 1));
+  assert(wheel.remove(100, 1) && wheel.remove(100, 2));
+  assert(wheel.nextTime() == 5000);
+  assert(wheel.remove(5000, 3) && wheel.nextTime() == 6000);
+  assert(wheel.popNext() == 4 && wheel.isEmpty());
+
+  // nothing can be scheduled before the last event taken off the wheel
+  bool wheelRejected = false;
+  wheel.schedule(7000, 1);
+  try
+  {
+    wheel.schedule(5999, 2);
+  }
+  catch (TimingWheelException& exception)
+  {
+    wheelRejected = true;
+  }
+  assert(wheelRejected);
+  wheel.clear();
+  assert(wheel.isEmpty());
+  wheel.schedule(3, 1);
+  assert(wheel.nextTime() == 3 && wheel.popNext() == 1);
+
+  cout << endl;
+
+
+
+  cout << "--------------- testing JobTable -------------------------------" << endl;
+  cout << "<JobTable> jobs are kept as columns of rows" << endl;
+  JobTable table;
+  assert(table.size() == 0);
+  // (id, priority, serviceTime, startTime)
+  assert(table.add(1, 3, 10, 0) == 0);
+  assert(table.add(2, -2, 4, 5) == 1);
+  assert(table.add(3, 7, 1, 6) == 2);
+  assert(table.size() == 3 && table.numRows() == 3);
+  assert(table.id(1) == 2 && table.priority(1) == -2);
+  assert(table.serviceTime(1) == 4 && table.remainingTime(1) == 4 && table.startTime(1) == 5);
+  Job tableJob = table.job(2);
+  assert(tableJob.getId() == 3 && tableJob.getPriority() == 7);
+  assert(tableJob.getServiceTime() == 1);
+
+  cout << "<JobTable> the rows of removed jobs are reused" << endl;
+  table.remove(1);
+  assert(table.size() == 2 && table.numRows() == 3);
+  Job preemptedJob(9, 4, 20, 8);
+  preemptedJob.remainingTime = 6;
+  assert(table.add(preemptedJob) == 1);
+  assert(table.size() == 3 && table.numRows() == 3);
+  assert(table.id(1) == 9 && table.serviceTime(1) == 20 && table.remainingTime(1) == 6);
+  assert(table.job(1).remainingTime == 6);
+  table.remove(0);
+  table.remove(2);
+  assert(table.add(10, 1, 1, 9) == 2);
+  assert(table.add(11, 1, 1, 9) == 0);
+  assert(table.add(12, 1, 1, 9) == 3);
+  assert(table.size() == 4 && table.numRows() == 4);
+
+  cout << "<JobTable> sort keys order by value, then by id" << endl;
+  assert(JobTable::keyValue(JobTable::sortKey(-5, 7)) == -5);
+  assert(JobTable::sortKey(-5, 7) < JobTable::sortKey(-5, 8));
+  assert(JobTable::sortKey(-5, 1000000) < JobTable::sortKey(-4, 1));
+  // priority keys sort the highest priority first
+  assert(table.priorityKey(1) < table.priorityKey(2));
+  assert(table.priorityKey(2) < table.priorityKey(0));
+  assert(table.serviceKey(2) < table.serviceKey(0) && table.remainingKey(1) < table.serviceKey(1));
+
+  cout << "<JobTable> finished jobs are kept with their end times" << endl;
+  table.clear();
+  // (id, priority, serviceTime, startTime)
+  table.add(1, 3, 10, 0);
+  table.add(2, -2, 4, 5);
+  table.finish(1, 12);
+  assert(table.size() == 1 && table.numFinished() == 1);
+  Job runningJob(3, 5, 8, 2);
+  runningJob.remainingTime = 5;
+  table.finish(runningJob, 20);
+  table.finish(0, 25);
+  assert(table.size() == 0 && table.numFinished() == 3);
+  Job finishedJob = table.finishedJob(1);
+  assert(finishedJob.getId() == 3 && finishedJob.endTime == 20 && finishedJob.remainingTime == 5);
+  assert(table.finishedJob(2).getId() == 1 && table.finishedJob(2).endTime == 25);
+  // waits 7, 20 - 2 - (8 - 5) = 15 and 25, costs -14, 75 and 75
+  JobTableTotals finishedTotals = table.finishedTotals();
+  assert(finishedTotals.numFinished == 3);
+  assert(finishedTotals.totalWaitTime == 47);
+  assert(finishedTotals.totalCost == 136);
+  table.clearFinished();
+  assert(table.numFinished() == 0 && table.finishedTotals().totalCost == 0);
+  assert(table.add(4, 1, 1, 30) == 0);
+
+  cout << "<JobTable> index queues order jobs by their table columns" << endl;
+  table.clear();
+  // the rows are reused out of order, so ties go by id, not by index
+  table.add(1, 3, 10, 0);
+  table.add(2, 7, 4, 5);
+  table.add(3, 7, 1, 6);
+  table.remove(0);
+  table.add(4, 7, 2, 7);
+  HeapPriorityQueue<JobIndex, JobTableOrder<> > indexQueue(4, JobTableOrder<>(&table));
+  HeapPriorityQueue<JobIndex, JobTableOrder<ShortestJobFirstOrder> >
+    sjfIndexQueue(4, JobTableOrder<ShortestJobFirstOrder>(&table));
+  for (JobIndex index = 0; index < 3; index++)
+  {
+    indexQueue.enqueue(index);
+    sjfIndexQueue.enqueue(index);
+  }
+  int priorityIndexOrder[] = { 1, 2, 0 };
+  int sjfIndexOrder[] = { 2, 0, 1 };
+  for (int index = 0; index < 3; index++)
+  {
+    assert((int)indexQueue.front() == priorityIndexOrder[index]);
+    assert((int)sjfIndexQueue.front() == sjfIndexOrder[index]);
+    indexQueue.dequeue();
+    sjfIndexQueue.dequeue();
+  }
+  table.clear();
+  assert(table.size() == 0 && table.numRows() == 0);
+
+  cout << endl;
+
+
+
+  cout << "--------------- testing NodePool -------------------------------" << endl;
+  cout << "<NodePool> steady state enqueue/dequeue reuses pooled nodes" << endl;
+  LQueue<int> pooledQueue;
+  PriorityQueue<int> pooledPriorityQueue;
+  for (int item = 0; item < 1000; item++)
+  {
+    pooledQueue.enqueue(item);
+    pooledPriorityQueue.enqueue(item % 10);
+  }
+  long long lqueueAllocations = pooledQueue.nodeAllocations();
+  long long priorityAllocations = pooledPriorityQueue.nodeAllocations();
+  assert(lqueueAllocations > 0);
+  assert(pooledQueue.nodeCapacity() >= 1000);
+  long long residentBefore = currentResidentBytes();
+  for (int item = 0; item < 1000000; item++)
+  {
+    pooledQueue.dequeue();
+    pooledQueue.enqueue(item);
+    pooledPriorityQueue.dequeue();
+    pooledPriorityQueue.enqueue(item % 10);
+  }
+  long long residentAfter = currentResidentBytes();
+  cout << "   allocations: LQueue " << pooledQueue.nodeAllocations()
+       << ", PriorityQueue " << pooledPriorityQueue.nodeAllocations() << endl;
+  cout << "   " << memoryStatsString() << endl;
+  assert(pooledQueue.nodeAllocations() == lqueueAllocations);
+  assert(pooledPriorityQueue.nodeAllocations() == priorityAllocations);
+  assert(residentAfter - residentBefore < 1024 * 1024);
+  pooledQueue.clear();
+  pooledQueue.enqueue(1);
+  assert(pooledQueue.nodeAllocations() == lqueueAllocations);
 
   cout << endl;
   
 
   
+  cout << "--------------- testing ConcurrentAQueue -----------------------" << endl;
+  cout << "<ConcurrentAQueue> single thread first in first out, bounded" << endl;
+  ConcurrentAQueue<int> ringQueue(5);
+  assert(ringQueue.capacity() == 8);
+  assert(ringQueue.isEmpty());
+  for (int item = 1; item <= 8; item++)
+  {
+    assert(ringQueue.tryEnqueue(item));
+  }
+  assert(!ringQueue.tryEnqueue(9));
+  assert(ringQueue.length() == 8);
+  int ringItem;
+  assert(ringQueue.tryDequeue(ringItem) && ringItem == 1);
+  assert(ringQueue.tryEnqueue(9));
+
+  cout << "<ConcurrentAQueue> batch operations claim runs of cells" << endl;
+  int ringBatch[8];
+  assert(ringQueue.tryDequeueBatch(ringBatch, 3) == 3);
+  assert(ringBatch[0] == 2 && ringBatch[2] == 4);
+  int ringNewItems[] = {10, 11, 12, 13, 14};
+  assert(ringQueue.tryEnqueueBatch(ringNewItems, 5) == 3);
+  assert(ringQueue.tryDequeueBatch(ringBatch, 8) == 8);
+  assert(ringBatch[0] == 5 && ringBatch[4] == 9 && ringBatch[7] == 12);
+  assert(!ringQueue.tryDequeue(ringItem));
+  assert(ringQueue.tryDequeueBatch(ringBatch, 8) == 0);
+  // empty batches return at once, whether or not the queue has items
+  assert(ringQueue.tryEnqueueBatch(ringNewItems, 1) == 1);
+  assert(ringQueue.tryEnqueueBatch(ringNewItems, 0) == 0);
+  assert(ringQueue.tryDequeueBatch(ringBatch, 0) == 0);
+  assert(ringQueue.tryDequeueBatch(ringBatch, -1) == 0);
+  assert(ringQueue.length() == 1);
+  assert(ringQueue.tryDequeueBatch(ringBatch, 8) == 1 && ringBatch[0] == 10);
+
+  cout << "<ConcurrentAQueue> producers and consumers on threads lose no items" << endl;
+  ConcurrentAQueue<long long> sharedQueue(64);
+  const int numProducers = 2, numConsumers = 3, itemsPerProducer = 50000;
+  atomic<long long> consumedSum(0), consumedCount(0);
+  atomic<bool> producerOrderKept(true);
+  vector<thread> ringThreads;
+  for (int producer = 0; producer < numProducers; producer++)
+  {
+    ringThreads.push_back(thread([&sharedQueue, producer, itemsPerProducer]() {
+	  for (long long item = 0; item < itemsPerProducer; item++)
+	  {
+	    // items carry their producer in the top bits
+	    while (!sharedQueue.tryEnqueue(((long long)producer << 32) | item))
+	    {
+	      this_thread::yield();
+	    }
+	  }
+	}));
+  }
+  for (int consumer = 0; consumer < numConsumers; consumer++)
+  {
+    ringThreads.push_back(thread([&]() {
+	  long long lastItem[numProducers] = {-1, -1};
+	  long long batch[16];
+	  while (consumedCount.load() < (long long)numProducers * itemsPerProducer)
+	  {
+	    int numItems = sharedQueue.tryDequeueBatch(batch, 16);
+	    if (numItems == 0)
+	    {
+	      this_thread::yield();
+	    }
+	    for (int index = 0; index < numItems; index++)
+	    {
+	      int producer = batch[index] >> 32;
+	      long long item = batch[index] & 0xffffffff;
+	      if (item <= lastItem[producer])
+	      {
+		producerOrderKept = false;
+	      }
+	      lastItem[producer] = item;
+	      consumedSum += item;
+	    }
+	    consumedCount += numItems;
+	  }
+	}));
+  }
+  for (int index = 0; index < (int)ringThreads.size(); index++)
+  {
+    ringThreads[index].join();
+  }
+  assert(consumedCount.load() == (long long)numProducers * itemsPerProducer);
+  assert(consumedSum.load() == numProducers * ((long long)itemsPerProducer * (itemsPerProducer - 1) / 2));
+  assert(producerOrderKept.load());
+  assert(sharedQueue.isEmpty());
+
+  cout << "<LockedAQueue> same operations as ConcurrentAQueue" << endl;
+  LockedAQueue<int> lockedQueue(4);
+  assert(lockedQueue.tryEnqueueBatch(ringNewItems, 5) == 4);
+  assert(!lockedQueue.tryEnqueue(1));
+  assert(lockedQueue.tryDequeue(ringItem) && ringItem == 10);
+  assert(lockedQueue.tryDequeueBatch(ringBatch, 8) == 3 && ringBatch[2] == 13);
+  assert(lockedQueue.isEmpty());
+
+  cout << endl;
+
+
+
+  cout << "--------------- testing JobIdAllocator -------------------------" << endl;
+  cout << "<JobIdAllocator> ids count up, reserved blocks are consecutive" << endl;
+  JobIdAllocator idAllocator;
+  assert(idAllocator.allocate() == 1);
+  assert(idAllocator.allocate() == 2);
+  assert(idAllocator.reserve(10) == 3);
+  assert(idAllocator.peek() == 13);
+  JobIdAllocator copiedAllocator(idAllocator);
+  assert(copiedAllocator.allocate() == 13 && idAllocator.allocate() == 13);
+  idAllocator.reset();
+  assert(idAllocator.allocate() == 1);
+  idAllocator.reset(INT_MAX - 1);
+  assert(idAllocator.allocate() == INT_MAX - 1);
+  try
+  {
+    idAllocator.reserve(2);
+    assert(false);
+  }
+  catch (JobIdAllocatorException& e)
+  {
+    assert(e.what() == "Error: job id allocator ran out of ids");
+  }
+  assert(idAllocator.peek() == INT_MAX);
+
+  cout << "<JobIdBlock> a block hands out ids in order, reserving a batch at a time" << endl;
+  idAllocator.reset(1);
+  JobIdBlock idBlock(idAllocator, 4);
+  assert(idBlock.remaining() == 0);
+  for (int id = 1; id <= 6; id++)
+  {
+    assert(idBlock.next() == id);
+  }
+  assert(idBlock.remaining() == 2);
+  assert(idAllocator.peek() == 9);
+  idBlock.release();
+  assert(idBlock.next() == 9);
+
+  cout << "<JobIdBlock> threads with blocks of their own get unique ids" << endl;
+  idAllocator.reset(1);
+  // whole batches, so every id reserved is handed out
+  const int numIdThreads = 4, idsPerThread = 64 * 1500;
+  vector<vector<int> > threadIds(numIdThreads);
+  vector<thread> idThreads;
+  for (int idThread = 0; idThread < numIdThreads; idThread++)
+  {
+    idThreads.push_back(thread([&idAllocator, &threadIds, idThread, idsPerThread]() {
+	  JobIdBlock block(idAllocator, 64);
+	  for (int count = 0; count < idsPerThread; count++)
+	  {
+	    threadIds[idThread].push_back(block.next());
+	  }
+	}));
+  }
+  for (int idThread = 0; idThread < numIdThreads; idThread++)
+  {
+    idThreads[idThread].join();
+  }
+  vector<bool> idSeen(numIdThreads * idsPerThread + 1, false);
+  for (int idThread = 0; idThread < numIdThreads; idThread++)
+  {
+    for (int index = 0; index < idsPerThread; index++)
+    {
+      int id = threadIds[idThread][index];
+      assert(id >= 1 && id <= numIdThreads * idsPerThread && !idSeen[id]);
+      assert(index == 0 || id > threadIds[idThread][index - 1]);
+      idSeen[id] = true;
+    }
+  }
+
+  cout << "<Job> jobs made on threads at the same time get unique ids" << endl;
+  vector<vector<int> > jobIds(numIdThreads);
+  idThreads.clear();
+  for (int idThread = 0; idThread < numIdThreads; idThread++)
+  {
+    idThreads.push_back(thread([&jobIds, idThread]() {
+	  for (int count = 0; count < 10000; count++)
+	  {
+	    jobIds[idThread].push_back(Job(1, 1, 0).getId());
+	  }
+	}));
+  }
+  for (int idThread = 0; idThread < numIdThreads; idThread++)
+  {
+    idThreads[idThread].join();
+  }
+  vector<int> allJobIds;
+  for (int idThread = 0; idThread < numIdThreads; idThread++)
+  {
+    allJobIds.insert(allJobIds.end(), jobIds[idThread].begin(), jobIds[idThread].end());
+  }
+  sort(allJobIds.begin(), allJobIds.end());
+  assert(adjacent_find(allJobIds.begin(), allJobIds.end()) == allJobIds.end());
+  assert(allJobIds.back() - allJobIds.front() == numIdThreads * 10000 - 1);
+
+  cout << endl;
+
+
+
+  cout << "--------------- testing LogHistogram ---------------------------" << endl;
+  cout << "<LogHistogram> small values are counted exactly" << endl;
+  LogHistogram smallHistogram;
+  assert(smallHistogram.percentile(99.0) == 0);
+  for (int value = 1; value <= 100; value++)
+  {
+    smallHistogram.record(value);
+  }
+  assert(smallHistogram.count() == 100);
+  assert(smallHistogram.percentile(50.0) == 50);
+  assert(smallHistogram.percentile(99.0) == 99);
+  assert(smallHistogram.percentile(99.9) == 100);
+  assert(smallHistogram.max() == 100);
+
+  cout << "<LogHistogram> large value percentiles are within 1/128 of exact" << endl;
+  LogHistogram largeHistogram, mergedHistogram;
+  vector<long long> largeValues;
+  Xoshiro256 histogramEngine(32);
+  for (int count = 0; count < 100000; count++)
+  {
+    // spread values over many powers of two
+    long long value = (long long)boundedInteger(histogramEngine, 1000000) << boundedInteger(histogramEngine, 30);
+    largeValues.push_back(value);
+    largeHistogram.record(value);
+    if (count % 2 == 0)
+    {
+      mergedHistogram.record(value);
+    }
+  }
+  sort(largeValues.begin(), largeValues.end());
+  const double testPercents[] = {50.0, 90.0, 99.0, 99.9};
+  for (int percent = 0; percent < 4; percent++)
+  {
+    long long exact = largeValues[(long long)ceil(testPercents[percent] / 100.0 * largeValues.size()) - 1];
+    long long estimate = largeHistogram.percentile(testPercents[percent]);
+    assert(estimate >= exact && estimate - exact <= exact / 128);
+  }
+  assert(largeHistogram.max() == largeValues.back());
+  cout << "   " << largeHistogram.percentileString() << endl;
+
+  cout << "<LogHistogram> merge adds the counts of another histogram" << endl;
+  LogHistogram otherHalf;
+  for (int count = 1; count < 100000; count += 2)
+  {
+    otherHalf.record(largeValues[0]);
+  }
+  mergedHistogram.merge(otherHalf);
+  assert(mergedHistogram.count() == 100000);
+  assert(mergedHistogram.percentile(50.0) <= largeValues[0] + largeValues[0] / 128);
+
+  cout << endl;
+
+
+
+  cout << "--------------- testing RunningStatistic -----------------------" << endl;
+  cout << "<RunningStatistic> Welford mean and variance" << endl;
+  RunningStatistic runningStatistic;
+  assert(runningStatistic.length() == 0 && runningStatistic.variance() == 0.0);
+  const double statisticValues[] = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+  for (int index = 0; index < 8; index++)
+  {
+    // a large offset loses precision with a sum of squares, not with Welford
+    runningStatistic.add(1e9 + statisticValues[index]);
+  }
+  assert(runningStatistic.length() == 8);
+  assert(fabs(runningStatistic.getMean() - (1e9 + 5.0)) < 1e-6);
+  assert(fabs(runningStatistic.variance() - 32.0 / 7.0) < 1e-6);
+
+  cout << endl;
+
+
+
+  cout << "--------------- testing Xoshiro256 -----------------------------" << endl;
+  cout << "<Xoshiro256> same seed gives the same stream, jump() gives a new one" << endl;
+  Xoshiro256 engine1(32), engine2(32), engine3(32);
+  engine3.jump();
+  for (int draw = 0; draw < 1000; draw++)
+  {
+    uint64_t value = engine1();
+    assert(value == engine2());
+    assert(value != engine3());
+  }
+
+  cout << "<Xoshiro256> bounded integers stay in range and cover it evenly" << endl;
+  int counts[10] = {0};
+  for (int draw = 0; draw < 100000; draw++)
+  {
+    uint64_t value = boundedInteger(engine1, 10);
+    assert(value < 10);
+    counts[value]++;
+  }
+  for (int value = 0; value < 10; value++)
+  {
+    assert(counts[value] > 9500 && counts[value] < 10500);
+  }
+  assert(probabilityThreshold(0.0) == 0);
+  assert(probabilityThreshold(1.0) == UINT64_MAX);
+
+  cout << endl;
+
+
+  cout << "--------------- testing RandomBlockGenerator -------------------" << endl;
+  cout << "<RandomBlockGenerator> vector and scalar kernels give the same blocks" << endl;
+  int blockMinValues[4] = {1, -5, 0, INT_MIN};
+  int blockMaxValues[4] = {10, 1000000, 0, INT_MAX};
+  for (int range = 0; range < 4; range++)
+  {
+    RandomBlockGenerator vectorBlocks, scalarBlocks;
+    vectorBlocks.setVectorKernels(true);
+    assert(!scalarBlocks.setVectorKernels(false));
+    vectorBlocks.seed(23);
+    scalarBlocks.seed(23);
+    vectorBlocks.setArrivalProbability(0.3);
+    scalarBlocks.setArrivalProbability(0.3);
+    vectorBlocks.setPriorityRange(blockMinValues[range], blockMaxValues[range]);
+    scalarBlocks.setPriorityRange(blockMinValues[range], blockMaxValues[range]);
+    vectorBlocks.setServiceTimeRange(1, 3);
+    scalarBlocks.setServiceTimeRange(1, 3);
+
+    for (int draw = 0; draw < 20000; draw++)
+    {
+      assert(vectorBlocks.nextArrival() == scalarBlocks.nextArrival());
+      int priority = vectorBlocks.nextPriority();
+      assert(priority == scalarBlocks.nextPriority());
+      assert(priority >= blockMinValues[range] && priority <= blockMaxValues[range]);
+      assert(vectorBlocks.nextServiceTime() == scalarBlocks.nextServiceTime());
+      assert(vectorBlocks.nextUniform() == scalarBlocks.nextUniform());
+    }
+  }
+
+  cout << "<RandomBlockGenerator> values cover their ranges evenly, arrivals match the rate" << endl;
+  RandomBlockGenerator blocks;
+  blocks.seed(23);
+  blocks.setArrivalProbability(0.25);
+  blocks.setPriorityRange(1, 10);
+  // a range of 3 * 2^30 rejects a quarter of the candidates
+  blocks.setServiceTimeRange(-1610612736, 1610612735);
+  int blockCounts[10] = {0};
+  int numArrivals = 0;
+  double uniformTotal = 0.0;
+  for (int draw = 0; draw < 100000; draw++)
+  {
+    blockCounts[blocks.nextPriority() - 1]++;
+    int serviceTime = blocks.nextServiceTime();
+    assert(serviceTime >= -1610612736 && serviceTime <= 1610612735);
+    numArrivals += blocks.nextArrival();
+    double uniform = blocks.nextUniform();
+    assert(uniform > 0.0 && uniform <= 1.0);
+    uniformTotal += uniform;
+  }
+  for (int value = 0; value < 10; value++)
+  {
+    assert(blockCounts[value] > 9500 && blockCounts[value] < 10500);
+  }
+  assert(numArrivals > 24500 && numArrivals < 25500);
+  assert(uniformTotal / 100000 > 0.49 && uniformTotal / 100000 < 0.51);
+
+  cout << "<RandomBlockGenerator> arrivalSteps() skips to the same arrivals as nextArrival()" << endl;
+  RandomBlockGenerator stepBlocks, skipBlocks;
+  stepBlocks.seed(24);
+  skipBlocks.seed(24);
+  stepBlocks.setArrivalProbability(0.01);
+  skipBlocks.setArrivalProbability(0.01);
+  long long time = 0;
+  while (time < 100000)
+  {
+    long long steps = skipBlocks.arrivalSteps(100000 - time);
+    for (long long step = 1; step < steps && time + step <= 100000; step++)
+    {
+      assert(!stepBlocks.nextArrival());
+    }
+    if (time + steps <= 100000)
+    {
+      assert(stepBlocks.nextArrival());
+    }
+    time += steps;
+  }
+  assert(time == 100001);
+
+  cout << endl;
+
+
+
   cout << "----------- testing jobSchedulerSimulator() --------------------"
        << endl << endl;
- // JobSchedulerSimulator sim;
-	//srand(time(0));  // seed random number generator using current time
-  //LQueue<Job> jobQueue();
- // int seed = 32;
-  //srand(seed);
-   runSimulation(10000, 0.1, 1, 10, 5, 15, "Normal (non-prioirity based) Queueing discipline");
- 
- //srand(seed);
-//  //PriorityQueue<Job> jobPriorityQueue;
-	runSimulation(10000, 0.1, 1, 10, 5, 15, "Priority Queueing discipline");
-//  cout << sim;
-  
-  
+  JobSchedulerSimulator sim;
+  int seed = 32;
+
+  sim.setSeed(seed);
+  LQueue<Job> jobQueue;
+  sim.runSimulation(jobQueue, "Normal (non-prioirity based) Queueing discipline");
+  cout << sim;
+
+  sim.setSeed(seed);
+  HeapPriorityQueue<Job> jobPriorityQueue;
+  sim.runSimulation(jobPriorityQueue, "Priority Queueing discipline");
+  cout << sim;
+  string heapResults = sim.csvResultString();
+
+  // the sorted list priority queue must dispatch in exactly the same order
+  sim.setSeed(seed);
+  PriorityQueue<Job> listPriorityQueue;
+  sim.runSimulation(listPriorityQueue, "Priority Queueing discipline (list)");
+  assert(sim.csvResultString() == heapResults);
+
+  // running through the abstract Queue<Job> (virtual calls) gives the
+  // same results as the statically dispatched concrete queue
+  sim.setSeed(seed);
+  Queue<Job>& abstractQueue = jobPriorityQueue;
+  sim.runSimulation(abstractQueue, "Priority Queueing discipline (virtual)");
+  assert(sim.csvResultString() == heapResults);
+
+
+  cout << "<jobSchedulerSimulator> priority class statistics add up to the totals" << endl;
+  sim.setSeed(seed);
+  sim.runSimulation(jobPriorityQueue, "Priority Queueing discipline");
+  long long classCompleted = 0, classUnfinished = 0;
+  double classWaitSum = 0.0;
+  for (int priority = 1; priority <= 10; priority++)
+  {
+    const PriorityClassStatistics& priorityClass = sim.getPriorityClassStatistics(priority);
+    classCompleted += priorityClass.waitTime.length();
+    classUnfinished += priorityClass.numWaiting;
+    classWaitSum += priorityClass.waitTime.getMean() * priorityClass.waitTime.length();
+  }
+  assert(classCompleted == sim.getNumJobsCompleted());
+  assert(classUnfinished == sim.getNumJobsStarted() - sim.getNumJobsCompleted());
+  assert(fabs(classWaitSum / classCompleted - sim.getAverageWaitTime()) < 1e-6);
+  // priority dispatching trades low priority waits for high priority ones
+  assert(sim.getPriorityClassStatistics(10).waitTime.getMean()
+	 < sim.getPriorityClassStatistics(1).waitTime.getMean());
+
+  cout << "<jobSchedulerSimulator> csv header names every csv column" << endl;
+  string csvHeader = sim.csvHeaderString();
+  string csvRow = sim.csvResultString();
+  assert(count(csvHeader.begin(), csvHeader.end(), ',') == count(csvRow.begin(), csvRow.end(), ','));
+  assert(csvHeader.find(",class9Preempted\n") != string::npos);
+
+  cout << "<jobSchedulerSimulator> discipline orders" << endl;
+  HeapPriorityQueue<Job, ShortestJobFirstOrder> sjfQueue;
+  HeapPriorityQueue<Job, CostRateOrder> costRateQueue;
+  // (id, priority, serviceTime, startTime)
+  Job orderJobs[] = { Job(1, 2, 10, 0), Job(2, 9, 12, 0), Job(3, 1, 3, 0), Job(4, 5, 10, 0) };
+  for (int index = 0; index < 4; index++)
+  {
+    sjfQueue.enqueue(orderJobs[index]);
+    costRateQueue.enqueue(orderJobs[index]);
+  }
+  int sjfOrder[] = { 3, 1, 4, 2 };
+  // rates 0.2, 0.75, 0.33, 0.5
+  int costRateOrder[] = { 2, 4, 3, 1 };
+  for (int index = 0; index < 4; index++)
+  {
+    assert(sjfQueue.front().getId() == sjfOrder[index]);
+    assert(costRateQueue.front().getId() == costRateOrder[index]);
+    sjfQueue.dequeue();
+    costRateQueue.dequeue();
+  }
+
+  cout << "<jobSchedulerSimulator> run time discipline selection" << endl;
+  sim.setSeed(seed);
+  // priorities 1 to 10 run on a bucket priority queue, with the results
+  // of the heap
+  assert(useBucketQueue(sim));
+  runDisciplineSimulation(sim, PRIORITY_DISCIPLINE);
+  assert(sim.csvResultString().substr(sim.csvResultString().find(',')) ==
+	 heapResults.substr(heapResults.find(',')));
+  double disciplineWait[numSchedulingDisciplines];
+  double disciplineCost[numSchedulingDisciplines];
+  for (int index = 0; index < numSchedulingDisciplines; index++)
+  {
+    SchedulingDiscipline discipline = static_cast<SchedulingDiscipline>(index);
+    assert(parseDiscipline(disciplineName(discipline)) == discipline);
+    sim.setSeed(seed);
+    runDisciplineSimulation(sim, discipline, true);
+    disciplineWait[index] = sim.getAverageWaitTime();
+    disciplineCost[index] = sim.getAverageCost();
+    cout << "   " << setw(10) << disciplineName(discipline)
+	 << " average wait " << setw(8) << disciplineWait[index]
+	 << " average cost " << setw(8) << disciplineCost[index] << endl;
+  }
+  // shortest job first minimizes the wait, the cost rate rule the cost
+  assert(disciplineWait[SHORTEST_JOB_FIRST_DISCIPLINE] < disciplineWait[FIFO_DISCIPLINE]);
+  assert(disciplineWait[SHORTEST_REMAINING_TIME_DISCIPLINE]
+	 == disciplineWait[SHORTEST_JOB_FIRST_DISCIPLINE]);
+  // preempting by the queue's order makes shortest remaining time real
+  // SRPT, which has shorter waits than preempting by service time
+  sim.setPreemptive(true);
+  sim.setSeed(seed);
+  runDisciplineSimulation(sim, SHORTEST_JOB_FIRST_DISCIPLINE, true);
+  double preemptiveSjfWait = sim.getAverageWaitTime();
+  sim.setSeed(seed);
+  runDisciplineSimulation(sim, SHORTEST_REMAINING_TIME_DISCIPLINE, true);
+  double preemptiveSrptWait = sim.getAverageWaitTime();
+  assert(sim.getNumPreemptions() > 0);
+  sim.setPreemptive(false);
+  cout << "   preemptive SJF average wait " << preemptiveSjfWait
+       << ", preemptive SRPT average wait " << preemptiveSrptWait << endl;
+  assert(preemptiveSrptWait < preemptiveSjfWait);
+  assert(preemptiveSrptWait < disciplineWait[SHORTEST_REMAINING_TIME_DISCIPLINE]);
+  assert(disciplineCost[COST_RATE_DISCIPLINE] < disciplineCost[PRIORITY_DISCIPLINE]);
+  assert(disciplineCost[COST_RATE_DISCIPLINE] < disciplineCost[FIFO_DISCIPLINE]);
+  bool unknownRejected = false;
+  try
+  {
+    parseDiscipline("lifo");
+  }
+  catch (DisciplineException& exception)
+  {
+    unknownRejected = true;
+  }
+  assert(unknownRejected);
+
+  cout << "<jobSchedulerSimulator> aging queue orders by time shifted priority" << endl;
+  double agingRates[] = { 0.0, 1.0, 10.0 };
+  int agingOrders[][3] = { { 2, 3, 1 }, { 2, 3, 1 }, { 1, 3, 2 } };
+  for (int rate = 0; rate < 3; rate++)
+  {
+    AgingPriorityQueue agingQueue(agingRates[rate]);
+    // (id, priority, serviceTime, startTime), with rate 1 jobs 2 and 3
+    // have the same effective priority, so job 2 goes first by id
+    agingQueue.emplace(1, 1, 5, 0);
+    agingQueue.emplace(2, 5, 5, 3);
+    agingQueue.emplace(3, 3, 5, 1);
+    for (int index = 0; index < 3; index++)
+    {
+      assert(agingQueue.front().getId() == agingOrders[rate][index]);
+      agingQueue.dequeue();
+    }
+  }
+
+  cout << "<jobSchedulerSimulator> aging trades cost for starvation" << endl;
+  sim.setSeed(seed);
+  runDisciplineSimulation(sim, AGING_DISCIPLINE, false, 0.0);
+  assert(sim.csvResultString() == heapResults);
+  sim.setSeed(seed);
+  runDisciplineSimulation(sim, FIFO_DISCIPLINE);
+  string fifoResults = sim.csvResultString();
+  sim.setSeed(seed);
+  runDisciplineSimulation(sim, AGING_DISCIPLINE, false, 10.0);
+  assert(sim.csvResultString() == fifoResults);
+
+  double tradeOffRates[] = { 0.0, 0.01, 0.05, 0.2, 1.0 };
+  double lowWait[5], highWait[5];
+  cout << "   rate  average cost  priority 1 wait (mean, sd)  priority 10 wait" << endl;
+  for (int rate = 0; rate < 5; rate++)
+  {
+    sim.setSeed(seed);
+    runDisciplineSimulation(sim, AGING_DISCIPLINE, false, tradeOffRates[rate]);
+    lowWait[rate] = sim.getPriorityClassStatistics(1).waitTime.getMean();
+    highWait[rate] = sim.getPriorityClassStatistics(10).waitTime.getMean();
+    cout << setprecision(2) << fixed
+	 << setw(7) << tradeOffRates[rate]
+	 << setw(14) << sim.getAverageCost()
+	 << setw(11) << lowWait[rate]
+	 << setw(8) << sim.getPriorityClassStatistics(1).waitTime.standardDeviation()
+	 << setw(19) << highWait[rate] << endl;
+  }
+  cout.unsetf(ios::floatfield);
+  cout << setprecision(6);
+  assert(lowWait[2] < lowWait[0] && lowWait[4] < lowWait[2]);
+  assert(highWait[3] > highWait[0] && highWait[4] > highWait[3]);
+
+  cout << "<jobSchedulerSimulator> preemptive-resume dispatching" << endl;
+  string preemptFileName = "assg-11-preempt.csv";
+  {
+    ofstream arrivals(preemptFileName.c_str());
+    arrivals << "1,1,10\n3,9,4\n";
+  }
+  {
+    ArrivalTrace preemptTrace(preemptFileName);
+    JobSchedulerSimulator preemptSim(100, 0.1, 1, 10, 5, 15);
+    HeapPriorityQueue<Job> preemptQueue;
+    // the priority 9 job waits for the priority 1 job to finish at 11
+    preemptSim.runTraceReplay(preemptQueue, preemptTrace, "non-preemptive");
+    assert(preemptSim.getAverageWaitTime() == 4.0);
+    // the priority 9 job runs at once, the priority 1 job is back on
+    // the queue from 3 to 7
+    preemptSim.setPreemptive(true);
+    preemptSim.runTraceReplay(preemptQueue, preemptTrace, "preemptive");
+    assert(preemptSim.getNumJobsCompleted() == 2);
+    assert(preemptSim.getNumPreemptions() == 1);
+    assert(preemptSim.getPriorityClassStatistics(1).numPreempted == 1);
+    assert(preemptSim.getPriorityClassStatistics(9).waitTime.getMean() == 0.0);
+    assert(preemptSim.getPriorityClassStatistics(1).waitTime.getMean() == 4.0);
+    assert(preemptSim.getServerBusyTime(0) == 14);
+
+    // a FIFO queue never preempts, its jobs are dispatched by arrival
+    LQueue<Job> preemptFifoQueue;
+    preemptSim.runTraceReplay(preemptFifoQueue, preemptTrace, "preemptive FCFS");
+    assert(preemptSim.getNumPreemptions() == 0);
+    assert(preemptSim.getAverageWaitTime() == 4.0);
+
+    // shortest remaining time preempts for the shorter job, shortest job
+    // first too, but a job that has nearly finished is not preempted
+    // by shortest remaining time for a job that is shorter in all
+    ofstream arrivals(preemptFileName.c_str());
+    arrivals << "1,5,10\n8,5,4\n";
+  }
+  {
+    ArrivalTrace preemptTrace(preemptFileName);
+    JobSchedulerSimulator preemptSim(100, 0.1, 1, 10, 5, 15);
+    preemptSim.setPreemptive(true);
+    DisciplineQueue<SHORTEST_REMAINING_TIME_DISCIPLINE>::type srptQueue;
+    preemptSim.runTraceReplay(srptQueue, preemptTrace, "preemptive SRPT");
+    assert(preemptSim.getNumPreemptions() == 0);
+    assert(preemptSim.getAverageWaitTime() == 1.5);
+    DisciplineQueue<SHORTEST_JOB_FIRST_DISCIPLINE>::type sjfPreemptQueue;
+    preemptSim.runTraceReplay(sjfPreemptQueue, preemptTrace, "preemptive SJF");
+    assert(preemptSim.getNumPreemptions() == 1);
+    assert(preemptSim.getAverageWaitTime() == 2.0);
+
+    // queues whose order is only known at run time can not preempt
+    AgingPriorityQueue agingPreemptQueue(0.1);
+    bool agingRejected = false;
+    try
+    {
+      preemptSim.runTraceReplay(agingPreemptQueue, preemptTrace, "preemptive aging");
+    }
+    catch (PreemptionException& exception)
+    {
+      agingRejected = true;
+    }
+    assert(agingRejected);
+  }
+  remove(preemptFileName.c_str());
+
+  // with a single priority there is nothing to preempt, and the
+  // preemptive loop simulates exactly what the event driven loop does
+  JobSchedulerSimulator flatSim(20000, 0.1, 5, 5, 5, 15, 2);
+  flatSim.setSeed(seed);
+  flatSim.runSimulation(jobPriorityQueue, "flat", true);
+  string flatResults = flatSim.csvResultString();
+  flatSim.setPreemptive(true);
+  flatSim.setSeed(seed);
+  flatSim.runSimulation(jobPriorityQueue, "flat");
+  assert(flatSim.getNumPreemptions() == 0);
+  assert(flatSim.csvResultString() == flatResults);
+
+  cout << "<jobSchedulerSimulator> index queues of a job table give the same results" << endl;
+  LQueue<Job> fifoDisciplineQueue;
+  AQueue<Job> arrayDisciplineQueue;
+  HeapPriorityQueue<Job> priorityDisciplineQueue;
+  BucketPriorityQueue<Job> bucketDisciplineQueue(1, 10);
+  HeapPriorityQueue<Job, ShortestJobFirstOrder> sjfDisciplineQueue;
+  HeapPriorityQueue<Job, ShortestRemainingTimeOrder> srptDisciplineQueue;
+  HeapPriorityQueue<Job, CostRateOrder> costRateDisciplineQueue;
+  AgingPriorityQueue agingDisciplineQueue(0.1);
+  for (int eventDriven = 0; eventDriven < 2; eventDriven++)
+  {
+    assert(sameResultsAsObjects(sim, fifoDisciplineQueue, seed, eventDriven));
+    assert(sameResultsAsObjects(sim, arrayDisciplineQueue, seed, eventDriven));
+    assert(sameResultsAsObjects(sim, priorityDisciplineQueue, seed, eventDriven));
+    assert(sameResultsAsObjects(sim, bucketDisciplineQueue, seed, eventDriven));
+    assert(sameResultsAsObjects(sim, sjfDisciplineQueue, seed, eventDriven));
+    assert(sameResultsAsObjects(sim, srptDisciplineQueue, seed, eventDriven));
+    assert(sameResultsAsObjects(sim, costRateDisciplineQueue, seed, eventDriven));
+    assert(sameResultsAsObjects(sim, agingDisciplineQueue, seed, eventDriven));
+  }
+  for (int index = 0; index < numSchedulingDisciplines; index++)
+  {
+    // the table only holds the jobs still waiting, in rows reused as
+    // jobs are dispatched, and they are handed back to the queue
+    sim.setSeed(seed);
+    runDisciplineSimulation(sim, static_cast<SchedulingDiscipline>(index), true);
+    assert(sim.getJobTable().size() == sim.getNumJobsStarted() - sim.getNumJobsCompleted());
+    assert(sim.getJobTable().numRows() < sim.getNumJobsStarted() / 4);
+  }
+  sim.setSeed(seed);
+  sim.runSimulation(priorityDisciplineQueue, "discipline");
+  assert(priorityDisciplineQueue.length() == sim.getNumJobsStarted() - sim.getNumJobsCompleted());
+
+  cout << "<jobSchedulerSimulator> preemptive index queues give the same results" << endl;
+  sim.setPreemptive(true);
+  assert(samePreemptiveResultsAsObjects<ComesBeforeOrder<Job> >(sim, seed));
+  assert(samePreemptiveResultsAsObjects<ShortestJobFirstOrder>(sim, seed));
+  assert(samePreemptiveResultsAsObjects<ShortestRemainingTimeOrder>(sim, seed));
+  assert(samePreemptiveResultsAsObjects<CostRateOrder>(sim, seed));
+  sim.setSeed(seed);
+  runDisciplineSimulation(sim, FIFO_DISCIPLINE);
+  assert(sim.getNumPreemptions() == 0);
+  bool agingTableRejected = false;
+  try
+  {
+    runDisciplineSimulation(sim, AGING_DISCIPLINE);
+  }
+  catch (PreemptionException& exception)
+  {
+    agingTableRejected = true;
+  }
+  assert(agingTableRejected);
+  sim.setPreemptive(false);
+
+  cout << "<jobSchedulerSimulator> preemption shortens high priority waits" << endl;
+  for (int numServers = 1; numServers <= 4; numServers *= 4)
+  {
+    JobSchedulerSimulator classSim(100000, 0.095 * numServers, 1, 10, 5, 15, numServers);
+    classSim.setSeed(seed);
+    classSim.runSimulation(jobPriorityQueue, "non-preemptive", true);
+    double nonPreemptiveHigh = classSim.getPriorityClassStatistics(10).waitTime.getMean();
+    double nonPreemptiveLow = classSim.getPriorityClassStatistics(1).waitTime.getMean();
+    classSim.setPreemptive(true);
+    classSim.setSeed(seed);
+    classSim.runSimulation(jobPriorityQueue, "preemptive");
+    double preemptiveHigh = classSim.getPriorityClassStatistics(10).waitTime.getMean();
+    double preemptiveLow = classSim.getPriorityClassStatistics(1).waitTime.getMean();
+    cout << "   " << numServers << " servers, " << classSim.getNumPreemptions()
+	 << " preemptions, priority 10 wait " << nonPreemptiveHigh << " -> " << preemptiveHigh
+	 << ", priority 1 wait " << nonPreemptiveLow << " -> " << preemptiveLow << endl;
+    assert(classSim.getNumPreemptions() > 0);
+    assert(preemptiveHigh < nonPreemptiveHigh);
+
+    long long classCompleted = 0, classUnfinished = 0, classPreempted = 0;
+    for (int priority = 1; priority <= 10; priority++)
+    {
+      const PriorityClassStatistics& priorityClass = classSim.getPriorityClassStatistics(priority);
+      classCompleted += priorityClass.waitTime.length();
+      classUnfinished += priorityClass.numWaiting;
+      classPreempted += priorityClass.numPreempted;
+    }
+    assert(classCompleted == classSim.getNumJobsCompleted());
+    assert(classUnfinished == classSim.getNumJobsStarted() - classSim.getNumJobsCompleted());
+    assert(classPreempted == classSim.getNumPreemptions());
+    assert(classSim.getAverageUtilization() <= 1.0);
+  }
+
+  cout << "<jobSchedulerSimulator> event driven mode matches stepped mode statistics" << endl;
+  // average a number of runs of each mode, the two modes use the random
+  // numbers differently so only the distributions can be compared
+  JobSchedulerSimulator lightSim(100000, 0.05, 1, 10, 5, 15);
+  const int numRuns = 20;
+  double steppedStarted = 0.0, eventStarted = 0.0;
+  double steppedWait = 0.0, eventWait = 0.0;
+  lightSim.setSeed(seed);
+  for (int run = 0; run < numRuns; run++)
+  {
+    lightSim.runSimulation(jobPriorityQueue, "stepped", false);
+    steppedStarted += lightSim.getNumJobsStarted();
+    steppedWait += lightSim.getAverageWaitTime();
+
+    lightSim.runSimulation(jobPriorityQueue, "event driven", true);
+    eventStarted += lightSim.getNumJobsStarted();
+    eventWait += lightSim.getAverageWaitTime();
+  }
+  cout << "   stepped: started " << steppedStarted / numRuns
+       << " average wait " << steppedWait / numRuns << endl
+       << "   event  : started " << eventStarted / numRuns
+       << " average wait " << eventWait / numRuns << endl << endl;
+  assert(fabs(steppedStarted - eventStarted) / steppedStarted < 0.02);
+  assert(fabs(steppedWait - eventWait) / steppedWait < 0.10);
+
+  cout << "<jobSchedulerSimulator> more servers share the load of one overloaded server" << endl;
+  JobSchedulerSimulator oneServerSim(20000, 0.3, 1, 10, 5, 15, 1);
+  JobSchedulerSimulator fourServerSim(20000, 0.3, 1, 10, 5, 15, 4);
+  oneServerSim.setSeed(seed);
+  oneServerSim.runSimulation(jobPriorityQueue, "1 server");
+  fourServerSim.setSeed(seed);
+  fourServerSim.runSimulation(jobPriorityQueue, "4 servers");
+  cout << "   1 server : utilization " << oneServerSim.getAverageUtilization()
+       << " average wait " << oneServerSim.getAverageWaitTime() << endl
+       << "   4 servers: utilization " << fourServerSim.getAverageUtilization()
+       << " average wait " << fourServerSim.getAverageWaitTime() << endl;
+  assert(fourServerSim.getNumServers() == 4);
+  assert(oneServerSim.getAverageUtilization() > 0.99);
+  assert(fourServerSim.getAverageUtilization() < 0.9);
+  assert(fourServerSim.getAverageWaitTime() < oneServerSim.getAverageWaitTime());
+  assert(fourServerSim.getNumJobsCompleted() > oneServerSim.getNumJobsCompleted());
+  for (int server = 0; server < 4; server++)
+  {
+    assert(fourServerSim.getServerUtilization(server) > 0.5);
+    assert(fourServerSim.getServerUtilization(server) <= 1.0);
+  }
+
+  cout << "<jobSchedulerSimulator> 1024 servers never make a job wait" << endl;
+  JobSchedulerSimulator manyServerSim(200000, 0.9, 1, 10, 5, 15, 1024);
+  for (int mode = 0; mode < 2; mode++)
+  {
+    manyServerSim.setSeed(seed);
+    manyServerSim.runSimulation(jobPriorityQueue, "1024 servers", mode == 1);
+    long long totalBusyTime = 0;
+    for (int server = 0; server < 1024; server++)
+    {
+      totalBusyTime += manyServerSim.getServerBusyTime(server);
+    }
+    assert(manyServerSim.getNumJobsCompleted() == manyServerSim.getNumJobsStarted());
+    assert(manyServerSim.getAverageWaitTime() == 0.0);
+    // about 0.59 jobs arrive per step (1 - e^-0.9), each busy for 10 steps
+    // on average, so about 5.9 of the 1024 servers are busy on average
+    assert(fabs(totalBusyTime / 200000.0 - 5.93) < 0.1);
+    assert(fabs(manyServerSim.getAverageUtilization() - totalBusyTime / (200000.0 * 1024)) < 1e-12);
+  }
+
+  cout << "<jobSchedulerSimulator> per job trace matches the aggregate results" << endl;
+  JobSchedulerSimulator traceSim(50000, 0.1, 1, 10, 5, 15);
+  string traceFileName = "assg-11-trace.bin";
+  {
+    JobTraceWriter traceWriter(traceFileName, 1000);
+    traceSim.setTraceWriter(&traceWriter);
+    traceSim.setSeed(seed);
+    traceSim.runSimulation(jobPriorityQueue, "traced", true);
+    traceSim.setTraceWriter(NULL);
+    assert(traceWriter.length() == traceSim.getNumJobsCompleted());
+    traceWriter.close();
+  }
+  {
+    JobTraceReader trace(traceFileName);
+    assert(trace.length() == traceSim.getNumJobsCompleted());
+    assert(trace.numBlocks() == (trace.length() + 999) / 1000);
+    long long traceWait = 0;
+    long long traceCost = 0;
+    long long traceMaxWait = 0;
+    for (int block = 0; block < trace.numBlocks(); block++)
+    {
+      const int64_t* costs = trace.costs(block);
+      const int32_t* priorities = trace.priorities(block);
+      const int32_t* startTimes = trace.startTimes(block);
+      const int32_t* endTimes = trace.endTimes(block);
+      for (int job = 0; job < trace.blockLength(block); job++)
+      {
+	assert(costs[job] == (long long)priorities[job] * (endTimes[job] - startTimes[job]));
+	traceWait += endTimes[job] - startTimes[job];
+	traceMaxWait = max(traceMaxWait, (long long)(endTimes[job] - startTimes[job]));
+	traceCost += costs[job];
+      }
+    }
+    cout << "   " << trace.length() << " jobs in " << trace.numBlocks() << " blocks" << endl;
+    assert(fabs(double(traceWait) / trace.length() - traceSim.getAverageWaitTime()) < 1e-3);
+    assert(fabs(double(traceCost) / trace.length() - traceSim.getAverageCost()) < 1e-3);
+    assert(traceSim.getWaitTimeHistogram().count() == trace.length());
+    assert(traceSim.getWaitTimeHistogram().max() == traceMaxWait);
+    assert(trace.ids(0)[0] >= 1);
+    assert(trace.serviceTimes(0)[0] >= 5 && trace.serviceTimes(0)[0] <= 15);
+  }
+
+  cout << "<jobSchedulerSimulator> job ids of a run do not depend on other jobs or runs" << endl;
+  {
+    JobTraceReader firstTrace(traceFileName);
+    vector<int32_t> firstIds(firstTrace.ids(0), firstTrace.ids(0) + firstTrace.blockLength(0));
+    Job otherJob(1, 1, 0);
+    assert(otherJob.getId() > 0);
+    JobSchedulerSimulator copiedSim(traceSim);
+    {
+      JobTraceWriter traceWriter(traceFileName, 1000);
+      copiedSim.setTraceWriter(&traceWriter);
+      copiedSim.setSeed(seed);
+      copiedSim.runSimulation(jobPriorityQueue, "traced", true);
+      copiedSim.setTraceWriter(NULL);
+    }
+    JobTraceReader secondTrace(traceFileName);
+    assert(equal(firstIds.begin(), firstIds.end(), secondTrace.ids(0)));
+  }
+  remove(traceFileName.c_str());
+
+  cout << "<jobSchedulerSimulator> resume a run from a checkpoint" << endl;
+  string snapshotFileName = "assg-11-snapshot.bin";
+  for (int eventDriven = 0; eventDriven <= 1; eventDriven++)
+  {
+    JobSchedulerSimulator wholeSim(20000, 0.2, 1, 10, 5, 15, 2);
+    wholeSim.setSeed(seed);
+    wholeSim.runSimulation(jobPriorityQueue, "whole", eventDriven);
+    assert(wholeSim.getCheckpointTime() == 0);
+
+    // the run that writes checkpoints has the same results
+    JobSchedulerSimulator checkpointSim(20000, 0.2, 1, 10, 5, 15, 2);
+    checkpointSim.setSeed(seed);
+    checkpointSim.setCheckpoint(snapshotFileName, 3000);
+    checkpointSim.runSimulation(jobPriorityQueue, "whole", eventDriven);
+    assert(checkpointSim.getCheckpointTime() == 18000);
+    assert(checkpointSim.csvResultString() == wholeSim.csvResultString());
+
+    // a run stopped at its first checkpoint, and resumed by another
+    // simulator, has the same results as the whole run
+    JobSchedulerSimulator stoppedSim(20000, 0.2, 1, 10, 5, 15, 2);
+    stoppedSim.setSeed(seed);
+    stoppedSim.setCheckpoint(snapshotFileName, 7000, true);
+    stoppedSim.runSimulation(jobPriorityQueue, "whole", eventDriven);
+    assert(stoppedSim.getCheckpointTime() == 7000);
+    assert(stoppedSim.getNumJobsStarted() < wholeSim.getNumJobsStarted());
+    JobSchedulerSimulator resumedSim(20000, 0.2, 1, 10, 5, 15, 2);
+    HeapPriorityQueue<Job> resumedQueue;
+    resumedSim.resumeSimulation(resumedQueue, snapshotFileName, "whole");
+    assert(resumedSim.getCheckpointTime() == 7000);
+    assert(resumedSim.csvResultString() == wholeSim.csvResultString());
+    assert(resumedSim.getWaitTimeHistogram().percentile(99.0) ==
+	   wholeSim.getWaitTimeHistogram().percentile(99.0));
+  }
+
+  cout << "<jobSchedulerSimulator> resume a run of a job table from a checkpoint" << endl;
+  {
+    JobSchedulerSimulator wholeSim(20000, 0.2, 1, 10, 5, 15);
+    HeapPriorityQueue<JobIndex, JobTableOrder<> > wholeQueue(4, JobTableOrder<>(&wholeSim.getJobTable()));
+    wholeSim.setSeed(seed);
+    wholeSim.runSimulation(wholeQueue, "table");
+    JobSchedulerSimulator stoppedSim(20000, 0.2, 1, 10, 5, 15);
+    HeapPriorityQueue<JobIndex, JobTableOrder<> > stoppedQueue(4, JobTableOrder<>(&stoppedSim.getJobTable()));
+    stoppedSim.setSeed(seed);
+    stoppedSim.setCheckpoint(snapshotFileName, 5000, true);
+    stoppedSim.runSimulation(stoppedQueue, "table");
+    JobSchedulerSimulator resumedSim(20000, 0.2, 1, 10, 5, 15);
+    HeapPriorityQueue<JobIndex, JobTableOrder<> > resumedQueue(4, JobTableOrder<>(&resumedSim.getJobTable()));
+    resumedSim.resumeSimulation(resumedQueue, snapshotFileName, "table");
+    assert(resumedSim.csvResultString() == wholeSim.csvResultString());
+    assert(resumedSim.getJobTable().size() == wholeSim.getJobTable().size());
+
+    // the checkpoint holds the waiting jobs as Jobs, so it carries on
+    // with a queue of Job as well
+    JobSchedulerSimulator objectSim(20000, 0.2, 1, 10, 5, 15);
+    objectSim.resumeSimulation(jobPriorityQueue, snapshotFileName, "table");
+    assert(objectSim.csvResultString() == wholeSim.csvResultString());
+
+    // a trace of the resumed run has the jobs after the checkpoint
+    JobTraceWriter traceWriter(traceFileName, 1000);
+    resumedSim.setTraceWriter(&traceWriter);
+    resumedSim.resumeSimulation(resumedQueue, snapshotFileName, "table");
+    resumedSim.setTraceWriter(NULL);
+    assert(traceWriter.length() == resumedSim.getNumJobsCompleted() - stoppedSim.getNumJobsCompleted());
+    traceWriter.close();
+  }
+
+  cout << "<jobSchedulerSimulator> fork what-if runs from a warmed up checkpoint" << endl;
+  {
+    JobSchedulerSimulator warmSim(20000, 0.2, 1, 10, 5, 15, 2);
+    warmSim.setSeed(seed);
+    warmSim.setCheckpoint(snapshotFileName, 5000, true);
+    warmSim.runSimulation(jobPriorityQueue, "warm up", true);
+
+    JobSchedulerSimulator forkSim(20000, 0.2, 1, 10, 5, 15, 2);
+    forkSim.forkSimulation(jobPriorityQueue, snapshotFileName, "fork", 1);
+    string firstFork = forkSim.csvResultString();
+    forkSim.forkSimulation(jobPriorityQueue, snapshotFileName, "fork", 2);
+    string secondFork = forkSim.csvResultString();
+    assert(firstFork != secondFork);
+    assert(forkSim.getNumJobsStarted() > warmSim.getNumJobsStarted());
+    forkSim.forkSimulation(jobPriorityQueue, snapshotFileName, "fork", 1);
+    assert(forkSim.csvResultString() == firstFork);
+
+    // the same warmed up state, with another discipline or more arrivals
+    LQueue<Job> forkFifoQueue;
+    forkSim.forkSimulation(forkFifoQueue, snapshotFileName, "fork FCFS", 1);
+    assert(forkSim.getNumJobsCompleted() > warmSim.getNumJobsCompleted());
+    JobSchedulerSimulator busierSim(20000, 0.3, 1, 10, 5, 15, 2);
+    busierSim.forkSimulation(jobPriorityQueue, snapshotFileName, "fork busier", 1);
+    assert(busierSim.getNumJobsStarted() > forkSim.getNumJobsStarted());
+
+    // a checkpoint only resumes into the same system
+    JobSchedulerSimulator otherSim(20000, 0.2, 1, 10, 5, 15, 3);
+    try
+    {
+      otherSim.forkSimulation(jobPriorityQueue, snapshotFileName, "fork", 1);
+      assert(false);
+    }
+    catch (SnapshotException& exception)
+    {
+      cout << "   " << exception.what() << endl;
+    }
+  }
+
+  cout << "<jobSchedulerSimulator> checkpoints are checked" << endl;
+  {
+    JobSchedulerSimulator preemptSim(20000, 0.2, 1, 10, 5, 15);
+    preemptSim.setPreemptive(true);
+    preemptSim.setCheckpoint(snapshotFileName, 5000);
+    try
+    {
+      preemptSim.runSimulation(jobPriorityQueue, "preemptive", true);
+      assert(false);
+    }
+    catch (SnapshotException& exception)
+    {
+      cout << "   " << exception.what() << endl;
+    }
+
+    // a truncated checkpoint is never half resumed
+    string snapshot;
+    {
+      ifstream in(snapshotFileName.c_str(), ios::binary);
+      snapshot.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    {
+      ofstream out(snapshotFileName.c_str(), ios::binary | ios::trunc);
+      out.write(snapshot.data(), snapshot.size() - 10);
+    }
+    JobSchedulerSimulator truncatedSim(20000, 0.2, 1, 10, 5, 15, 2);
+    try
+    {
+      truncatedSim.resumeSimulation(jobPriorityQueue, snapshotFileName, "truncated");
+      assert(false);
+    }
+    catch (SnapshotException& exception)
+    {
+      cout << "   " << exception.what() << endl;
+    }
+  }
+  remove(snapshotFileName.c_str());
+
+  cout << "<jobSchedulerSimulator> replay a csv arrival trace" << endl;
+  string arrivalFileName = "assg-11-arrivals.csv";
+  {
+    ofstream arrivals(arrivalFileName.c_str());
+    arrivals << "time,priority,serviceTime\r\n"
+	     << "1,5,10\r\n"
+	     << "2,1,3\r\n"
+	     << "\r\n"
+	     << "3, 9, 4\r\n";
+  }
+  ArrivalTrace csvTrace(arrivalFileName);
+  JobSchedulerSimulator replaySim(100, 0.1, 1, 10, 5, 15);
+  LQueue<Job> replayFifoQueue;
+  // first come first served: waits 0, 11 - 2 and 14 - 3
+  replaySim.runTraceReplay(replayFifoQueue, csvTrace, "replay FCFS");
+  assert(csvTrace.length() == 3);
+  assert(replaySim.getNumJobsCompleted() == 3);
+  assert(fabs(replaySim.getAverageWaitTime() - 20.0 / 3.0) < 1e-9);
+  // priority: the priority 9 job goes before the priority 1 job, waits
+  // 0, 15 - 2 and 11 - 3
+  replaySim.runTraceReplay(jobPriorityQueue, csvTrace, "replay priority");
+  assert(replaySim.getNumJobsCompleted() == 3);
+  assert(fabs(replaySim.getAverageWaitTime() - 21.0 / 3.0) < 1e-9);
+  assert(replaySim.getPriorityClassStatistics(9).waitTime.getMean() == 8.0);
+
+  cout << "<jobSchedulerSimulator> replay a binary trace of a FCFS run reproduces it" << endl;
+  JobSchedulerSimulator recordedSim(20000, 0.1, 1, 10, 5, 15);
+  {
+    JobTraceWriter traceWriter(traceFileName, 500);
+    recordedSim.setTraceWriter(&traceWriter);
+    recordedSim.setSeed(seed);
+    recordedSim.runSimulation(replayFifoQueue, "recorded FCFS", true);
+    recordedSim.setTraceWriter(NULL);
+  }
+  {
+    ArrivalTrace binaryTrace(traceFileName);
+    replaySim = JobSchedulerSimulator(20000, 0.1, 1, 10, 5, 15);
+    replaySim.runTraceReplay(replayFifoQueue, binaryTrace, "replay FCFS");
+    assert(replaySim.getNumJobsCompleted() == recordedSim.getNumJobsCompleted());
+    assert(replaySim.getAverageWaitTime() == recordedSim.getAverageWaitTime());
+    assert(replaySim.getAverageCost() == recordedSim.getAverageCost());
+  }
+  remove(traceFileName.c_str());
+
+  cout << "<jobSchedulerSimulator> replay rejects arrivals out of time order" << endl;
+  {
+    ofstream arrivals(arrivalFileName.c_str());
+    arrivals << "5,1,3\n4,1,3\n";
+  }
+  ArrivalTrace unorderedTrace(arrivalFileName);
+  bool rejected = false;
+  try
+  {
+    replaySim.runTraceReplay(replayFifoQueue, unorderedTrace, "replay");
+  }
+  catch (JobTraceException& exception)
+  {
+    cout << "   " << exception.what() << endl;
+    rejected = true;
+  }
+  assert(rejected);
+  remove(arrivalFileName.c_str());
+
+  cout << endl;
+
+
+  cout << "----------- testing ReplicationRunner -------------------------"
+       << endl << endl;
+  ReplicationRunner runner(JobSchedulerSimulator(20000, 0.1, 1, 10, 5, 15),
+			   makeHeapPriorityQueue, "Priority Queueing discipline",
+			   true, seed);
+
+  cout << "<ReplicationRunner> results do not depend on the number of threads" << endl;
+  runner.run(40, 1);
+  ReplicationStatistic singleWait = runner.waitTimeStatistic();
+  ReplicationStatistic singleCost = runner.costStatistic();
+  runner.run(40, 4);
+  cout << runner;
+  assert(runner.numReplications() == 40);
+  assert(runner.waitTimeStatistic().mean == singleWait.mean);
+  assert(runner.waitTimeStatistic().halfWidth == singleWait.halfWidth);
+  assert(runner.costStatistic().mean == singleCost.mean);
+  assert(singleWait.lower() < singleWait.mean && singleWait.mean < singleWait.upper());
+  assert(singleWait.halfWidth > 0.0);
+
+  cout << "<ReplicationRunner> replications of a checkpointing simulator are not checkpointed" << endl;
+  string replicationFileName = "assg-11-replication.bin";
+  remove(replicationFileName.c_str());
+  JobSchedulerSimulator checkpointingSim(20000, 0.1, 1, 10, 5, 15);
+  checkpointingSim.setCheckpoint(replicationFileName, 1000);
+  ReplicationRunner checkpointingRunner(checkpointingSim, makeHeapPriorityQueue,
+					"Priority Queueing discipline", true, seed);
+  checkpointingRunner.run(40, 4);
+  assert(checkpointingRunner.waitTimeStatistic().mean == singleWait.mean);
+  assert(checkpointingRunner.costStatistic().mean == singleCost.mean);
+  ifstream replicationFile(replicationFileName.c_str());
+  assert(!replicationFile.good());
+
+  cout << endl;
+
+
+  cout << "----------- testing ParameterSweep ----------------------------"
+       << endl << endl;
+  ParameterSweep sweep(5000, makeHeapPriorityQueue, "Priority Queueing discipline",
+		       true, seed);
+  sweep.setArrivalProbabilities(ParameterSweep::valueRange(0.05, 0.15, 0.05));
+  sweep.setPriorityRanges(ParameterSweep::rangeGrid(1, 2, 1, 4, 9, 5));
+  sweep.setServiceTimeRanges(ParameterSweep::rangeGrid(5, 5, 1, 5, 10, 5));
+
+  cout << "<ParameterSweep> one row per configuration of the grid" << endl;
+  assert(sweep.numConfigurations() == 3 * 4 * 2);
+  ostringstream singleSweep, threadedSweep;
+  sweep.run(singleSweep, 1);
+  sweep.run(threadedSweep, 4);
+  istringstream singleRows(singleSweep.str()), threadedRows(threadedSweep.str());
+  vector<string> singleLines, threadedLines;
+  string line;
+  while (getline(singleRows, line))
+  {
+    singleLines.push_back(line);
+  }
+  while (getline(threadedRows, line))
+  {
+    threadedLines.push_back(line);
+  }
+  cout << "   " << singleLines[1] << endl;
+  assert(singleLines.size() == 1 + 24);
+  assert(singleLines[0] + "\n" == sweep.csvHeaderString());
+  assert(singleLines[1].substr(0, 16) == "0,0.05,1,5,5,10,");
+
+  for (int index = 0; index < (int)singleLines.size(); index++)
+  {
+    assert(count(singleLines[index].begin(), singleLines[index].end(), ',')
+	   == count(singleLines[0].begin(), singleLines[0].end(), ','));
+  }
+
+  cout << "<ParameterSweep> rows do not depend on the number of threads" << endl;
+  sort(singleLines.begin(), singleLines.end());
+  sort(threadedLines.begin(), threadedLines.end());
+  assert(singleLines == threadedLines);
+
+  cout << "<ParameterSweep> rows match a single simulation of the configuration" << endl;
+  JobSchedulerSimulator sweepSim(5000, 0.15, 2, 11, 5, 15);
+  HeapPriorityQueue<Job> sweepQueue;
+  sweepSim.setSeed(ReplicationRunner::replicationSeed(seed, 23));
+  sweepSim.runSimulation(sweepQueue, "Priority Queueing discipline", true);
+  string lastRow = threadedSweep.str();
+  assert(lastRow.find("\n23,0.15,2,11,5,15," + sweepSim.csvResultString()) != string::npos);
+
+  cout << endl;
+
+
   // return 0 to indicate successful completion
   return 0;
 }
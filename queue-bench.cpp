@@ -0,0 +1,1554 @@
+/**
+ * @description Microbenchmarks of the Queue implementations.  Measures
+ *   the time per operation, the number of memory allocations and the
+ *   peak memory use of each queue operation, for a range of queue sizes
+ *   and workloads, and writes the results as JSON.
+ *
+ * Build and run (results go to standard output unless --output is given):
+ *
+ *   g++ -std=c++11 -O2 -pthread -o queue-bench queue-bench.cpp
+ *   ./queue-bench --max-size 1000000 --output results.json
+ *
+ * Options:
+ *   --min-size N           smallest queue size (default 100)
+ *   --max-size N           largest queue size (default 10000000), sizes
+ *                          are the powers of 10 from min to max size
+ *   --queue NAME           only benchmark the named queue
+ *   --workload NAME        only run the named workload
+ *   --quadratic-budget N   skip cases where an operation that is O(n) per
+ *                          item would take more than N steps in total
+ *                          (default 2e8)
+ *   --seed N               seed of the random workloads (default 32)
+ *   --suite NAME           the benchmarks to run: queue (default), the
+ *                          single threaded queues, concurrent, the
+ *                          ConcurrentAQueue against a LockedAQueue at 1 to
+ *                          --max-threads threads, bursty, bursts of
+ *                          min to max size items through a queue that
+ *                          then drains, events, a TimingWheel against a
+ *                          binary heap with min to max size events
+ *                          outstanding, layout, jobs as Job objects
+ *                          against JobTable indexes, with min to max
+ *                          size jobs waiting, and whole simulations of
+ *                          --transfers time steps, random, random
+ *                          numbers drawn per call against in blocks, or
+ *                          all
+ *   --max-threads N        most threads of the concurrent suite (default 64)
+ *   --transfers N          items passed through the queue per concurrent
+ *                          or bursty case, events per events case, jobs
+ *                          per layout case, or draws per random case
+ *                          (default 2000000)
+ *   --output FILE          write the JSON results to FILE
+ */
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <malloc.h>
+#include <new>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "Queue.hpp"
+#include "ConcurrentQueue.hpp"
+#include "JobSimulator.hpp"
+#include "JobTable.hpp"
+#include "MemoryStats.hpp"
+#include "RandomGenerator.hpp"
+#include "SchedulingDiscipline.hpp"
+#include "TimingWheel.hpp"
+using namespace std;
+
+
+
+//-------------------------------------------------------------------------
+// allocation counting.  The global operator new and delete are replaced
+// so that every allocation of the program is counted.  The live and peak
+// number of heap bytes are tracked with the usable size of each block,
+// from glibc malloc_usable_size().
+
+/** AllocationCounters
+ * @var allocations The number of calls to operator new.
+ * @var bytesAllocated The total number of bytes asked for.
+ * @var liveBytes The number of bytes currently allocated.
+ * @var peakLiveBytes The largest value of liveBytes since the last reset.
+ */
+struct AllocationCounters
+{
+  long long allocations;
+  long long bytesAllocated;
+  long long liveBytes;
+  long long peakLiveBytes;
+};
+
+static AllocationCounters counters = {0, 0, 0, 0};
+
+
+/** operator new
+ * Allocate a block, and count the allocation.
+ */
+void* operator new(size_t size)
+{
+  void* memory = malloc(size);
+  if (memory == NULL)
+  {
+    throw bad_alloc();
+  }
+  counters.allocations++;
+  counters.bytesAllocated += size;
+  counters.liveBytes += malloc_usable_size(memory);
+  if (counters.liveBytes > counters.peakLiveBytes)
+  {
+    counters.peakLiveBytes = counters.liveBytes;
+  }
+  return memory;
+}
+
+
+/** operator delete
+ * Free a block allocated by operator new.
+ */
+void operator delete(void* memory) noexcept
+{
+  if (memory == NULL)
+  {
+    return;
+  }
+  counters.liveBytes -= malloc_usable_size(memory);
+  free(memory);
+}
+
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+
+void operator delete[](void* memory) noexcept
+{
+  operator delete(memory);
+}
+
+
+
+//-------------------------------------------------------------------------
+/** BenchmarkResult
+ * The measurements of one operation of one benchmark case.
+ *
+ * @var suite The benchmark suite, e.g. "queue".
+ * @var queue The name of the queue implementation measured.
+ * @var workload The name of the workload (order of items enqueued).
+ * @var size The number of items on the queue (or passed through the
+ *   queue, for the concurrent suite).
+ * @var threads The number of threads using the queue.
+ * @var operation The name of the operation measured.
+ * @var ops The number of operations timed.
+ * @var nsPerOp The average time of one operation in nanoseconds.
+ * @var allocations The number of allocations made by the operations.
+ * @var bytesAllocated The number of bytes allocated by the operations.
+ * @var peakHeapBytes The peak bytes allocated during the whole case.
+ * @var peakRssBytes The peak RSS of the process so far.
+ * @var retainedBytes The heap bytes still held by the queue once it is
+ *   empty again (bursty suite).
+ * @var cacheMissesPerOp The hardware cache misses per operation, or -1
+ *   if they were not measured (layout suite), see CacheMissCounter.
+ * @var skipped True if the case was too slow to run (see
+ *   --quadratic-budget), and so was not measured.
+ */
+struct BenchmarkResult
+{
+  string suite;
+  string queue;
+  string workload;
+  long long size;
+  int threads;
+  string operation;
+  long long ops;
+  double nsPerOp;
+  long long allocations;
+  long long bytesAllocated;
+  long long peakHeapBytes;
+  long long peakRssBytes;
+  long long retainedBytes;
+  double cacheMissesPerOp;
+  bool skipped;
+};
+
+
+/** BenchmarkOptions
+ * The command line options of the benchmark, see the file comment.
+ */
+struct BenchmarkOptions
+{
+  long long minSize;
+  long long maxSize;
+  string queue;
+  string workload;
+  double quadraticBudget;
+  unsigned long long seed;
+  string output;
+  string suite;
+  int maxThreads;
+  long long transfers;
+};
+
+
+/** Stopwatch
+ * Times a set of operations, and counts the allocations they make.
+ */
+class Stopwatch
+{
+private:
+  chrono::steady_clock::time_point startTime;
+  long long startAllocations;
+  long long startBytes;
+
+public:
+  /** start
+   * Start timing, and counting allocations, from now.
+   */
+  void start()
+  {
+    startAllocations = counters.allocations;
+    startBytes = counters.bytesAllocated;
+    startTime = chrono::steady_clock::now();
+  }
+
+  /** stop
+   * Stop timing, and fill in the time and allocations of the result.
+   *
+   * @param result The result to fill in, its ops must already be set.
+   */
+  void stop(BenchmarkResult& result)
+  {
+    chrono::steady_clock::time_point stopTime = chrono::steady_clock::now();
+    double ns = chrono::duration<double, nano>(stopTime - startTime).count();
+    result.nsPerOp = (result.ops > 0) ? ns / result.ops : 0.0;
+    result.allocations = counters.allocations - startAllocations;
+    result.bytesAllocated = counters.bytesAllocated - startBytes;
+  }
+};
+
+
+// a sink for values read in timed loops, so they are not optimized away
+static volatile long long benchmarkSink;
+
+
+/** make workload
+ * Make the items to enqueue for the named workload.
+ *   fifo       - every item has the same value (priority)
+ *   random     - uniformly random values
+ *   ascending  - increasing values, each new item has the highest
+ *                priority so far
+ *   descending - decreasing values, each new item has the lowest
+ *                priority so far
+ *   levels     - random values 1 to 10, the default priorities of a
+ *                simulation
+ *
+ * @param workload The name of the workload.
+ * @param size The number of items.
+ * @param seed Seed for the random workload.
+ *
+ * @returns vector<int> The items in the order they are enqueued.
+ */
+vector<int> makeWorkload(const string& workload, long long size,
+			 unsigned long long seed)
+{
+  vector<int> items(size);
+  Xoshiro256 engine(seed);
+  for (long long index = 0; index < size; index++)
+  {
+    if (workload == "fifo")
+    {
+      items[index] = 0;
+    }
+    else if (workload == "random")
+    {
+      items[index] = boundedInteger(engine, 1000000);
+    }
+    else if (workload == "ascending")
+    {
+      items[index] = index;
+    }
+    else if (workload == "levels")
+    {
+      items[index] = 1 + boundedInteger(engine, 10);
+    }
+    else
+    {
+      items[index] = size - index;
+    }
+  }
+  return items;
+}
+
+
+/** new result
+ * Start a result record for an operation of a benchmark case.
+ */
+BenchmarkResult newResult(const string& queue, const string& workload,
+			  long long size, const string& operation, long long ops)
+{
+  BenchmarkResult result;
+  result.suite = "queue";
+  result.queue = queue;
+  result.workload = workload;
+  result.size = size;
+  result.threads = 1;
+  result.operation = operation;
+  result.ops = ops;
+  result.nsPerOp = 0.0;
+  result.allocations = 0;
+  result.bytesAllocated = 0;
+  result.peakHeapBytes = 0;
+  result.peakRssBytes = 0;
+  result.retainedBytes = 0;
+  result.cacheMissesPerOp = -1.0;
+  result.skipped = false;
+  return result;
+}
+
+
+/** benchmark queue
+ * Run one benchmark case: fill a queue of the given type with the items,
+ * then time front(), operator[], operator== and finally dequeue() of all
+ * of the items.
+ *
+ * Operations are called on the concrete queue type, the way the
+ * simulator calls them, rather than through Queue<int> virtual calls.
+ * Some operations are O(n) per item for some queues (e.g. enqueue() on
+ * the sorted list PriorityQueue, operator[] on linked lists), these
+ * are skipped or sampled when they would exceed the quadratic budget.
+ *
+ * @param name The name of the queue implementation.
+ * @param workload The name of the workload.
+ * @param items The items to enqueue.
+ * @param linearEnqueue False if enqueue() of this workload is O(n)
+ *   per item for this queue.
+ * @param linearIndex False if operator[] is O(n) per item for this queue.
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+template <class QueueType>
+void benchmarkQueue(const string& name, const string& workload,
+		    const vector<int>& items, bool linearEnqueue, bool linearIndex,
+		    const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  long long size = items.size();
+  double quadraticSteps = double(size) * double(size) / 2.0;
+  size_t firstResult = results.size();
+  Stopwatch stopwatch;
+
+  if (!linearEnqueue && quadraticSteps > options.quadraticBudget)
+  {
+    const char* operations[] = {"enqueue", "front", "index", "equal", "dequeue"};
+    for (int operation = 0; operation < 5; operation++)
+    {
+      results.push_back(newResult(name, workload, size, operations[operation], 0));
+      results.back().skipped = true;
+    }
+    return;
+  }
+
+  counters.peakLiveBytes = counters.liveBytes;
+  {
+    QueueType queue;
+
+    // enqueue
+    BenchmarkResult enqueue = newResult(name, workload, size, "enqueue", size);
+    stopwatch.start();
+    for (long long index = 0; index < size; index++)
+    {
+      queue.enqueue(items[index]);
+    }
+    stopwatch.stop(enqueue);
+    results.push_back(enqueue);
+
+    // front
+    BenchmarkResult front = newResult(name, workload, size, "front", size);
+    long long sum = 0;
+    stopwatch.start();
+    for (long long index = 0; index < size; index++)
+    {
+      sum += queue.front();
+    }
+    stopwatch.stop(front);
+    benchmarkSink = sum;
+    results.push_back(front);
+
+    // operator[] at random indexes, fewer of them if each access is O(n)
+    long long numIndexes = size;
+    if (linearIndex && quadraticSteps > options.quadraticBudget)
+    {
+      numIndexes = (long long)(options.quadraticBudget / size);
+      if (numIndexes < 1)
+      {
+	numIndexes = 1;
+      }
+    }
+    Xoshiro256 engine(options.seed);
+    vector<int> indexes(numIndexes);
+    for (long long index = 0; index < numIndexes; index++)
+    {
+      indexes[index] = boundedInteger(engine, size);
+    }
+    BenchmarkResult indexing = newResult(name, workload, size, "index", numIndexes);
+    sum = 0;
+    stopwatch.start();
+    for (long long index = 0; index < numIndexes; index++)
+    {
+      sum += queue[indexes[index]];
+    }
+    stopwatch.stop(indexing);
+    benchmarkSink = sum;
+    results.push_back(indexing);
+
+    // operator== against an equal queue, the worst case of a full scan
+    BenchmarkResult equal = newResult(name, workload, size, "equal", size);
+    if (linearIndex && quadraticSteps > options.quadraticBudget)
+    {
+      equal.ops = 0;
+      equal.skipped = true;
+    }
+    else
+    {
+      QueueType other;
+      for (long long index = 0; index < size; index++)
+      {
+	other.enqueue(items[index]);
+      }
+      stopwatch.start();
+      bool same = (queue == other);
+      stopwatch.stop(equal);
+      assert(same);
+    }
+    results.push_back(equal);
+
+    // dequeue
+    BenchmarkResult dequeue = newResult(name, workload, size, "dequeue", size);
+    stopwatch.start();
+    for (long long index = 0; index < size; index++)
+    {
+      queue.dequeue();
+    }
+    stopwatch.stop(dequeue);
+    results.push_back(dequeue);
+  }
+
+  // the peaks apply to the case as a whole
+  for (size_t index = firstResult; index < results.size(); index++)
+  {
+    results[index].peakHeapBytes = counters.peakLiveBytes;
+    results[index].peakRssBytes = peakResidentBytes();
+  }
+}
+
+
+/** run queue suite
+ * Benchmark every queue implementation on every workload, for each
+ * power of 10 size in the range of the options.
+ *
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void runQueueSuite(const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  const char* workloads[] = {"fifo", "random", "ascending", "descending", "levels"};
+
+  for (long long size = options.minSize; size <= options.maxSize; size *= 10)
+  {
+    for (int workloadIndex = 0; workloadIndex < 5; workloadIndex++)
+    {
+      string workload = workloads[workloadIndex];
+      if (!options.workload.empty() && options.workload != workload)
+      {
+	continue;
+      }
+      vector<int> items = makeWorkload(workload, size, options.seed);
+      cerr << "queue suite: size " << size << ", " << workload << " workload" << endl;
+
+      // the sorted list PriorityQueue inserts in O(1) only when each new
+      // item has the highest priority so far
+      bool sortedListLinear = (workload == "ascending");
+
+      if (options.queue.empty() || options.queue == "AQueue")
+      {
+	benchmarkQueue<AQueue<int> >("AQueue", workload, items, true, false,
+				     options, results);
+      }
+      if (options.queue.empty() || options.queue == "LQueue")
+      {
+	benchmarkQueue<LQueue<int> >("LQueue", workload, items, true, true,
+				     options, results);
+      }
+      if (options.queue.empty() || options.queue == "PriorityQueue")
+      {
+	benchmarkQueue<PriorityQueue<int> >("PriorityQueue", workload, items,
+					    sortedListLinear, true,
+					    options, results);
+      }
+      if (options.queue.empty() || options.queue == "HeapPriorityQueue")
+      {
+	benchmarkQueue<HeapPriorityQueue<int> >("HeapPriorityQueue", workload, items,
+						true, false, options, results);
+      }
+      // the bucket queue only holds the priorities 1 to 10
+      if ((options.queue.empty() || options.queue == "BucketPriorityQueue")
+	  && workload == "levels")
+      {
+	benchmarkQueue<BucketPriorityQueue<int> >("BucketPriorityQueue", workload, items,
+						  true, false, options, results);
+      }
+    }
+  }
+}
+
+
+/** benchmark concurrent queue
+ * Run one concurrent benchmark case: the producer threads together
+ * enqueue options.transfers items, while the consumer threads dequeue
+ * them, each thread retrying (after yielding) when the queue is full or
+ * empty.  The time is the wall clock time for all of the items to pass
+ * through the queue, so nsPerOp is the time per item of the whole
+ * system, not of one thread.
+ *
+ * @param name The name of the queue implementation.
+ * @param numProducers The number of producer threads.
+ * @param numConsumers The number of consumer threads.
+ * @param batchSize The number of items each operation enqueues or
+ *   dequeues, 1 to use tryEnqueue() and tryDequeue().
+ * @param options The benchmark options.
+ * @param results The result is appended to this list.
+ */
+template <class ConcurrentQueueType>
+void benchmarkConcurrentQueue(const string& name, int numProducers,
+			      int numConsumers, int batchSize,
+			      const BenchmarkOptions& options,
+			      vector<BenchmarkResult>& results)
+{
+  ostringstream workload;
+  workload << numProducers << "-producer-" << numConsumers << "-consumer";
+  ostringstream operation;
+  operation << "transfer-batch" << batchSize;
+  BenchmarkResult result = newResult(name, workload.str(), options.transfers,
+				     operation.str(), options.transfers);
+  result.suite = "concurrent";
+  result.threads = numProducers + numConsumers;
+
+  ConcurrentQueueType queue(1024);
+  long long itemsPerProducer = options.transfers / numProducers;
+  long long numItems = itemsPerProducer * numProducers;
+  atomic<long long> numConsumed(0);
+  atomic<long long> consumedSum(0);
+  vector<thread> threads;
+  Stopwatch stopwatch;
+
+  stopwatch.start();
+  for (int producer = 0; producer < numProducers; producer++)
+  {
+    threads.push_back(thread([&queue, itemsPerProducer, batchSize]() {
+	  vector<int> batch(batchSize);
+	  long long item = 0;
+	  while (item < itemsPerProducer)
+	  {
+	    int count = batchSize;
+	    if (item + count > itemsPerProducer)
+	    {
+	      count = itemsPerProducer - item;
+	    }
+	    for (int index = 0; index < count; index++)
+	    {
+	      batch[index] = item + index;
+	    }
+	    int numAdded = (batchSize == 1)
+	      ? (queue.tryEnqueue(batch[0]) ? 1 : 0)
+	      : queue.tryEnqueueBatch(&batch[0], count);
+	    if (numAdded == 0)
+	    {
+	      this_thread::yield();
+	    }
+	    item += numAdded;
+	    // a partial batch leaves the rest of the items to go again
+	  }
+	}));
+  }
+  for (int consumer = 0; consumer < numConsumers; consumer++)
+  {
+    threads.push_back(thread([&queue, &numConsumed, &consumedSum, numItems, batchSize]() {
+	  vector<int> batch(batchSize);
+	  long long sum = 0;
+	  while (numConsumed.load(memory_order_relaxed) < numItems)
+	  {
+	    int numRemoved = (batchSize == 1)
+	      ? (queue.tryDequeue(batch[0]) ? 1 : 0)
+	      : queue.tryDequeueBatch(&batch[0], batchSize);
+	    if (numRemoved == 0)
+	    {
+	      this_thread::yield();
+	      continue;
+	    }
+	    for (int index = 0; index < numRemoved; index++)
+	    {
+	      sum += batch[index];
+	    }
+	    numConsumed += numRemoved;
+	  }
+	  consumedSum += sum;
+	}));
+  }
+  for (int index = 0; index < (int)threads.size(); index++)
+  {
+    threads[index].join();
+  }
+  result.ops = numItems;
+  stopwatch.stop(result);
+
+  // every item must have come through the queue exactly once
+  assert(numConsumed.load() == numItems);
+  assert(consumedSum.load() == numProducers * (itemsPerProducer * (itemsPerProducer - 1) / 2));
+
+  result.peakRssBytes = peakResidentBytes();
+  results.push_back(result);
+}
+
+
+/** run concurrent suite
+ * Benchmark the lock free ConcurrentAQueue against the mutex protected
+ * LockedAQueue, for 1, 2, 4, ... up to options.maxThreads threads.  Two
+ * workloads are run for each number of threads n: one producer (like a
+ * single arrival generator) feeding n consumers (dispatchers), and n/2
+ * producers feeding n/2 consumers.  Each is run one item at a time and
+ * in batches of 32 items.
+ *
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void runConcurrentSuite(const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  const int batchSizes[] = {1, 32};
+
+  for (int threads = 1; threads <= options.maxThreads; threads *= 2)
+  {
+    cerr << "concurrent suite: " << threads << " threads" << endl;
+    for (int batch = 0; batch < 2; batch++)
+    {
+      int batchSize = batchSizes[batch];
+      if (options.queue.empty() || options.queue == "ConcurrentAQueue")
+      {
+	benchmarkConcurrentQueue<ConcurrentAQueue<int> >("ConcurrentAQueue", 1, threads,
+							 batchSize, options, results);
+	if (threads >= 2)
+	{
+	  benchmarkConcurrentQueue<ConcurrentAQueue<int> >("ConcurrentAQueue", threads / 2,
+							   threads / 2, batchSize,
+							   options, results);
+	}
+      }
+      if (options.queue.empty() || options.queue == "LockedAQueue")
+      {
+	benchmarkConcurrentQueue<LockedAQueue<int> >("LockedAQueue", 1, threads,
+						     batchSize, options, results);
+	if (threads >= 2)
+	{
+	  benchmarkConcurrentQueue<LockedAQueue<int> >("LockedAQueue", threads / 2,
+						       threads / 2, batchSize,
+						       options, results);
+	}
+      }
+    }
+  }
+}
+
+
+// the most items moved per call in the bursty suite
+const int maxSpanSize = 64;
+
+
+/** enqueue span
+ * Add a run of items to a queue, one at a time.  AQueue adds the run in
+ * one call instead.
+ *
+ * @param queue The queue to add to.
+ * @param items The items to add.
+ * @param count The number of items.
+ */
+template <class QueueType>
+void enqueueSpan(QueueType& queue, const int* items, int count)
+{
+  for (int index = 0; index < count; index++)
+  {
+    queue.enqueue(items[index]);
+  }
+}
+
+void enqueueSpan(AQueue<int>& queue, const int* items, int count)
+{
+  if (count == 1)
+  {
+    queue.enqueue(items[0]);
+  }
+  else
+  {
+    queue.enqueueRange(items, count);
+  }
+}
+
+
+/** dequeue span
+ * Remove up to count items from the front of a queue, one at a time.
+ * AQueue removes them in one call instead.
+ *
+ * @param queue The queue to remove from.
+ * @param items Room for the items removed, only AQueue uses it.
+ * @param count The most items to remove.
+ *
+ * @returns long long The sum of the items removed, to be checked.
+ */
+template <class QueueType>
+long long dequeueSpan(QueueType& queue, int* /* items */, int count)
+{
+  long long sum = 0;
+  for (int index = 0; index < count && !queue.isEmpty(); index++)
+  {
+    sum += queue.front();
+    queue.dequeue();
+  }
+  return sum;
+}
+
+long long dequeueSpan(AQueue<int>& queue, int* items, int count)
+{
+  if (count == 1)
+  {
+    long long item = queue.front();
+    queue.dequeue();
+    return item;
+  }
+  int numRemoved = queue.dequeueRange(items, count);
+  long long sum = 0;
+  for (int index = 0; index < numRemoved; index++)
+  {
+    sum += items[index];
+  }
+  return sum;
+}
+
+
+/** benchmark bursts
+ * Run one bursty case: bursts of burstSize items are enqueued and then
+ * all dequeued again, until options.transfers items have passed through
+ * the queue.  With a spanSize of 1 items go on and off one at a time,
+ * otherwise (AQueue only) in runs of spanSize items with enqueueRange()
+ * and dequeueRange().  The time is per item passed through the queue,
+ * and the retained bytes show whether the queue gives back the memory
+ * of a burst once it has drained.
+ *
+ * @param name The name of the queue implementation.
+ * @param burstSize The number of items in each burst.
+ * @param spanSize The number of items moved per call, 1 for enqueue()
+ *   and dequeue(), at most maxSpanSize.
+ * @param options The benchmark options.
+ * @param results The result is appended to this list.
+ */
+template <class QueueType>
+void benchmarkBursts(const string& name, long long burstSize, int spanSize,
+		     const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  long long rounds = options.transfers / burstSize;
+  if (rounds < 1)
+  {
+    rounds = 1;
+  }
+  ostringstream operation;
+  if (spanSize == 1)
+  {
+    operation << "burst-item";
+  }
+  else
+  {
+    operation << "burst-range-" << spanSize;
+  }
+  BenchmarkResult result = newResult(name, "bursty", burstSize, operation.str(),
+				     rounds * burstSize);
+  result.suite = "bursty";
+  Stopwatch stopwatch;
+
+  int span[maxSpanSize];
+  for (int index = 0; index < spanSize; index++)
+  {
+    span[index] = index;
+  }
+
+  counters.peakLiveBytes = counters.liveBytes;
+  {
+    long long emptyBytes = counters.liveBytes;
+    QueueType queue;
+    long long sum = 0;
+    stopwatch.start();
+    for (long long round = 0; round < rounds; round++)
+    {
+      for (long long count = 0; count < burstSize; count += spanSize)
+      {
+	enqueueSpan(queue, span, spanSize);
+      }
+      while (!queue.isEmpty())
+      {
+	sum += dequeueSpan(queue, span, spanSize);
+      }
+    }
+    stopwatch.stop(result);
+    benchmarkSink = sum;
+    result.retainedBytes = counters.liveBytes - emptyBytes;
+  }
+  result.peakHeapBytes = counters.peakLiveBytes;
+  result.peakRssBytes = peakResidentBytes();
+  results.push_back(result);
+}
+
+
+/** run bursty suite
+ * Benchmark queues that fill up with a burst of items and then drain,
+ * for each power of 10 burst size in the range of the options: the
+ * AQueue one item at a time and in runs of 64 items, and the LQueue one
+ * item at a time.
+ *
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void runBurstySuite(const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  for (long long size = options.minSize; size <= options.maxSize; size *= 10)
+  {
+    cerr << "bursty suite: bursts of " << size << endl;
+    if (options.queue.empty() || options.queue == "AQueue")
+    {
+      benchmarkBursts<AQueue<int> >("AQueue", size, 1, options, results);
+      benchmarkBursts<AQueue<int> >("AQueue", size, 64, options, results);
+    }
+    if (options.queue.empty() || options.queue == "LQueue")
+    {
+      benchmarkBursts<LQueue<int> >("LQueue", size, 1, options, results);
+    }
+  }
+}
+
+
+// the longest delay events are scheduled with in the events suite, like
+// the largest service time of a simulation
+const int maxEventDelay = 1000;
+
+
+/** EventHeap
+ * The binary heap the events suite measures the TimingWheel against, a
+ * min heap of (time, item) events with the same interface as the wheel,
+ * which is how the simulator's server pool kept its completions before.
+ */
+class EventHeap
+{
+private:
+  typedef pair<long long, int> Event;
+  priority_queue<Event, vector<Event>, greater<Event> > events;
+
+public:
+  // a heap has no horizon, the parameter matches the wheel's constructor
+  EventHeap(int /* horizon */) {}
+  long long nextTime() const { return events.top().first; }
+  void schedule(long long time, int item) { events.push(Event(time, item)); }
+
+  int popNext()
+  {
+    int item = events.top().second;
+    events.pop();
+    return item;
+  }
+};
+
+
+/** benchmark events
+ * Run one events case, the hold model of a discrete event simulation:
+ * with a fixed number of events outstanding, repeatedly take the
+ * earliest event off and schedule a new one a random delay of 1 to
+ * maxEventDelay steps after it, options.transfers times.  The time is
+ * per event, one popNext() and one schedule().
+ *
+ * @param name The name of the event queue implementation.
+ * @param outstanding The number of events pending at any time.
+ * @param options The benchmark options.
+ * @param results The result is appended to this list.
+ */
+template <class EventQueue>
+void benchmarkEvents(const string& name, long long outstanding,
+		     const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  BenchmarkResult result = newResult(name, "hold", outstanding, "pop-schedule",
+				     options.transfers);
+  result.suite = "events";
+  Stopwatch stopwatch;
+
+  // the delays are drawn up front, so the timed loop is the event queue
+  const int numDelays = 4096;
+  vector<int> delays(numDelays);
+  Xoshiro256 engine(options.seed);
+  for (int index = 0; index < numDelays; index++)
+  {
+    delays[index] = 1 + boundedInteger(engine, maxEventDelay);
+  }
+
+  counters.peakLiveBytes = counters.liveBytes;
+  {
+    EventQueue events(maxEventDelay);
+    for (long long event = 0; event < outstanding; event++)
+    {
+      events.schedule(delays[event % numDelays], event);
+    }
+
+    long long sum = 0;
+    stopwatch.start();
+    for (long long event = 0; event < options.transfers; event++)
+    {
+      long long now = events.nextTime();
+      int item = events.popNext();
+      sum += item;
+      events.schedule(now + delays[event & (numDelays - 1)], item);
+    }
+    stopwatch.stop(result);
+    benchmarkSink = sum;
+  }
+  result.peakHeapBytes = counters.peakLiveBytes;
+  result.peakRssBytes = peakResidentBytes();
+  results.push_back(result);
+}
+
+
+/** run events suite
+ * Benchmark the TimingWheel against a binary heap as the pending event
+ * set of a simulation, for each power of 10 number of outstanding events
+ * in the range of the options.
+ *
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void runEventsSuite(const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  for (long long size = options.minSize; size <= options.maxSize; size *= 10)
+  {
+    cerr << "events suite: " << size << " events outstanding" << endl;
+    if (options.queue.empty() || options.queue == "TimingWheel")
+    {
+      benchmarkEvents<TimingWheel<int> >("TimingWheel", size, options, results);
+    }
+    if (options.queue.empty() || options.queue == "EventHeap")
+    {
+      benchmarkEvents<EventHeap>("EventHeap", size, options, results);
+    }
+  }
+}
+
+
+//-------------------------------------------------------------------------
+/** CacheMissCounter
+ * Counts the hardware cache misses of this thread with a Linux perf
+ * event.  Where there is no such counter (most virtual machines and
+ * containers, or a perf_event_paranoid setting that does not allow it)
+ * the results are left with cacheMissesPerOp -1.
+ *
+ * @var descriptor The perf event file descriptor, or -1.
+ */
+class CacheMissCounter
+{
+private:
+  int descriptor;
+
+public:
+  CacheMissCounter()
+  {
+    perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    descriptor = syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+  }
+
+  ~CacheMissCounter()
+  {
+    if (descriptor >= 0)
+    {
+      close(descriptor);
+    }
+  }
+
+  /** start
+   * Start counting cache misses from zero.
+   */
+  void start()
+  {
+    if (descriptor >= 0)
+    {
+      ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+      ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  /** stop
+   * Stop counting, and fill in the cache misses of the result.
+   *
+   * @param result The result to fill in, its ops must already be set.
+   */
+  void stop(BenchmarkResult& result)
+  {
+    if (descriptor < 0)
+    {
+      return;
+    }
+    ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+    long long misses = 0;
+    if (read(descriptor, &misses, sizeof(misses)) == sizeof(misses) && result.ops > 0)
+    {
+      result.cacheMissesPerOp = (double)misses / result.ops;
+    }
+  }
+};
+
+
+/** ObjectJobs
+ * The object per job layout of the layout suite: a priority queue of
+ * whole Job objects, whose costs are added up as they are dispatched,
+ * the way the simulator records them.
+ */
+struct ObjectJobs
+{
+  HeapPriorityQueue<Job> jobQueue;
+  long long totalCost;
+  int nextId;
+
+  // the heap grows to the number of jobs waiting as they are added
+  ObjectJobs(long long /* numWaiting */)
+    : totalCost(0), nextId(1)
+  {
+  }
+
+  void add(int priority, int serviceTime, int time)
+  {
+    jobQueue.emplace(nextId++, priority, serviceTime, time);
+  }
+
+  void dispatch(int time)
+  {
+    const Job& job = jobQueue.front();
+    totalCost += (long long)job.getPriority() * (time - job.startTime);
+    jobQueue.dequeue();
+  }
+
+  long long cost() const
+  {
+    return totalCost;
+  }
+};
+
+
+/** IndexJobs
+ * The structure of arrays layout of the layout suite: the waiting jobs
+ * in a JobTable, and a priority queue of their indexes.  A dispatched
+ * job is moved to the table's finished columns, freeing its row for the
+ * next job, and the costs are added up a block of finished jobs at a
+ * time, the way the simulator records them.
+ */
+struct IndexJobs
+{
+  JobTable table;
+  HeapPriorityQueue<JobIndex, JobTableOrder<> > jobQueue;
+  long long totalCost;
+  int nextId;
+
+  IndexJobs(long long numWaiting)
+    : jobQueue(4, JobTableOrder<>(&table)), totalCost(0), nextId(1)
+  {
+    table.reserve(numWaiting);
+  }
+
+  void add(int priority, int serviceTime, int time)
+  {
+    jobQueue.enqueue(table.add(nextId++, priority, serviceTime, time));
+  }
+
+  void dispatch(int time)
+  {
+    JobIndex index = jobQueue.front();
+    jobQueue.dequeue();
+    table.finish(index, time);
+    if (table.numFinished() == JobTable::finishedCapacity)
+    {
+      totalCost += table.finishedTotals().totalCost;
+      table.clearFinished();
+    }
+  }
+
+  long long cost() const
+  {
+    return totalCost + table.finishedTotals().totalCost;
+  }
+};
+
+
+/** ObjectJobQueue
+ * A heap of Job objects that the simulator runs on as it is, rather than
+ * on a heap of job indexes (see JobIndexQueue), for the object layout of
+ * the simulation of the layout suite.  The queue's calls are still made
+ * directly, see QueueDispatch.
+ */
+class ObjectJobQueue : public HeapPriorityQueue<Job>
+{
+};
+
+
+/** benchmark layout
+ * Run one layout case of a priority queue of waiting jobs, the hold
+ * model: with a fixed number of jobs waiting, repeatedly dispatch the
+ * highest priority job, adding up its cost, and add a new one,
+ * options.transfers times.  The times and cache misses are per job.
+ *
+ * @param name The name of the job layout.
+ * @param waiting The number of jobs waiting at any time.
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+template <class Layout>
+void benchmarkLayout(const string& name, long long waiting, const BenchmarkOptions& options,
+		     vector<BenchmarkResult>& results)
+{
+  BenchmarkResult holdResult = newResult(name, "hold", waiting, "dispatch-add",
+					 options.transfers);
+  holdResult.suite = "layout";
+  Stopwatch stopwatch;
+  CacheMissCounter cacheMisses;
+
+  // the jobs are drawn up front, so the timed loop is the job layout
+  const int numJobAttributes = 4096;
+  vector<int> priorities(numJobAttributes), serviceTimes(numJobAttributes);
+  Xoshiro256 engine(options.seed);
+  for (int index = 0; index < numJobAttributes; index++)
+  {
+    priorities[index] = 1 + boundedInteger(engine, 10);
+    serviceTimes[index] = 1 + boundedInteger(engine, 15);
+  }
+
+  counters.peakLiveBytes = counters.liveBytes;
+  {
+    Layout jobs(waiting + 1);
+    for (long long job = 0; job < waiting; job++)
+    {
+      int attributes = job & (numJobAttributes - 1);
+      jobs.add(priorities[attributes], serviceTimes[attributes], 0);
+    }
+
+    stopwatch.start();
+    cacheMisses.start();
+    for (long long job = 0; job < options.transfers; job++)
+    {
+      int attributes = job & (numJobAttributes - 1);
+      int time = job / 16;
+      jobs.dispatch(time);
+      jobs.add(priorities[attributes], serviceTimes[attributes], time);
+    }
+    cacheMisses.stop(holdResult);
+    stopwatch.stop(holdResult);
+    benchmarkSink = jobs.cost();
+  }
+  holdResult.peakHeapBytes = counters.peakLiveBytes;
+  holdResult.peakRssBytes = peakResidentBytes();
+  results.push_back(holdResult);
+}
+
+
+/** benchmark layout simulation
+ * Run a whole simulation of options.transfers time steps, loaded so the
+ * waiting queue grows long, with each job layout.  The time and cache
+ * misses are per job started.
+ *
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void benchmarkLayoutSimulation(const BenchmarkOptions& options,
+			       vector<BenchmarkResult>& results)
+{
+  JobSchedulerSimulator sim(options.transfers, 0.124, 1, 10, 1, 15);
+  for (int layout = 0; layout < 2; layout++)
+  {
+    string name = (layout == 0) ? "ObjectJobs" : "IndexJobs";
+    if (!options.queue.empty() && options.queue != name)
+    {
+      continue;
+    }
+    BenchmarkResult result = newResult(name, "simulation", options.transfers,
+				       "simulate", 0);
+    result.suite = "layout";
+    Stopwatch stopwatch;
+    CacheMissCounter cacheMisses;
+
+    counters.peakLiveBytes = counters.liveBytes;
+    sim.setSeed(options.seed);
+    stopwatch.start();
+    cacheMisses.start();
+    if (layout == 0)
+    {
+      ObjectJobQueue jobQueue;
+      sim.runSimulation(jobQueue, "priority", true);
+    }
+    else
+    {
+      HeapPriorityQueue<Job> jobQueue;
+      sim.runSimulation(jobQueue, "priority", true);
+    }
+    result.ops = sim.getNumJobsStarted();
+    cacheMisses.stop(result);
+    stopwatch.stop(result);
+    result.peakHeapBytes = counters.peakLiveBytes;
+    result.peakRssBytes = peakResidentBytes();
+    results.push_back(result);
+  }
+}
+
+
+/** run layout suite
+ * Benchmark jobs kept as Job objects against jobs kept in a JobTable
+ * with queues of their indexes, for each power of 10 number of waiting
+ * jobs in the range of the options, and for a whole simulation.
+ *
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void runLayoutSuite(const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  for (long long size = options.minSize; size <= options.maxSize; size *= 10)
+  {
+    cerr << "layout suite: " << size << " jobs waiting" << endl;
+    if (options.queue.empty() || options.queue == "ObjectJobs")
+    {
+      benchmarkLayout<ObjectJobs>("ObjectJobs", size, options, results);
+    }
+    if (options.queue.empty() || options.queue == "IndexJobs")
+    {
+      benchmarkLayout<IndexJobs>("IndexJobs", size, options, results);
+    }
+  }
+  cerr << "layout suite: simulation of " << options.transfers << " time steps" << endl;
+  benchmarkLayoutSimulation(options, results);
+}
+
+
+// the arrival probability and ranges of the random suite, those of the
+// simulation of the layout suite
+const double randomArrivalProbability = 0.124;
+const int randomMinPriority = 1;
+const int randomMaxPriority = 10;
+
+
+/** benchmark random calls
+ * The random generation the simulator did before it drew its random
+ * numbers in blocks: a call to the engine per arrival test, and a
+ * bounded integer per priority.
+ *
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void benchmarkRandomCalls(const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  BenchmarkResult arrivalResult = newResult("Xoshiro256", "calls", options.transfers,
+					    "arrival-test", options.transfers);
+  BenchmarkResult priorityResult = newResult("Xoshiro256", "calls", options.transfers,
+					     "priority", options.transfers);
+  arrivalResult.suite = priorityResult.suite = "random";
+  Stopwatch stopwatch;
+  Xoshiro256 engine(options.seed);
+  uint64_t threshold = probabilityThreshold(randomArrivalProbability);
+  int range = randomMaxPriority - randomMinPriority + 1;
+
+  long long sum = 0;
+  stopwatch.start();
+  for (long long step = 0; step < options.transfers; step++)
+  {
+    sum += engine() < threshold;
+  }
+  stopwatch.stop(arrivalResult);
+
+  stopwatch.start();
+  for (long long draw = 0; draw < options.transfers; draw++)
+  {
+    sum += randomMinPriority + boundedInteger(engine, range);
+  }
+  stopwatch.stop(priorityResult);
+  benchmarkSink = sum;
+
+  results.push_back(arrivalResult);
+  results.push_back(priorityResult);
+}
+
+
+/** benchmark random blocks
+ * The block generator of the simulator, with its scalar or its AVX2
+ * kernels: arrival tests one at a time and skipped to the next arrival
+ * (see RandomBlockGenerator::arrivalSteps()), priorities and uniforms.
+ *
+ * @param name The name of the kernels.
+ * @param vectorKernels true to use the AVX2 kernels.
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void benchmarkRandomBlocks(const string& name, bool vectorKernels,
+			   const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  const char* operations[] = { "arrival-test", "arrival-skip", "priority", "uniform" };
+  RandomBlockGenerator blocks;
+  blocks.setVectorKernels(vectorKernels);
+  blocks.seed(options.seed);
+  blocks.setArrivalProbability(randomArrivalProbability);
+  blocks.setPriorityRange(randomMinPriority, randomMaxPriority);
+  Stopwatch stopwatch;
+
+  for (int operation = 0; operation < 4; operation++)
+  {
+    BenchmarkResult result = newResult(name, "blocks", options.transfers,
+				       operations[operation], options.transfers);
+    result.suite = "random";
+    // the sums are integers like those of the engine calls, so a chain
+    // of floating point adds does not limit the integer cases
+    long long sum = 0;
+    double uniformSum = 0.0;
+    stopwatch.start();
+    if (operation == 0)
+    {
+      for (long long step = 0; step < options.transfers; step++)
+      {
+	sum += blocks.nextArrival();
+      }
+    }
+    else if (operation == 1)
+    {
+      for (long long step = 0; step < options.transfers; )
+      {
+	step += blocks.arrivalSteps(options.transfers - step);
+	sum++;
+      }
+    }
+    else if (operation == 2)
+    {
+      for (long long draw = 0; draw < options.transfers; draw++)
+      {
+	sum += blocks.nextPriority();
+      }
+    }
+    else
+    {
+      for (long long draw = 0; draw < options.transfers; draw++)
+      {
+	uniformSum += blocks.nextUniform();
+      }
+    }
+    stopwatch.stop(result);
+    benchmarkSink = sum + (long long)uniformSum;
+    results.push_back(result);
+  }
+}
+
+
+/** run random suite
+ * Benchmark an engine call per random number against the block
+ * generator, with its scalar kernels and, where the processor has AVX2,
+ * its vector kernels.  Each case draws options.transfers arrival tests
+ * or values, the times are per test or value.
+ *
+ * @param options The benchmark options.
+ * @param results The results are appended to this list.
+ */
+void runRandomSuite(const BenchmarkOptions& options, vector<BenchmarkResult>& results)
+{
+  cerr << "random suite: " << options.transfers << " draws" << endl;
+  if (options.queue.empty() || options.queue == "Xoshiro256")
+  {
+    benchmarkRandomCalls(options, results);
+  }
+  if (options.queue.empty() || options.queue == "ScalarBlocks")
+  {
+    benchmarkRandomBlocks("ScalarBlocks", false, options, results);
+  }
+  if (RandomBlockGenerator::hasVectorKernels()
+      && (options.queue.empty() || options.queue == "Avx2Blocks"))
+  {
+    benchmarkRandomBlocks("Avx2Blocks", true, options, results);
+  }
+}
+
+
+/** write json
+ * Write the results as a JSON array of result objects.
+ *
+ * @param out The stream to write to.
+ * @param results The benchmark results.
+ */
+void writeJson(ostream& out, const vector<BenchmarkResult>& results)
+{
+  out << "[" << endl;
+  for (size_t index = 0; index < results.size(); index++)
+  {
+    const BenchmarkResult& result = results[index];
+    out << "  {\"suite\": \"" << result.suite << "\""
+	<< ", \"queue\": \"" << result.queue << "\""
+	<< ", \"workload\": \"" << result.workload << "\""
+	<< ", \"size\": " << result.size
+	<< ", \"threads\": " << result.threads
+	<< ", \"operation\": \"" << result.operation << "\""
+	<< ", \"skipped\": " << (result.skipped ? "true" : "false")
+	<< ", \"ops\": " << result.ops
+	<< ", \"nsPerOp\": " << fixed << setprecision(3) << result.nsPerOp
+	<< ", \"allocations\": " << result.allocations
+	<< ", \"bytesAllocated\": " << result.bytesAllocated
+	<< ", \"peakHeapBytes\": " << result.peakHeapBytes
+	<< ", \"peakRssBytes\": " << result.peakRssBytes
+	<< ", \"retainedBytes\": " << result.retainedBytes
+	<< ", \"cacheMissesPerOp\": " << result.cacheMissesPerOp
+	<< "}" << (index + 1 < results.size() ? "," : "") << endl;
+  }
+  out << "]" << endl;
+}
+
+
+/** parse options
+ * Parse the command line options, see the file comment.
+ *
+ * @returns bool false if the options are not valid.
+ */
+bool parseOptions(int argc, char** argv, BenchmarkOptions& options)
+{
+  options.minSize = 100;
+  options.maxSize = 10000000;
+  options.quadraticBudget = 2e8;
+  options.seed = 32;
+  options.suite = "queue";
+  options.maxThreads = 64;
+  options.transfers = 2000000;
+
+  for (int arg = 1; arg < argc; arg++)
+  {
+    string option = argv[arg];
+    if (arg + 1 >= argc)
+    {
+      cerr << "missing value for option " << option << endl;
+      return false;
+    }
+    string value = argv[++arg];
+
+    if (option == "--min-size")
+    {
+      options.minSize = atof(value.c_str());
+    }
+    else if (option == "--max-size")
+    {
+      options.maxSize = atof(value.c_str());
+    }
+    else if (option == "--queue")
+    {
+      options.queue = value;
+    }
+    else if (option == "--workload")
+    {
+      options.workload = value;
+    }
+    else if (option == "--quadratic-budget")
+    {
+      options.quadraticBudget = atof(value.c_str());
+    }
+    else if (option == "--seed")
+    {
+      options.seed = strtoull(value.c_str(), NULL, 10);
+    }
+    else if (option == "--output")
+    {
+      options.output = value;
+    }
+    else if (option == "--suite")
+    {
+      options.suite = value;
+    }
+    else if (option == "--max-threads")
+    {
+      options.maxThreads = atoi(value.c_str());
+    }
+    else if (option == "--transfers")
+    {
+      options.transfers = atof(value.c_str());
+    }
+    else
+    {
+      cerr << "unknown option " << option << endl;
+      return false;
+    }
+  }
+  return options.minSize >= 1;
+}
+
+
+/** main
+ * Run the benchmarks and write their results.
+ *
+ * @param argc The command line argument count.
+ * @param argv The command line arguments, see the file comment.
+ */
+int main(int argc, char** argv)
+{
+  BenchmarkOptions options;
+  if (!parseOptions(argc, argv, options))
+  {
+    return 1;
+  }
+
+  vector<BenchmarkResult> results;
+  if (options.suite == "queue" || options.suite == "all")
+  {
+    runQueueSuite(options, results);
+  }
+  if (options.suite == "concurrent" || options.suite == "all")
+  {
+    runConcurrentSuite(options, results);
+  }
+  if (options.suite == "bursty" || options.suite == "all")
+  {
+    runBurstySuite(options, results);
+  }
+  if (options.suite == "events" || options.suite == "all")
+  {
+    runEventsSuite(options, results);
+  }
+  if (options.suite == "layout" || options.suite == "all")
+  {
+    runLayoutSuite(options, results);
+  }
+  if (options.suite == "random" || options.suite == "all")
+  {
+    runRandomSuite(options, results);
+  }
+
+  if (options.output.empty())
+  {
+    writeJson(cout, results);
+  }
+  else
+  {
+    ofstream out(options.output.c_str());
+    writeJson(out, results);
+  }
+
+  return 0;
+}